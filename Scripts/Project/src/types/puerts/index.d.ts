@@ -36,6 +36,18 @@ declare module "puerts" {
         remove(name: string, value: any);
     }
     
+    const frame : {
+        getDeadline(): number;
+        timeRemaining(): number;
+        shouldYield(): boolean;
+        scheduleContinuation(callback: (deadline: number) => void): number;
+        cancelContinuation(id: number): void;
+        getStats(reset?: boolean): {
+            frames: number; lastMs: number; maxMs: number; budgetMs: number;
+            boundsMs: number[]; histogram: number[]; pendingContinuations: number;
+        };
+    }
+    
     function merge(des: {}, src: {}): void;
     
     //function requestJitModuleMethod(moduleName: string, methodName: string, callback: (err: Error, result: any)=> void, ... args: any[]): void;
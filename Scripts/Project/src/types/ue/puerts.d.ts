@@ -31,6 +31,9 @@ declare module "ue" {
         Get(Index: number): T;
         GetRef(Index: number): T;
         Set(Index: number, Value: T): void;
+        ToTypedArray(): T extends bigint ? BigInt64Array | BigUint64Array : Float32Array | Float64Array | Int8Array | Uint8Array | Int16Array | Uint16Array | Int32Array | Uint32Array;
+        SetFromTypedArray(Source: ArrayLike<T> | ArrayBufferView): void;
+        CopyTo(Target: ArrayBufferView, StartIndex?: number): number;
     }
     
     interface TArray<T> {
@@ -45,6 +48,11 @@ declare module "ue" {
         RemoveAt(Index: number): void;
         IsValidIndex(Index: number): boolean;
         Empty(): void;
+        FromJsArray(Source: T[]): void;
+        ToJsArray(): T[];
+        ToTypedArray(): T extends bigint ? BigInt64Array | BigUint64Array : Float32Array | Float64Array | Int8Array | Uint8Array | Int16Array | Uint16Array | Int32Array | Uint32Array;
+        SetFromTypedArray(Source: ArrayLike<T> | ArrayBufferView): void;
+        CopyTo(Target: ArrayBufferView, StartIndex?: number): number;
         [Symbol.iterator](): IterableIterator<T>;
     }
     
@@ -60,6 +68,8 @@ declare module "ue" {
         GetMaxIndex(): number;  // TODO - GetMaxIndex的返回值是InvalidIndex，合理吗？（GetMaxIndex的解释应该是：最大合法index+1），当调用Empty，返回值为0
         IsValidIndex(Index: number): boolean;
         Empty(): void;
+        FromJsArray(Source: T[]): void;
+        ToJsArray(): T[];
         [Symbol.iterator](): IterableIterator<T>;
     }
     
@@ -74,6 +84,8 @@ declare module "ue" {
         IsValidIndex(Index: number): boolean;
         GetKey(Index: number): TKey;            // TODO - 对于非法index，是否应该返回undefined
         Empty(): void;
+        FromObject(Source: Map<TKey, TValue> | { [key: string]: TValue }): void;
+        ToJsArray(): [TKey, TValue][];
         [Symbol.iterator](): IterableIterator<[TKey, TValue]>;
     }
 
@@ -0,0 +1,49 @@
+/*
+* Tencent is pleased to support the open source community by making Puerts available.
+* Copyright (C) 2020 Tencent.  All rights reserved.
+* Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may be subject to their corresponding license terms.
+* This file is subject to the terms and conditions defined in file 'LICENSE', which is part of this source code package.
+*/
+
+var global = global || (function () { return this; }());
+(function (global) {
+    "use strict";
+    
+    const getFrameDeadline = global.__tgjsGetFrameDeadline;
+    const frameTimeRemaining = global.__tgjsFrameTimeRemaining;
+    const scheduleContinuation = global.__tgjsScheduleContinuation;
+    const cancelContinuation = global.__tgjsCancelContinuation;
+    const getFrameStats = global.__tgjsGetFrameStats;
+    
+    // the js share of a frame is Puerts.ScriptFrameBudgetRatio of the engine frame budget (fixed step or max fps)
+    puerts.frame = {
+        // in the requestAnimationFrame timestamp clock
+        getDeadline: getFrameDeadline,
+        
+        // ms left before the js budget of this frame is spent
+        timeRemaining: frameTimeRemaining,
+        
+        shouldYield: function() {
+            return frameTimeRemaining() <= 0;
+        },
+        
+        // callback(deadline) runs at the beginning of a frame after animation frame callbacks, continuations keep running
+        // in that frame (including the ones they schedule) until the budget is spent, the rest move to the next frame
+        scheduleContinuation: scheduleContinuation,
+        
+        cancelContinuation: cancelContinuation,
+        
+        // {frames, lastMs, maxMs, budgetMs, boundsMs, histogram, pendingContinuations}, histogram[i] counts frames whose js
+        // time was below boundsMs[i], the last bucket the slower ones
+        getStats: getFrameStats
+    };
+    
+    // a scheduler looking for setImmediate (react's does) yields to the next continuation slot instead of a 1ms timer
+    if (typeof global.setImmediate === 'undefined') {
+        global.setImmediate = function(callback, ...args) {
+            return scheduleContinuation(() => callback(...args));
+        };
+        global.clearImmediate = cancelContinuation;
+    }
+    
+}(global));
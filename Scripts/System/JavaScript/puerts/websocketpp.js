@@ -113,13 +113,23 @@ var global = global || (function () { return this; }());
             this._pendingEvents.push(ev);
         }
         
+        // messages are received on a native I/O thread, each poll dispatches everything queued since the last one (up to
+        // WebSocket.maxMessagesPerPoll) in a single native call
         _poll() {
-            if (this._pendingEvents.length === 0 && this._readyState != WebSocket.CLOSING) {
-                this._raw.poll();
-            } 
-            const ev = this._pendingEvents.shift();
-            if (ev) this.dispatchEvent(ev);
-            if ((this._pendingEvents.length === 0 && this._readyState == WebSocket.CLOSING) || (ev && ev.type === 'close')) {
+            if (this._readyState != WebSocket.CLOSING) {
+                this._raw.poll(WebSocket.maxMessagesPerPoll);
+            }
+            const events = this._pendingEvents;
+            this._pendingEvents = [];
+            let closed = false;
+            for (let i = 0; i < events.length; i++) {
+                this.dispatchEvent(events[i]);
+                if (events[i].type === 'close') {
+                    closed = true;
+                    break;
+                }
+            }
+            if ((this._pendingEvents.length === 0 && this._readyState == WebSocket.CLOSING) || closed) {
                 this._raw = undefined;
                 clearInterval(this._tid);
                 this._readyState = WebSocket.CLOSED;
@@ -127,6 +137,11 @@ var global = global || (function () { return this; }());
             }
         }
         
+        // {queued, peakQueued, received, dispatched}, undefined once closed
+        getStats() {
+            return this._raw ? this._raw.stats() : undefined;
+        }
+        
         close(code, data) {
             try {
                 this._raw.close(code, data);
@@ -148,6 +163,9 @@ var global = global || (function () { return this; }());
         });
     }
     
+    // 0 means no limit
+    WebSocket.maxMessagesPerPoll = 256;
+    
     global.WebSocket = WebSocket;
 
 }(global));
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*
+* Tencent is pleased to support the open source community by making Puerts available.
+* Copyright (C) 2020 Tencent.  All rights reserved.
+* Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may be subject to their corresponding license terms.
+* This file is subject to the terms and conditions defined in file 'LICENSE', which is part of this source code package.
+*/
+
+var global = global || (function () { return this; }());
+(function (global) {
+    const PuertsWorker = global.PuertsWorker;
+    if (!PuertsWorker) return;
+
+    // new Worker('workers/sort.js') runs the script in a plain isolate on its own thread: no UE, no require, only
+    // self.onmessage / postMessage(data, transfer) / close() / console. data is a structured clone, ArrayBuffers in the
+    // transfer list are moved instead of copied and detached in the sender.
+    // results are delivered at the beginning of a frame, before requestAnimationFrame callbacks. like on the web a Worker
+    // with onmessage/onerror or listeners, or with messages in flight, stays alive without references until terminate();
+    // an idle Worker nobody listens to or references any more is collected and its thread stopped.
+    class Worker {
+        constructor(scriptPath) {
+            this._raw = new PuertsWorker(scriptPath);
+            this._listeners = {message: [], error: []};
+            this._onmessage = undefined;
+            this._onerror = undefined;
+            // !!do not raise exception in handles.
+            this._raw.setHandles(
+            (data) => {
+                this._dispatch('message', {type:'message', data:data, target:this});
+            },
+            (message) => {
+                this._dispatch('error', {type:'error', message:message, target:this});
+            });
+        }
+
+        get onmessage() { return this._onmessage; }
+        set onmessage(handler) {
+            this._onmessage = handler;
+            this._updateListening();
+        }
+
+        get onerror() { return this._onerror; }
+        set onerror(handler) {
+            this._onerror = handler;
+            this._updateListening();
+        }
+
+        addEventListener(type, callback) {
+            if (!(type in this._listeners)) return;
+            this._listeners[type].push(callback);
+            this._updateListening();
+        }
+
+        removeEventListener(type, callback) {
+            const stack = this._listeners[type];
+            if (!stack) return;
+            const index = stack.indexOf(callback);
+            if (index >= 0) stack.splice(index, 1);
+            this._updateListening();
+        }
+
+        postMessage(data, transfer) {
+            if (!this._raw) return;
+            this._raw.postMessage(data, transfer);
+        }
+
+        // stops the worker thread, messages it has not delivered yet are dropped
+        terminate() {
+            if (!this._raw) return;
+            this._raw.terminate();
+            this._raw = undefined;
+        }
+
+        // {posted, received, ownerMs, workerMs}: ownerMs is the game thread time spent cloning messages, workerMs the
+        // time the worker spent running its script and handlers
+        getStats() {
+            return this._raw ? this._raw.stats() : undefined;
+        }
+
+        _updateListening() {
+            if (!this._raw) return;
+            this._raw.setListening(typeof this._onmessage === 'function' || typeof this._onerror === 'function' ||
+                this._listeners.message.length > 0 || this._listeners.error.length > 0);
+        }
+
+        _dispatch(type, ev) {
+            const handler = this['on' + type];
+            if (typeof handler === 'function') handler.call(this, ev);
+            const stack = this._listeners[type].slice();
+            for (let i = 0; i < stack.length; i++) {
+                stack[i].call(this, ev);
+            }
+        }
+    }
+
+    // messages delivered per worker and frame, 0 means no limit
+    let maxMessagesPerPoll = 64;
+    Object.defineProperty(Worker, 'maxMessagesPerPoll', {
+        get() { return maxMessagesPerPoll; },
+        set(value) {
+            maxMessagesPerPoll = value;
+            PuertsWorker.setMaxMessagesPerPoll(value);
+        }
+    });
+
+    global.Worker = Worker;
+
+}(global));
@@ -8,6 +8,15 @@ const MAX_ERRORS = 5;
 
 let bridgeCaller = puerts_1.argv.getByName("BridgeCaller");
 
+// The compiler outlives a single blueprint compile: one builder program per blueprint script dir is kept for the life of
+// the env and its state is persisted to a .tsbuildinfo, so a recompile only re-checks and re-emits the changed files and
+// the files depending on them. Parsed source files and file hashes are shared by all builders, lib and typing files are
+// parsed once per env.
+const compileServices = new Map();
+const sourceFileCache = new Map();
+const fileStamps = new Map();
+let compileGeneration = 0;
+
 function getFileOptionSystem(callObject) {
     const customSystem = {
         args: [],
@@ -96,33 +105,6 @@ function readAndParseConfigFile(customSystem, configFilePath) {
     }, customSystem.getCurrentDirectory());
 }
 
-function compileInternal(service, sourceFilePath, program, compileErrorReporter) {
-    if (!program) {
-        let beginTime = new Date().getTime();
-        program = getProgramFromService();
-        console.log("incremental compile " + sourceFilePath + " using " + (new Date().getTime() - beginTime) + "ms");
-    }
-    let sourceFile = program.getSourceFile(sourceFilePath);
-    if (sourceFile) {
-        const diagnostics = [
-            ...program.getSyntacticDiagnostics(sourceFile),
-            ...program.getSemanticDiagnostics(sourceFile)
-        ];
-        if (diagnostics.length > 0) {
-            logErrors(diagnostics, compileErrorReporter);
-        } else {
-            if (!sourceFile.isDeclarationFile) {
-                let emitOutput = service.getEmitOutput(sourceFilePath);
-                if (!emitOutput.emitSkipped) {
-                    emitOutput.outputFiles.forEach(output => {
-                        UE.FileSystemOperation.WriteFile(output.name, output.text);
-                    });
-                }
-            }
-        }
-    }
-}
-
 function convertTArrayToJSArray(array) {
     if (array.length === 0) {
         return [];
@@ -135,36 +117,55 @@ function convertTArrayToJSArray(array) {
     return jsArray;
 }
 
-function compile(callObject) {
-    if (!callObject) {
-        console.error("callObject is null");
-        return;
-    }
-
-    let compileErrorReporter = callObject.CompileErrorReporter;
+function isTsSourceFile(fileName) {
+    return fileName.endsWith(".ts") || fileName.endsWith(".tsx");
+}
 
-    let customSystem = getFileOptionSystem(callObject);
+function getBuildInfoPath(callObject) {
+    const fileName = callObject.GetTsScriptHomeRelativeDir().replace(/[\\/:]/g, "_") + ".tsbuildinfo";
+    return tsi.combinePaths(callObject.GetTsProjectDir(), ".reactorumg/buildinfo/" + fileName);
+}
 
-    const configFilePath = tsi.combinePaths(callObject.GetTsProjectDir(), "tsconfig.json");
-    let { filesFromConfig, options } = readAndParseConfigFile(customSystem, configFilePath);
-    const scriptDir = callObject.GetTsScriptHomeFullDir();
-    let fileNames = UE.FileSystemOperation.GetFilesRecursively(scriptDir);
-    fileNames = convertTArrayToJSArray(fileNames);
-    if (fileNames.length === 0) {
-        console.warn("Not found any script file, give up compiling")
-        compileErrorReporter.CompileReportDelegate.Execute("Not found any script file, give up compiling");
-        return;
+// md5 of a file, rehashed only when its timestamp moves. Files under the script dir of a monitored blueprint are not
+// even stat'ed unless the directory monitor reported them.
+function getFileVersion(service, fileName) {
+    let stamp = fileStamps.get(fileName);
+    if (stamp && stamp.checked === compileGeneration) {
+        return stamp.version;
+    }
+    if (stamp && service.trustScriptDir && fileName.startsWith(service.scriptDir)) {
+        stamp.checked = compileGeneration;
+        return stamp.version;
+    }
+    if (!UE.FileSystemOperation.FileExists(fileName)) {
+        fileStamps.delete(fileName);
+        return undefined;
     }
+    const time = UE.FileSystemOperation.FileTimeStamp(fileName);
+    if (!stamp || stamp.time !== time) {
+        stamp = { time, version: UE.FileSystemOperation.FileMD5Hash(fileName), checked: compileGeneration };
+        fileStamps.set(fileName, stamp);
+    }
+    stamp.checked = compileGeneration;
+    return stamp.version;
+}
 
-    console.log("start compile..", JSON.stringify({ fileNames: fileNames, options: options }));
-    const fileVersions = {};
-    let beginTime = new Date().getTime();
-    fileNames.forEach(fileName => {
-        fileVersions[fileName] = { version: UE.FileSystemOperation.FileMD5Hash(fileName), processed: false, isBP: false };
-    });
-    console.log("calc md5 using " + (new Date().getTime() - beginTime) + "ms");
+function createCompileService(callObject, configFilePath, configVersion) {
+    let compileErrorReporter = undefined;
+    const customSystem = getFileOptionSystem(callObject);
+    let { options } = readAndParseConfigFile(customSystem, configFilePath);
+    options = Object.assign({}, options, { incremental: true, tsBuildInfoFile: getBuildInfoPath(callObject) });
 
-    const scriptSnapshotsCache = new Map();
+    const service = {
+        configVersion,
+        scriptDir: tsi.normalizePath(callObject.GetTsScriptHomeFullDir()),
+        options,
+        host: undefined,
+        builder: undefined,
+        resumed: false,
+        trustScriptDir: false,
+        setReporter: reporter => { compileErrorReporter = reporter; }
+    };
 
     const CSS_MODULE_SUFFIX = ".module.css";
     const CSS_MODULE_DECLARATION_TEXT = "declare const classes: { readonly [key: string]: string };\nexport default classes;\n";
@@ -390,133 +391,175 @@ function compile(callObject) {
         return tsi.getDirectoryPath(tsi.normalizePath(customSystem.getExecutingFilePath()));
     }
 
-    const servicesHost = {
-        getScriptFileNames: () => fileNames,
-        getScriptVersion: fileName => {
-            const cssInfo = getCssModuleVirtualInfo(fileName);
-            if (cssInfo) {
-                return cssInfo.version;
-            }
-            const assetInfo = getAssetVirtualInfo(fileName);
-            if (assetInfo) {
-                return assetInfo.version;
-            }
-            if (fileName in fileVersions) {
-                return fileVersions[fileName] && fileVersions[fileName].version.toString();
-            }
-            const md5 = UE.FileSystemOperation.FileMD5Hash(fileName);
-            fileVersions[fileName] = { version: md5, processed: false };
-            return md5;
-        },
-        getScriptSnapshot: fileName => {
-            const cssInfo = getCssModuleVirtualInfo(fileName);
-            if (cssInfo) {
-                return cssInfo.snapshot;
-            }
-            const assetInfo = getAssetVirtualInfo(fileName);
-            if (assetInfo) {
-                return assetInfo.snapshot;
-            }
-            if (!customSystem.fileExists(fileName)) {
-                compileErrorReporter.CompileReportDelegate.Execute(fileName + " file not existed.");
-                console.error("getScriptSnapshot: file not existed! path=" + fileName);
-                return undefined;
-            }
-            if (!(fileName in fileVersions)) {
-                fileVersions[fileName] = { version: UE.FileSystemOperation.FileMD5Hash(fileName), processed: false };
-            }
-            if (!scriptSnapshotsCache.has(fileName)) {
-                const sourceFile = customSystem.readFile(fileName);
-                if (!sourceFile) {
-                    compileErrorReporter.CompileReportDelegate.Execute("read file failed! path=" + fileName);
-                    console.error("getScriptSnapshot: read file failed! path=" + fileName);
-                    return undefined;
-                }
-                scriptSnapshotsCache.set(fileName, {
-                    version: fileVersions[fileName].version,
-                    scriptSnapshot: ts.ScriptSnapshot.fromString(sourceFile)
-                });
-            }
-            let scriptSnapshotsInfo = scriptSnapshotsCache.get(fileName);
-            if (scriptSnapshotsInfo.version != fileVersions[fileName].version) {
-                const sourceFile = customSystem.readFile(fileName);
-                if (!sourceFile) {
-                    compileErrorReporter.CompileReportDelegate.Execute("read file failed! path=" + fileName);
-                    console.error("getScriptSnapshot: read file failed! path=" + fileName);
-                    return undefined;
-                }
-                scriptSnapshotsInfo.version = fileVersions[fileName].version;
-                scriptSnapshotsInfo.scriptSnapshot = ts.ScriptSnapshot.fromString(sourceFile);
-            }
-            return scriptSnapshotsInfo.scriptSnapshot;
-        },
-        getCurrentDirectory: customSystem.getCurrentDirectory,
-        getCompilationSettings: () => options,
+    function getSourceFile(fileName, languageVersion) {
+        const virtualInfo = getCssModuleVirtualInfo(fileName) || getAssetVirtualInfo(fileName);
+        const version = virtualInfo ? virtualInfo.version : getFileVersion(service, fileName);
+        if (version === undefined) {
+            compileErrorReporter.CompileReportDelegate.Execute(fileName + " file not existed.");
+            console.error("getSourceFile: file not existed! path=" + fileName);
+            return undefined;
+        }
+        const cached = sourceFileCache.get(fileName);
+        if (cached && cached.version === version) {
+            return cached;
+        }
+        const text = virtualInfo ? (virtualInfo.declarationText || CSS_MODULE_DECLARATION_TEXT) : customSystem.readFile(fileName);
+        if (text === undefined) {
+            compileErrorReporter.CompileReportDelegate.Execute("read file failed! path=" + fileName);
+            console.error("getSourceFile: read file failed! path=" + fileName);
+            return undefined;
+        }
+        const sourceFile = ts.createSourceFile(fileName, text, languageVersion);
+        // the builder compares these to find the changed files, both in memory and against the .tsbuildinfo
+        sourceFile.version = version;
+        sourceFileCache.set(fileName, sourceFile);
+        return sourceFile;
+    }
+
+    service.host = {
+        getSourceFile,
         getDefaultLibFileName: options => tsi.combinePaths(getDefaultLibLocation(), ts.getDefaultLibFileName(options)),
-        fileExists: fileName => !!getCssModuleVirtualInfo(fileName) || !!getAssetVirtualInfo(fileName) || fileExistsSafe(fileName),
-        readFile: fileName => {
-            const cssInfo = getCssModuleVirtualInfo(fileName);
-            if (cssInfo) {
-                return CSS_MODULE_DECLARATION_TEXT;
-            }
-            const assetInfo = getAssetVirtualInfo(fileName);
-            if (assetInfo) {
-                return assetInfo.declarationText;
-            }
-            return customSystem.readFile(fileName);
-        },
-        readDirectory: customSystem.readDirectory,
+        getDefaultLibLocation,
+        writeFile: (fileName, text) => UE.FileSystemOperation.WriteFile(fileName, text),
+        getCurrentDirectory: customSystem.getCurrentDirectory,
+        getCanonicalFileName: fileName => fileName,
+        useCaseSensitiveFileNames: () => customSystem.useCaseSensitiveFileNames,
+        getNewLine: () => customSystem.newLine,
+        fileExists: moduleResolutionHost.fileExists,
+        readFile: moduleResolutionHost.readFile,
         directoryExists: customSystem.directoryExists,
         getDirectories: customSystem.getDirectories,
+        realpath: path => tsi.realpath(path),
         resolveModuleNames: (moduleNames, containingFile, reusedNames, redirectedReference, optionsOverride) => {
             return moduleNames.map(moduleName => resolveModuleNameForHost(moduleName, containingFile, redirectedReference, optionsOverride));
         },
-        resolveModuleNameLiterals: (moduleLiterals, containingFile, redirectedReference, optionsOverride) => {
-            return moduleLiterals.map(lit => {
-                const resolvedModule = resolveModuleNameForHost(lit.text, containingFile, redirectedReference, optionsOverride);
-                return resolvedModule ? { resolvedModule } : undefined;
-            });
-        },
+    };
+    return service;
+}
+
+function getCompileService(callObject) {
+    const configFilePath = tsi.combinePaths(callObject.GetTsProjectDir(), "tsconfig.json");
+    const configVersion = UE.FileSystemOperation.FileMD5Hash(configFilePath);
+    const key = tsi.normalizePath(callObject.GetTsScriptHomeFullDir());
+    let service = compileServices.get(key);
+    if (!service || service.configVersion !== configVersion) {
+        service = createCompileService(callObject, configFilePath, configVersion);
+        compileServices.set(key, service);
     }
+    return service;
+}
 
-    let service = ts.createLanguageService(servicesHost, ts.createDocumentRegistry());
-    let getProgramErrorCount = 0;
-    function getProgramFromService() {
-        while (true) {
-            try {
-                return service.getProgram();
+// the directory monitor only sees the blueprint's own script dir; when it was not running since the last compile every
+// file falls back to the timestamp check
+function applyFileChanges(service, callObject) {
+    const complete = callObject.IsTsChangeListComplete();
+    const changedFiles = convertTArrayToJSArray(callObject.ConsumeChangedTsFiles());
+    service.trustScriptDir = complete;
+    changedFiles.forEach(fileName => {
+        fileStamps.delete(tsi.normalizePath(fileName));
+    });
+    return changedFiles.length;
+}
+
+function createBuilderProgram(service, rootNames, compileErrorReporter) {
+    let errorCount = 0;
+    while (true) {
+        try {
+            if (!service.resumed) {
+                // first build of this editor session picks up where the last one stopped
+                service.resumed = true;
+                service.builder = ts.readBuilderProgram(service.options, service.host);
             }
-            catch (e) {
-                console.error(e);
-                // Add a mechanism to exit after exceeding maximum error count
-                if (!getProgramErrorCount) {
-                    getProgramErrorCount = 1;
-                } else {
-                    getProgramErrorCount++;
-                }
-                
-                // Exit after 5 consecutive errors
-                if (getProgramErrorCount >= MAX_ERRORS) {
-                    compileErrorReporter.CompileReportDelegate.Execute("Exceeded maximum error count (5). Exiting compilation process.");
-                    console.error("Exceeded maximum error count (5). Exiting compilation process.");
-                    throw new Error("Maximum error count exceeded during compilation");
-                }
+            service.builder = ts.createEmitAndSemanticDiagnosticsBuilderProgram(rootNames, service.options, service.host, service.builder);
+            return service.builder;
+        }
+        catch (e) {
+            console.error(e);
+            errorCount++;
+            if (errorCount >= MAX_ERRORS) {
+                service.builder = undefined;
+                compileErrorReporter.CompileReportDelegate.Execute("Exceeded maximum error count (5). Exiting compilation process.");
+                console.error("Exceeded maximum error count (5). Exiting compilation process.");
+                throw new Error("Maximum error count exceeded during compilation");
             }
-            //异常了重新创建Language Service，有可能不断失败,UE的文件读取偶尔会失败，失败后ts增量编译会不断的在tryReuseStructureFromOldProgram那断言失败
-            service = ts.createLanguageService(servicesHost, ts.createDocumentRegistry());
-
+            //UE的文件读取偶尔会失败，失败后ts增量编译会不断的在tryReuseStructureFromOldProgram那断言失败，丢掉旧状态重新全量编译
+            service.builder = undefined;
         }
     }
+}
+
+function compile(callObject) {
+    if (!callObject) {
+        console.error("callObject is null");
+        return;
+    }
+
+    let compileErrorReporter = callObject.CompileErrorReporter;
 
-    beginTime = new Date().getTime();
-    let program = getProgramFromService();
-    console.log("full compile using " + (new Date().getTime() - beginTime) + "ms");
-    fileNames.forEach(fileName => {
-        if (fileName.endsWith(".ts") || fileName.endsWith(".tsx")) {
-            compileInternal(service, fileName, program, compileErrorReporter);
+    const scriptDir = callObject.GetTsScriptHomeFullDir();
+    let fileNames = UE.FileSystemOperation.GetFilesRecursively(scriptDir);
+    fileNames = convertTArrayToJSArray(fileNames).map(fileName => tsi.normalizePath(fileName));
+    if (fileNames.length === 0) {
+        console.warn("Not found any script file, give up compiling")
+        compileErrorReporter.CompileReportDelegate.Execute("Not found any script file, give up compiling");
+        return;
+    }
+
+    const beginTime = new Date().getTime();
+    compileGeneration++;
+    const service = getCompileService(callObject);
+    service.setReporter(compileErrorReporter);
+    const changedCount = applyFileChanges(service, callObject);
+    const rootNames = fileNames.filter(isTsSourceFile);
+
+    const builder = createBuilderProgram(service, rootNames, compileErrorReporter);
+    const programTime = new Date().getTime();
+
+    // check the affected files first, diagnostics of the others come from the builder's cache
+    let affectedCount = 0;
+    while (builder.getSemanticDiagnosticsOfNextAffectedFile()) {
+        affectedCount++;
+    }
+    const erroredFiles = new Set();
+    const diagnostics = [];
+    rootNames.forEach(fileName => {
+        const sourceFile = builder.getSourceFile(fileName);
+        if (!sourceFile) {
+            return;
+        }
+        const fileDiagnostics = [
+            ...builder.getSyntacticDiagnostics(sourceFile),
+            ...builder.getSemanticDiagnostics(sourceFile)
+        ];
+        if (fileDiagnostics.length > 0) {
+            erroredFiles.add(sourceFile.fileName);
+            diagnostics.push(...fileDiagnostics);
         }
     });
+    if (diagnostics.length > 0) {
+        logErrors(diagnostics, compileErrorReporter);
+    }
+    const checkTime = new Date().getTime();
+
+    let writtenCount = 0;
+    const writeFile = (fileName, text, writeByteOrderMark, onError, sourceFiles) => {
+        if (sourceFiles && sourceFiles.some(sourceFile => erroredFiles.has(sourceFile.fileName))) {
+            return;
+        }
+        UE.FileSystemOperation.WriteFile(fileName, text);
+        writtenCount++;
+    };
+    while (builder.emitNextAffectedFile(writeFile)) {
+    }
+    const endTime = new Date().getTime();
+
+    const summary = `TypeScript ${callObject.GetTsScriptHomeRelativeDir()}: ${changedCount} reported changes, ${affectedCount} affected files, `
+        + `${writtenCount} outputs written, ${erroredFiles.size} files with errors; program ${programTime - beginTime}ms, `
+        + `check ${checkTime - programTime}ms, emit ${endTime - checkTime}ms`;
+    console.log(summary);
+    compileErrorReporter.CompileNoteDelegate.Execute(summary);
 
+    service.setReporter(undefined);
     compileErrorReporter = undefined;
 }
 
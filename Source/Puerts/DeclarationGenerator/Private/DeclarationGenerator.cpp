@@ -48,6 +48,9 @@
 #include "FileSystemOperation.h"
 #endif
 #include "PathEscape.h"
+#include "Hash/CityHash.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
 
 #define STRINGIZE(x) #x
 #define STRINGIZE_VALUE_OF(x) STRINGIZE(x)
@@ -193,6 +196,422 @@ void FStringBuffer::Indent(int Num)
     }
 }
 
+// bump when the generated text changes for the same reflected layout
+static constexpr uint64 DeclarationCacheVersion = 1
+#ifdef PUERTS_WITH_EDITOR_SUFFIX
+                                                  + 1000
+#endif
+#if defined(WITHOUT_BP_NAMESPACE)
+                                                  + 2000
+#endif
+    ;
+
+static constexpr uint32 DeclarationCacheMagic = 0x50444354;
+
+struct FLayoutHasher
+{
+    uint64 Value;
+
+    explicit FLayoutHasher(uint64 Seed) : Value(Seed)
+    {
+    }
+
+    void Add(const FString& Text)
+    {
+        Value = CityHash64WithSeed((const char*) *Text, Text.Len() * sizeof(TCHAR), Value);
+    }
+
+    void Add(const char* Text)
+    {
+        if (Text)
+        {
+            Value = CityHash64WithSeed(Text, FCStringAnsi::Strlen(Text), Value);
+        }
+    }
+
+    void Add(uint64 Number)
+    {
+        Value = CityHash64WithSeed((const char*) &Number, sizeof(Number), Value);
+    }
+};
+
+static void HashFunctionLayout(FLayoutHasher& Hasher, UFunction* Function);
+
+static void HashPropertiesLayout(FLayoutHasher& Hasher, const UStruct* Struct, EFieldIteratorFlags::SuperClassFlags SuperFlags)
+{
+    for (TFieldIterator<PropertyMacro> PropertyIt(Struct, SuperFlags); PropertyIt; ++PropertyIt)
+    {
+        auto Property = *PropertyIt;
+        Hasher.Add(Property->GetName());
+        Hasher.Add(Property->GetClass()->GetName());
+        Hasher.Add((uint64) Property->PropertyFlags);
+        Hasher.Add((uint64) Property->ArrayDim);
+        Hasher.Add(Property->GetCPPType());
+        if (auto DelegateProperty = CastFieldMacro<DelegatePropertyMacro>(Property))
+        {
+            HashFunctionLayout(Hasher, DelegateProperty->SignatureFunction);
+        }
+        else if (auto MulticastDelegateProperty = CastFieldMacro<MulticastDelegatePropertyMacro>(Property))
+        {
+            HashFunctionLayout(Hasher, MulticastDelegateProperty->SignatureFunction);
+        }
+    }
+}
+
+static void HashFunctionLayout(FLayoutHasher& Hasher, UFunction* Function)
+{
+    if (!Function)
+    {
+        return;
+    }
+    Hasher.Add(Function->GetName());
+    Hasher.Add((uint64) Function->FunctionFlags);
+    HashPropertiesLayout(Hasher, Function, EFieldIteratorFlags::IncludeSuper);
+
+    // doc comments and default values end up in the declaration
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION > 5
+    TMap<FName, FString>* MetaMap = FMetaData::GetMapForObject(Function);
+#else
+    TMap<FName, FString>* MetaMap = UMetaData::GetMapForObject(Function);
+#endif
+    if (MetaMap)
+    {
+        for (auto& KV : *MetaMap)
+        {
+            const FString Key = KV.Key.ToString();
+            if (Key == TEXT("ToolTip") || Key.StartsWith(TEXT("CPP_Default_")))
+            {
+                Hasher.Add(Key);
+                Hasher.Add(KV.Value);
+            }
+        }
+    }
+}
+
+static void HashFunctionInfos(FLayoutHasher& Hasher, const PUERTS_NAMESPACE::NamedFunctionInfo* FunctionInfo)
+{
+    while (FunctionInfo && FunctionInfo->Name && FunctionInfo->Type)
+    {
+        Hasher.Add(FunctionInfo->Name);
+        if (FunctionInfo->Type->Return())
+        {
+            Hasher.Add(FunctionInfo->Type->Return()->Name());
+        }
+        for (unsigned int i = 0; i < FunctionInfo->Type->ArgumentCount(); i++)
+        {
+            Hasher.Add(FunctionInfo->Type->Argument(i)->Name());
+        }
+        ++FunctionInfo;
+    }
+}
+
+static void HashPropertyInfos(FLayoutHasher& Hasher, const PUERTS_NAMESPACE::NamedPropertyInfo* PropertyInfo)
+{
+    while (PropertyInfo && PropertyInfo->Name && PropertyInfo->Type)
+    {
+        Hasher.Add(PropertyInfo->Name);
+        Hasher.Add(PropertyInfo->Type->Name());
+        ++PropertyInfo;
+    }
+}
+
+// The declaration fragment of every native type, cached across runs together with everything needed to replay it in
+// place: the types it pulled in through Gen (in call order) and the function overloads its subclasses look up.
+// A fragment is reused while the layout hash of the type and of its super chain are unchanged.
+struct FDeclarationFragmentCache
+{
+    struct FCachedOverloads
+    {
+        FString FunctionName;
+        bool IsStatic = false;
+        TArray<FString> Overloads;
+
+        friend FArchive& operator<<(FArchive& Ar, FCachedOverloads& Overloads)
+        {
+            return Ar << Overloads.FunctionName << Overloads.IsStatic << Overloads.Overloads;
+        }
+    };
+
+    struct FFragment
+    {
+        uint64 LayoutHash = 0;
+        FString Text;
+        TArray<FString> Deps;
+        TArray<FCachedOverloads> Functions;
+
+        friend FArchive& operator<<(FArchive& Ar, FFragment& Fragment)
+        {
+            return Ar << Fragment.LayoutHash << Fragment.Text << Fragment.Deps << Fragment.Functions;
+        }
+    };
+
+    // a native type being generated, nullptr entries stop recording while a cached fragment replays its deps
+    struct FRecord
+    {
+        UObject* Type = nullptr;
+        TArray<UObject*> Deps;
+        FString Text;
+        bool Captured = false;
+    };
+
+    bool Reuse = true;
+
+    uint64 LastOutputHash = 0;
+
+    int32 Hits = 0;
+
+    int32 Misses = 0;
+
+    TMap<FString, FFragment> Loaded;
+
+    TMap<FString, FFragment> Saved;
+
+    TMap<const UObject*, uint64> LayoutHashes;
+
+    TMap<const UObject*, uint64> LocalHashes;
+
+    TMap<const UObject*, FString> TypePaths;
+
+    TMap<FString, UObject*> TypesByPath;
+
+    TArray<TUniquePtr<FRecord>> Stack;
+
+    static FString GetCacheFilePath()
+    {
+        return FPaths::ProjectIntermediateDir() / TEXT("DeclarationGenerator") / TEXT("ue.d.ts.cache");
+    }
+
+    void RecordDependency(UObject* Type)
+    {
+        if (Stack.Num() > 0 && Stack.Last())
+        {
+            Stack.Last()->Deps.Add(Type);
+        }
+    }
+
+    void Capture(UObject* Type, const FString& Buffer, int32 Start)
+    {
+        if (Stack.Num() > 0 && Stack.Last() && Stack.Last()->Type == Type)
+        {
+            Stack.Last()->Text = Buffer.Mid(Start);
+            Stack.Last()->Captured = true;
+        }
+    }
+
+    void HashTypes(const TArray<UObject*>& Types, const std::map<UStruct*, std::vector<UFunction*>>& ExtensionMethodsMap)
+    {
+        // metadata may be created on demand, make sure it exists before the workers read it
+        TSet<UPackage*> Packages;
+        for (UObject* Type : Types)
+        {
+            if (Type->IsNative())
+            {
+                Packages.Add(Type->GetOutermost());
+            }
+        }
+        for (UPackage* Package : Packages)
+        {
+            (void) Package->GetMetaData();
+        }
+
+        UEnum* ObjectTypeQueryEnum = StaticEnum<EObjectTypeQuery>();
+        UEnum* TraceTypeQueryEnum = StaticEnum<ETraceTypeQuery>();
+
+        TArray<uint64> Hashes;
+        Hashes.SetNumZeroed(Types.Num());
+        TArray<FString> Paths;
+        Paths.SetNum(Types.Num());
+        ParallelFor(Types.Num(),
+            [&](int32 Index)
+            {
+                UObject* Type = Types[Index];
+                Paths[Index] = Type->GetPathName();
+                if (!Type->IsNative() || Type == ObjectTypeQueryEnum || Type == TraceTypeQueryEnum)
+                {
+                    // collision channels come from the project settings, blueprint types have their own cache
+                    return;
+                }
+
+                FLayoutHasher Hasher(DeclarationCacheVersion);
+                Hasher.Add(Type->GetClass()->GetName());
+                Hasher.Add(Type->GetName());
+                if (auto Enum = Cast<UEnum>(Type))
+                {
+                    for (int i = 0; i < Enum->NumEnums(); ++i)
+                    {
+                        Hasher.Add(Enum->GetNameStringByIndex(i));
+                        Hasher.Add((uint64) Enum->GetValueByIndex(i));
+                    }
+                }
+                else if (auto Struct = Cast<UStruct>(Type))
+                {
+                    if (auto Super = Struct->GetSuperStruct())
+                    {
+                        Hasher.Add(Super->GetPathName());
+                    }
+                    HashPropertiesLayout(Hasher, Struct, EFieldIteratorFlags::ExcludeSuper);
+                    if (auto Class = Cast<UClass>(Struct))
+                    {
+                        for (TFieldIterator<UFunction> FunctionIt(Class, EFieldIteratorFlags::ExcludeSuper); FunctionIt; ++FunctionIt)
+                        {
+                            HashFunctionLayout(Hasher, *FunctionIt);
+                        }
+                        for (int i = 0; i < Class->Interfaces.Num(); i++)
+                        {
+                            Hasher.Add(Class->Interfaces[i].Class->GetPathName());
+                            for (TFieldIterator<UFunction> FunctionIt(Class->Interfaces[i].Class, EFieldIteratorFlags::IncludeSuper);
+                                 FunctionIt; ++FunctionIt)
+                            {
+                                HashFunctionLayout(Hasher, *FunctionIt);
+                            }
+                        }
+                    }
+                    auto ExtensionMethodsIter = ExtensionMethodsMap.find(Struct);
+                    if (ExtensionMethodsIter != ExtensionMethodsMap.end())
+                    {
+                        for (UFunction* Function : ExtensionMethodsIter->second)
+                        {
+                            Hasher.Add(Function->GetOuter()->GetPathName());
+                            HashFunctionLayout(Hasher, Function);
+                        }
+                    }
+                }
+                Hashes[Index] = Hasher.Value == 0 ? 1 : Hasher.Value;
+            });
+
+        TypePaths.Reserve(Types.Num());
+        TypesByPath.Reserve(Types.Num());
+        LocalHashes.Reserve(Types.Num());
+        for (int32 i = 0; i < Types.Num(); ++i)
+        {
+            TypePaths.Add(Types[i], Paths[i]);
+            TypesByPath.Add(MoveTemp(Paths[i]), Types[i]);
+            LocalHashes.Add(Types[i], Hashes[i]);
+        }
+        for (UObject* Type : Types)
+        {
+            GetLayoutHash(Type);
+        }
+    }
+
+    // local hash combined with the template bindings and the super chain, 0 means the type is never cached
+    uint64 GetLayoutHash(UObject* Type)
+    {
+        if (const uint64* Hash = LayoutHashes.Find(Type))
+        {
+            return *Hash;
+        }
+        const uint64* LocalHash = LocalHashes.Find(Type);
+        uint64 Result = LocalHash ? *LocalHash : 0;
+        if (Result != 0)
+        {
+            if (auto Struct = Cast<UStruct>(Type))
+            {
+                FLayoutHasher Hasher(Result);
+                if (auto ClassDefinition = PUERTS_NAMESPACE::FindClassByType(Struct))
+                {
+                    HashFunctionInfos(Hasher, ClassDefinition->ConstructorInfos);
+                    HashFunctionInfos(Hasher, ClassDefinition->FunctionInfos);
+                    HashFunctionInfos(Hasher, ClassDefinition->MethodInfos);
+                    HashPropertyInfos(Hasher, ClassDefinition->PropertyInfos);
+                    HashPropertyInfos(Hasher, ClassDefinition->VariableInfos);
+                }
+                if (auto Super = Struct->GetSuperStruct())
+                {
+                    const uint64 SuperHash = GetLayoutHash(Super);
+                    Hasher.Add(SuperHash);
+                    if (SuperHash == 0)
+                    {
+                        Hasher.Value = 0;
+                    }
+                }
+                Result = Hasher.Value;
+            }
+        }
+        LayoutHashes.Add(Type, Result);
+        return Result;
+    }
+
+    bool Load(const FString& FilePath)
+    {
+        TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+        if (!Reader)
+        {
+            return false;
+        }
+        uint32 Magic = 0;
+        uint64 Version = 0;
+        *Reader << Magic << Version;
+        if (Magic != DeclarationCacheMagic || Version != DeclarationCacheVersion)
+        {
+            return false;
+        }
+        int32 Num = 0;
+        *Reader << LastOutputHash << Num;
+        Loaded.Reserve(FMath::Max(Num, 0));
+        for (int32 i = 0; i < Num && !Reader->IsError(); ++i)
+        {
+            FString Path;
+            FFragment Fragment;
+            *Reader << Path << Fragment;
+            Loaded.Add(MoveTemp(Path), MoveTemp(Fragment));
+        }
+        if (Reader->IsError())
+        {
+            Loaded.Empty();
+            LastOutputHash = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void Save(const FString& FilePath)
+    {
+        TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+        if (!Writer)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("can not write declaration cache %s"), *FilePath);
+            return;
+        }
+        uint32 Magic = DeclarationCacheMagic;
+        uint64 Version = DeclarationCacheVersion;
+        int32 Num = Saved.Num();
+        *Writer << Magic << Version << LastOutputHash << Num;
+        for (auto& KV : Saved)
+        {
+            FString Path = KV.Key;
+            *Writer << Path << KV.Value;
+        }
+        Writer->Close();
+    }
+};
+
+// writes the declaration in utf8 chunks instead of converting the whole buffer at once
+static bool SaveDeclarationFile(const FString& Text, const FString& FilePath)
+{
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+    if (!Writer)
+    {
+        return false;
+    }
+    const int32 ChunkSize = 64 * 1024;
+    int32 Pos = 0;
+    while (Pos < Text.Len())
+    {
+        int32 Len = FMath::Min(ChunkSize, Text.Len() - Pos);
+        // never split a utf16 surrogate pair between two chunks
+        const TCHAR Last = Text[Pos + Len - 1];
+        if (Pos + Len < Text.Len() && sizeof(TCHAR) == 2 && Last >= 0xD800 && Last <= 0xDBFF)
+        {
+            --Len;
+        }
+        FTCHARToUTF8 Utf8(*Text + Pos, Len);
+        Writer->Serialize((void*) Utf8.Get(), Utf8.Length());
+        Pos += Len;
+    }
+    return Writer->Close();
+}
+
 TArray<UObject*> GetSortedClasses(bool GenStruct = false, bool GenEnum = false)
 {
     TArray<UObject*> SortedClasses;
@@ -217,7 +636,18 @@ TArray<UObject*> GetSortedClasses(bool GenStruct = false, bool GenEnum = false)
         }
     }
 
-    SortedClasses.Sort([&](const UObject& ClassA, const UObject& ClassB) -> bool { return ClassA.GetName() < ClassB.GetName(); });
+    // GetName allocates, build the names once instead of in every comparison
+    TArray<TPair<FString, UObject*>> NamedClasses;
+    NamedClasses.Reserve(SortedClasses.Num());
+    for (UObject* Class : SortedClasses)
+    {
+        NamedClasses.Emplace(Class->GetName(), Class);
+    }
+    NamedClasses.Sort([](const TPair<FString, UObject*>& A, const TPair<FString, UObject*>& B) -> bool { return A.Key < B.Key; });
+    for (int32 i = 0; i < NamedClasses.Num(); ++i)
+    {
+        SortedClasses[i] = NamedClasses[i].Value;
+    }
 
     return SortedClasses;
 }
@@ -314,6 +744,7 @@ void GenArgumentsForFunctionInfo(const PUERTS_NAMESPACE::CFunctionInfo* Type, FS
 
 void FTypeScriptDeclarationGenerator::InitExtensionMethodsMap()
 {
+    ExtensionMethodsMap.clear();
     TArray<UObject*> SortedClasses(GetSortedClasses());
     for (int i = 0; i < SortedClasses.Num(); ++i)
     {
@@ -359,14 +790,25 @@ void FTypeScriptDeclarationGenerator::InitExtensionMethodsMap()
 
 void FTypeScriptDeclarationGenerator::GenTypeScriptDeclaration(bool InGenStruct, bool InGenEnum)
 {
+    const double BeginTime = FPlatformTime::Seconds();
     Begin();
     BeginGenAssetData = false;
     TArray<UObject*> SortedClasses(GetSortedClasses(InGenStruct, InGenEnum));
+
+    FragmentCache = MakeShared<FDeclarationFragmentCache>();
+    FragmentCache->Reuse = UseFragmentCache;
+    const FString CacheFilePath = FDeclarationFragmentCache::GetCacheFilePath();
+    if (UseFragmentCache)
+    {
+        FragmentCache->Load(CacheFilePath);
+    }
+    FragmentCache->HashTypes(SortedClasses, ExtensionMethodsMap);
+
+    const TArray<FString>& IgnoreClassListOnDTS = IPuertsModule::Get().GetIgnoreClassListOnDTS();
     for (int i = 0; i < SortedClasses.Num(); ++i)
     {
         UObject* Class = SortedClasses[i];
         checkfSlow(Class != nullptr, TEXT("Class name corruption!"));
-        const TArray<FString>& IgnoreClassListOnDTS = IPuertsModule::Get().GetIgnoreClassListOnDTS();
         if (IgnoreClassListOnDTS.Contains(Class->GetName()))
         {
             continue;
@@ -418,11 +860,21 @@ void FTypeScriptDeclarationGenerator::GenTypeScriptDeclaration(bool InGenStruct,
 
     const FString UEDeclarationFilePath = GetDeclFilePathFromOutputDir(OutDir, TEXT("ue.d.ts"));
 
+    // leave an unchanged ue.d.ts alone so incremental ts builds do not recheck everything
+    const uint64 OutputHash = CityHash64((const char*) *Output.Buffer, Output.Buffer.Len() * sizeof(TCHAR));
+    if (OutputHash != FragmentCache->LastOutputHash || !PlatformFile.FileExists(*UEDeclarationFilePath))
+    {
 #ifdef PUERTS_WITH_SOURCE_CONTROL
-    PuertsSourceControlUtils::MakeSourceControlFileWritable(UEDeclarationFilePath);
+        PuertsSourceControlUtils::MakeSourceControlFileWritable(UEDeclarationFilePath);
 #endif
 
-    FFileHelper::SaveStringToFile(ToString(), *UEDeclarationFilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+        SaveDeclarationFile(ToString(), UEDeclarationFilePath);
+    }
+    FragmentCache->LastOutputHash = OutputHash;
+    FragmentCache->Save(CacheFilePath);
+    UE_LOG(LogTemp, Display, TEXT("ue.d.ts: %d types reused, %d generated, %.1fms"), FragmentCache->Hits, FragmentCache->Misses,
+        (FPlatformTime::Seconds() - BeginTime) * 1000);
+    FragmentCache.Reset();
 
     Begin();
     for (auto& KV : BlueprintTypeDeclInfoCache)
@@ -534,9 +986,14 @@ void FTypeScriptDeclarationGenerator::WriteOutput(UObject* Obj, const FStringBuf
     }
     else if (Obj->IsNative() || IsPluginBPClass)
     {
+        const int32 Start = Output.Buffer.Len();
         NamespaceBegin(Obj, Output);
         Output << Buff;
         NamespaceEnd(Obj, Output);
+        if (FragmentCache)
+        {
+            FragmentCache->Capture(Obj, Output.Buffer, Start);
+        }
     }
 }
 
@@ -690,6 +1147,10 @@ void FTypeScriptDeclarationGenerator::LoadAllWidgetBlueprint(FName InSearchPath,
 
 void FTypeScriptDeclarationGenerator::Gen(UObject* ToGen)
 {
+    if (FragmentCache)
+    {
+        FragmentCache->RecordDependency(ToGen);
+    }
     if (ToGen->GetName().Equals(TEXT("ArrayBuffer")) || ToGen->GetName().Equals(TEXT("ArrayBufferValue")) ||
         ToGen->GetName().Equals(TEXT("JsObject")))
     {
@@ -723,6 +1184,22 @@ void FTypeScriptDeclarationGenerator::Gen(UObject* ToGen)
         }
     }
 
+    const bool CacheFragment = FragmentCache && ToGen->IsNative();
+    if (CacheFragment && GenFromFragmentCache(ToGen))
+    {
+        return;
+    }
+    if (FragmentCache)
+    {
+        TUniquePtr<FDeclarationFragmentCache::FRecord> Record;
+        if (CacheFragment)
+        {
+            Record = MakeUnique<FDeclarationFragmentCache::FRecord>();
+            Record->Type = ToGen;
+        }
+        FragmentCache->Stack.Push(MoveTemp(Record));
+    }
+
     if (auto Class = Cast<UClass>(ToGen))
     {
         GenClass(Class);
@@ -735,6 +1212,84 @@ void FTypeScriptDeclarationGenerator::Gen(UObject* ToGen)
     {
         GenEnum(Enum);
     }
+
+    if (FragmentCache)
+    {
+        TUniquePtr<FDeclarationFragmentCache::FRecord> Record = FragmentCache->Stack.Pop();
+        const uint64 LayoutHash = CacheFragment ? FragmentCache->GetLayoutHash(ToGen) : 0;
+        if (Record && Record->Captured && LayoutHash != 0)
+        {
+            FDeclarationFragmentCache::FFragment Fragment;
+            Fragment.LayoutHash = LayoutHash;
+            Fragment.Text = MoveTemp(Record->Text);
+            for (UObject* Dep : Record->Deps)
+            {
+                const FString* DepPath = FragmentCache->TypePaths.Find(Dep);
+                Fragment.Deps.Add(DepPath ? *DepPath : Dep->GetPathName());
+            }
+            auto OutputsIter = AllFuncionOutputs.find(Cast<UStruct>(ToGen));
+            if (OutputsIter != AllFuncionOutputs.end())
+            {
+                for (auto& KV : OutputsIter->second)
+                {
+                    Fragment.Functions.Add({KV.first.FunctionName, KV.first.IsStatic, KV.second});
+                }
+            }
+            FragmentCache->Saved.Add(FragmentCache->TypePaths.FindRef(ToGen), MoveTemp(Fragment));
+        }
+        if (CacheFragment)
+        {
+            ++FragmentCache->Misses;
+        }
+    }
+}
+
+bool FTypeScriptDeclarationGenerator::GenFromFragmentCache(UObject* ToGen)
+{
+    FDeclarationFragmentCache& Cache = *FragmentCache;
+    const uint64 LayoutHash = Cache.GetLayoutHash(ToGen);
+    const FString* Path = Cache.TypePaths.Find(ToGen);
+    if (!Cache.Reuse || LayoutHash == 0 || !Path)
+    {
+        return false;
+    }
+    FDeclarationFragmentCache::FFragment* Fragment = Cache.Loaded.Find(*Path);
+    if (!Fragment || Fragment->LayoutHash != LayoutHash)
+    {
+        return false;
+    }
+    TArray<UObject*> Deps;
+    Deps.Reserve(Fragment->Deps.Num());
+    for (const FString& DepPath : Fragment->Deps)
+    {
+        UObject* const* Dep = Cache.TypesByPath.Find(DepPath);
+        if (!Dep)
+        {
+            return false;
+        }
+        Deps.Add(*Dep);
+    }
+
+    // same order as the run that produced the fragment: what it generated first still comes first in the output
+    Cache.Stack.Push(nullptr);
+    for (UObject* Dep : Deps)
+    {
+        Gen(Dep);
+    }
+    Cache.Stack.Pop();
+
+    if (auto Struct = Cast<UStruct>(ToGen))
+    {
+        FunctionOutputs& Outputs = GetFunctionOutputs(Struct);
+        for (auto& Overloads : Fragment->Functions)
+        {
+            Outputs[FunctionKey(Overloads.FunctionName, Overloads.IsStatic)] = Overloads.Overloads;
+        }
+    }
+    Output.Buffer += Fragment->Text;
+    Cache.Saved.Add(*Path, MoveTemp(*Fragment));
+    ++Cache.Hits;
+    return true;
 }
 
 // #lizard forgives
@@ -1709,6 +2264,7 @@ public:
     void GenTypeScriptDeclaration(bool InGenFull, FName InSearchPath) override
     {
         FTypeScriptDeclarationGenerator TypeScriptDeclarationGenerator;
+        TypeScriptDeclarationGenerator.UseFragmentCache = !InGenFull;
         TypeScriptDeclarationGenerator.RestoreBlueprintTypeDeclInfos(InGenFull);
         TypeScriptDeclarationGenerator.LoadAllWidgetBlueprint(InSearchPath, InGenFull);
         TypeScriptDeclarationGenerator.GenTypeScriptDeclaration(true, true);
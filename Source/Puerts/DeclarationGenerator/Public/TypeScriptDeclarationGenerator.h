@@ -30,6 +30,8 @@ struct DECLARATIONGENERATOR_API FStringBuffer
     void Indent(int Num);
 };
 
+struct FDeclarationFragmentCache;
+
 struct DECLARATIONGENERATOR_API FTypeScriptDeclarationGenerator
 {
     FStringBuffer Output{"", ""};
@@ -76,6 +78,12 @@ struct DECLARATIONGENERATOR_API FTypeScriptDeclarationGenerator
 
     bool BeginGenAssetData = false;
 
+    // reuse the fragments of native types whose reflected layout did not change since the last run, the cache is
+    // rewritten either way
+    bool UseFragmentCache = true;
+
+    TSharedPtr<FDeclarationFragmentCache> FragmentCache;
+
     const FString& GetNamespace(UObject* Obj);
 
     FString GetNameWithNamespace(UObject* Obj);
@@ -102,6 +110,8 @@ struct DECLARATIONGENERATOR_API FTypeScriptDeclarationGenerator
 
     virtual void Gen(UObject* ToGen);
 
+    bool GenFromFragmentCache(UObject* ToGen);
+
     virtual bool GenTypeDecl(FStringBuffer& StringBuffer, PropertyMacro* Property, TArray<UObject*>& AddToGen,
         bool ArrayDimProcessed = false, bool TreatAsRawFunction = false);
 
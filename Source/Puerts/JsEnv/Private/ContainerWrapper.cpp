@@ -8,9 +8,467 @@
 
 #include "ContainerWrapper.h"
 #include "PropertyTranslator.h"
+#include "DataTransfer.h"
+
+#include <type_traits>
 
 namespace PUERTS_NAMESPACE
 {
+// element kinds with a typed fast path, they map 1:1 to the JS TypedArray types
+enum class ETypedArrayKind : uint8
+{
+    None,
+    Int8,
+    Uint8,
+    Int16,
+    Uint16,
+    Int32,
+    Uint32,
+    Float32,
+    Float64,
+    BigInt64,
+    BigUint64
+};
+
+static ETypedArrayKind GetElementKind(PropertyMacro* Property)
+{
+    if (CastFieldMacro<FloatPropertyMacro>(Property))
+        return ETypedArrayKind::Float32;
+    if (CastFieldMacro<DoublePropertyMacro>(Property))
+        return ETypedArrayKind::Float64;
+    if (CastFieldMacro<IntPropertyMacro>(Property))
+        return ETypedArrayKind::Int32;
+    if (CastFieldMacro<UInt32PropertyMacro>(Property))
+        return ETypedArrayKind::Uint32;
+    if (CastFieldMacro<BytePropertyMacro>(Property))
+        return ETypedArrayKind::Uint8;
+    if (CastFieldMacro<Int8PropertyMacro>(Property))
+        return ETypedArrayKind::Int8;
+    if (CastFieldMacro<Int16PropertyMacro>(Property))
+        return ETypedArrayKind::Int16;
+    if (CastFieldMacro<UInt16PropertyMacro>(Property))
+        return ETypedArrayKind::Uint16;
+    if (CastFieldMacro<Int64PropertyMacro>(Property))
+        return ETypedArrayKind::BigInt64;
+    if (CastFieldMacro<UInt64PropertyMacro>(Property))
+        return ETypedArrayKind::BigUint64;
+    return ETypedArrayKind::None;
+}
+
+template <typename TDest, typename TSrc, bool FloatToInt = std::is_floating_point<TSrc>::value && std::is_integral<TDest>::value>
+struct TElementCast
+{
+    FORCEINLINE static TDest Cast(TSrc Value)
+    {
+        return static_cast<TDest>(Value);
+    }
+};
+
+// casting NaN or an out of range floating point value to an integer is undefined, saturate like Math.trunc + clamp
+template <typename TDest, typename TSrc>
+struct TElementCast<TDest, TSrc, true>
+{
+    FORCEINLINE static TDest Cast(TSrc Value)
+    {
+        if (Value != Value)
+        {
+            return 0;
+        }
+        if (Value <= static_cast<TSrc>(TNumericLimits<TDest>::Min()))
+        {
+            return TNumericLimits<TDest>::Min();
+        }
+        if (Value >= static_cast<TSrc>(TNumericLimits<TDest>::Max()))
+        {
+            return TNumericLimits<TDest>::Max();
+        }
+        return static_cast<TDest>(Value);
+    }
+};
+
+template <typename TDest, typename TSrc>
+FORCEINLINE static void ConvertElementsTyped(void* Dest, const void* Src, int32 Count)
+{
+    TDest* D = static_cast<TDest*>(Dest);
+    const TSrc* S = static_cast<const TSrc*>(Src);
+    for (int32 i = 0; i < Count; ++i)
+    {
+        D[i] = TElementCast<TDest, TSrc>::Cast(S[i]);
+    }
+}
+
+template <typename TDest>
+static void ConvertElementsFrom(void* Dest, const void* Src, ETypedArrayKind SrcKind, int32 Count)
+{
+    switch (SrcKind)
+    {
+        case ETypedArrayKind::Int8:
+            ConvertElementsTyped<TDest, int8>(Dest, Src, Count);
+            break;
+        case ETypedArrayKind::Uint8:
+            ConvertElementsTyped<TDest, uint8>(Dest, Src, Count);
+            break;
+        case ETypedArrayKind::Int16:
+            ConvertElementsTyped<TDest, int16>(Dest, Src, Count);
+            break;
+        case ETypedArrayKind::Uint16:
+            ConvertElementsTyped<TDest, uint16>(Dest, Src, Count);
+            break;
+        case ETypedArrayKind::Int32:
+            ConvertElementsTyped<TDest, int32>(Dest, Src, Count);
+            break;
+        case ETypedArrayKind::Uint32:
+            ConvertElementsTyped<TDest, uint32>(Dest, Src, Count);
+            break;
+        case ETypedArrayKind::Float32:
+            ConvertElementsTyped<TDest, float>(Dest, Src, Count);
+            break;
+        case ETypedArrayKind::Float64:
+            ConvertElementsTyped<TDest, double>(Dest, Src, Count);
+            break;
+        case ETypedArrayKind::BigInt64:
+            ConvertElementsTyped<TDest, int64>(Dest, Src, Count);
+            break;
+        case ETypedArrayKind::BigUint64:
+            ConvertElementsTyped<TDest, uint64>(Dest, Src, Count);
+            break;
+        default:
+            break;
+    }
+}
+
+static int32 GetKindSize(ETypedArrayKind Kind)
+{
+    switch (Kind)
+    {
+        case ETypedArrayKind::Int8:
+        case ETypedArrayKind::Uint8:
+            return 1;
+        case ETypedArrayKind::Int16:
+        case ETypedArrayKind::Uint16:
+            return 2;
+        case ETypedArrayKind::Int32:
+        case ETypedArrayKind::Uint32:
+        case ETypedArrayKind::Float32:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+static void ConvertElements(void* Dest, ETypedArrayKind DestKind, const void* Src, ETypedArrayKind SrcKind, int32 Count)
+{
+    if (DestKind == SrcKind)
+    {
+        FMemory::Memmove(Dest, Src, Count * GetKindSize(DestKind));
+        return;
+    }
+    switch (DestKind)
+    {
+        case ETypedArrayKind::Int8:
+            ConvertElementsFrom<int8>(Dest, Src, SrcKind, Count);
+            break;
+        case ETypedArrayKind::Uint8:
+            ConvertElementsFrom<uint8>(Dest, Src, SrcKind, Count);
+            break;
+        case ETypedArrayKind::Int16:
+            ConvertElementsFrom<int16>(Dest, Src, SrcKind, Count);
+            break;
+        case ETypedArrayKind::Uint16:
+            ConvertElementsFrom<uint16>(Dest, Src, SrcKind, Count);
+            break;
+        case ETypedArrayKind::Int32:
+            ConvertElementsFrom<int32>(Dest, Src, SrcKind, Count);
+            break;
+        case ETypedArrayKind::Uint32:
+            ConvertElementsFrom<uint32>(Dest, Src, SrcKind, Count);
+            break;
+        case ETypedArrayKind::Float32:
+            ConvertElementsFrom<float>(Dest, Src, SrcKind, Count);
+            break;
+        case ETypedArrayKind::Float64:
+            ConvertElementsFrom<double>(Dest, Src, SrcKind, Count);
+            break;
+        case ETypedArrayKind::BigInt64:
+            ConvertElementsFrom<int64>(Dest, Src, SrcKind, Count);
+            break;
+        case ETypedArrayKind::BigUint64:
+            ConvertElementsFrom<uint64>(Dest, Src, SrcKind, Count);
+            break;
+        default:
+            break;
+    }
+}
+
+// per element converter for the bulk FromJsArray/ToJsArray/FromObject natives: numeric, FString and FName elements are
+// read and written in place, anything else (or a value of an unexpected type) goes through the property translator
+class FBulkElementTranslator
+{
+public:
+    explicit FBulkElementTranslator(FPropertyTranslator* InTranslator)
+        : Translator(InTranslator), NumericKind(GetElementKind(InTranslator->Property)), FastPath(EFastPath::None)
+    {
+        PropertyMacro* Property = InTranslator->Property;
+        // 64 bit integers are BigInt on the JS side, the translator handles them
+        if (NumericKind != ETypedArrayKind::None && NumericKind != ETypedArrayKind::BigInt64 &&
+            NumericKind != ETypedArrayKind::BigUint64)
+        {
+            FastPath = EFastPath::Numeric;
+        }
+        else if (CastFieldMacro<StrPropertyMacro>(Property))
+        {
+            FastPath = EFastPath::String;
+        }
+        else if (CastFieldMacro<NamePropertyMacro>(Property))
+        {
+            FastPath = EFastPath::Name;
+        }
+    }
+
+    // Dest must be initialized
+    FORCEINLINE void JsToUE(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::Local<v8::Value>& Value, void* Dest)
+    {
+        switch (FastPath)
+        {
+            case EFastPath::Numeric:
+                if (Value->IsNumber())
+                {
+                    // same conversion as the property translators: ToInt32/ToUint32 for integers, so NaN, Infinity and
+                    // out of range numbers wrap exactly like they do on the per element path
+                    if (NumericKind == ETypedArrayKind::Float32 || NumericKind == ETypedArrayKind::Float64)
+                    {
+                        double Number = Value.As<v8::Number>()->Value();
+                        ConvertElements(Dest, NumericKind, &Number, ETypedArrayKind::Float64, 1);
+                    }
+                    else if (NumericKind == ETypedArrayKind::Uint32)
+                    {
+                        uint32 Number = Value->Uint32Value(Context).FromMaybe(0);
+                        ConvertElements(Dest, NumericKind, &Number, ETypedArrayKind::Uint32, 1);
+                    }
+                    else
+                    {
+                        int32 Number = Value->Int32Value(Context).FromMaybe(0);
+                        ConvertElements(Dest, NumericKind, &Number, ETypedArrayKind::Int32, 1);
+                    }
+                    return;
+                }
+                break;
+            case EFastPath::String:
+                if (Value->IsString())
+                {
+                    *static_cast<FString*>(Dest) = FV8Utils::ToFString(Isolate, Value);
+                    return;
+                }
+                break;
+            case EFastPath::Name:
+                if (Value->IsString())
+                {
+                    *static_cast<FName*>(Dest) = FV8Utils::ToFName(Isolate, Value);
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+        Translator->JsToUE(Isolate, Context, Value, Dest, false);
+    }
+
+    FORCEINLINE v8::Local<v8::Value> UEToJs(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const void* Src)
+    {
+        switch (FastPath)
+        {
+            case EFastPath::Numeric:
+            {
+                double Number;
+                ConvertElements(&Number, ETypedArrayKind::Float64, Src, NumericKind, 1);
+                return v8::Number::New(Isolate, Number);
+            }
+            case EFastPath::String:
+                return FV8Utils::ToV8String(Isolate, *static_cast<const FString*>(Src));
+            case EFastPath::Name:
+                return FV8Utils::ToV8String(Isolate, *static_cast<const FName*>(Src));
+            default:
+                return Translator->UEToJs(Isolate, Context, Src, false);
+        }
+    }
+
+private:
+    enum class EFastPath : uint8
+    {
+        None,
+        Numeric,
+        String,
+        Name
+    };
+
+    FPropertyTranslator* Translator;
+
+    ETypedArrayKind NumericKind;
+
+    EFastPath FastPath;
+};
+
+#ifndef WITH_QUICKJS
+static ETypedArrayKind GetTypedArrayKind(v8::Local<v8::Value> Value)
+{
+    if (Value->IsFloat32Array())
+        return ETypedArrayKind::Float32;
+    if (Value->IsFloat64Array())
+        return ETypedArrayKind::Float64;
+    if (Value->IsInt32Array())
+        return ETypedArrayKind::Int32;
+    if (Value->IsUint32Array())
+        return ETypedArrayKind::Uint32;
+    if (Value->IsUint8Array() || Value->IsUint8ClampedArray())
+        return ETypedArrayKind::Uint8;
+    if (Value->IsInt8Array())
+        return ETypedArrayKind::Int8;
+    if (Value->IsInt16Array())
+        return ETypedArrayKind::Int16;
+    if (Value->IsUint16Array())
+        return ETypedArrayKind::Uint16;
+    if (Value->IsBigInt64Array())
+        return ETypedArrayKind::BigInt64;
+    if (Value->IsBigUint64Array())
+        return ETypedArrayKind::BigUint64;
+    return ETypedArrayKind::None;
+}
+
+static v8::Local<v8::TypedArray> NewTypedArray(v8::Local<v8::ArrayBuffer> Buffer, ETypedArrayKind Kind, size_t Length)
+{
+    switch (Kind)
+    {
+        case ETypedArrayKind::Int8:
+            return v8::Int8Array::New(Buffer, 0, Length);
+        case ETypedArrayKind::Uint8:
+            return v8::Uint8Array::New(Buffer, 0, Length);
+        case ETypedArrayKind::Int16:
+            return v8::Int16Array::New(Buffer, 0, Length);
+        case ETypedArrayKind::Uint16:
+            return v8::Uint16Array::New(Buffer, 0, Length);
+        case ETypedArrayKind::Int32:
+            return v8::Int32Array::New(Buffer, 0, Length);
+        case ETypedArrayKind::Uint32:
+            return v8::Uint32Array::New(Buffer, 0, Length);
+        case ETypedArrayKind::Float32:
+            return v8::Float32Array::New(Buffer, 0, Length);
+        case ETypedArrayKind::Float64:
+            return v8::Float64Array::New(Buffer, 0, Length);
+        case ETypedArrayKind::BigInt64:
+            return v8::BigInt64Array::New(Buffer, 0, Length);
+        default:
+            return v8::BigUint64Array::New(Buffer, 0, Length);
+    }
+}
+
+FORCEINLINE static uint8* GetTypedArrayData(v8::Local<v8::TypedArray> TypedArray)
+{
+    return static_cast<uint8*>(DataTransfer::GetArrayBufferData(TypedArray->Buffer())) + TypedArray->ByteOffset();
+}
+
+// length of a TypedArray or plain array accepted by SetFromTypedArray, -1 for anything else
+static int32 GetNumericSourceLength(v8::Local<v8::Value> Source)
+{
+    if (Source->IsTypedArray() && GetTypedArrayKind(Source) != ETypedArrayKind::None)
+    {
+        return static_cast<int32>(Source.As<v8::TypedArray>()->Length());
+    }
+    if (Source->IsArray())
+    {
+        return static_cast<int32>(Source.As<v8::Array>()->Length());
+    }
+    return -1;
+}
+
+// a plain array source is converted into Staging before the destination is touched: its getters and valueOf run user
+// code that may resize the very container being written. A TypedArray is read directly, no js runs while copying it
+static bool StageNumericSource(
+    v8::Local<v8::Context> Context, v8::Local<v8::Value> Source, ETypedArrayKind DestKind, int32 Count, TArray<uint8>& Staging)
+{
+    if (Source->IsTypedArray())
+    {
+        return true;
+    }
+
+    v8::Local<v8::Array> Array = Source.As<v8::Array>();
+    const bool IsBigIntKind = DestKind == ETypedArrayKind::BigInt64 || DestKind == ETypedArrayKind::BigUint64;
+    const int32 ElementSize = GetKindSize(DestKind);
+    Staging.SetNumUninitialized(Count * ElementSize);
+    uint8* DestPtr = Staging.GetData();
+    for (int32 i = 0; i < Count; ++i)
+    {
+        v8::Local<v8::Value> Element;
+        if (!Array->Get(Context, i).ToLocal(&Element))
+        {
+            return false;
+        }
+        if (IsBigIntKind && Element->IsBigInt())
+        {
+            int64 Value = Element.As<v8::BigInt>()->Int64Value();
+            ConvertElements(DestPtr, DestKind, &Value, ETypedArrayKind::BigInt64, 1);
+        }
+        else
+        {
+            double Value = 0;
+            if (!Element->NumberValue(Context).To(&Value))
+            {
+                return false;
+            }
+            ConvertElements(DestPtr, DestKind, &Value, ETypedArrayKind::Float64, 1);
+        }
+        DestPtr += ElementSize;
+    }
+    return true;
+}
+
+static void CopyFromNumericSource(
+    v8::Local<v8::Value> Source, const TArray<uint8>& Staging, void* Dest, ETypedArrayKind DestKind, int32 Count)
+{
+    if (Source->IsTypedArray())
+    {
+        ConvertElements(Dest, DestKind, GetTypedArrayData(Source.As<v8::TypedArray>()), GetTypedArrayKind(Source), Count);
+    }
+    else if (Count > 0)
+    {
+        FMemory::Memcpy(Dest, Staging.GetData(), static_cast<SIZE_T>(Count) * GetKindSize(DestKind));
+    }
+}
+
+static void CopyToTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info, const uint8* Data, int32 Num, ETypedArrayKind Kind)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+    if (Info.Length() < 1 || !Info[0]->IsTypedArray() || GetTypedArrayKind(Info[0]) == ETypedArrayKind::None)
+    {
+        FV8Utils::ThrowException(Isolate, "numeric TypedArray expected");
+        return;
+    }
+    const int32 Start = Info.Length() > 1 ? Info[1]->Int32Value(Context).FromMaybe(0) : 0;
+    if (Start < 0 || Start > Num)
+    {
+        FV8Utils::ThrowException(Isolate, "invalid index");
+        return;
+    }
+    v8::Local<v8::TypedArray> Target = Info[0].As<v8::TypedArray>();
+    const int32 Count = FMath::Min(static_cast<int32>(Target->Length()), Num - Start);
+    ConvertElements(GetTypedArrayData(Target), GetTypedArrayKind(Target), Data + Start * GetKindSize(Kind), Kind, Count);
+    Info.GetReturnValue().Set(Count);
+}
+
+// the TypedArray owns a copy, an external buffer over container memory would dangle once the container reallocates or
+// its owner is collected, and neither can be observed from here
+static v8::Local<v8::TypedArray> NewTypedArrayCopy(v8::Isolate* Isolate, const void* Data, int32 Num, ETypedArrayKind Kind)
+{
+    const size_t ByteLength = static_cast<size_t>(Num) * GetKindSize(Kind);
+    v8::Local<v8::ArrayBuffer> Buffer = v8::ArrayBuffer::New(Isolate, ByteLength);
+    if (ByteLength > 0)
+    {
+        FMemory::Memcpy(DataTransfer::GetArrayBufferData(Buffer), Data, ByteLength);
+    }
+    return NewTypedArray(Buffer, Kind, Num);
+}
+#endif
+
 v8::Local<v8::FunctionTemplate> FScriptArrayWrapper::ToFunctionTemplate(v8::Isolate* Isolate)
 {
     v8::Isolate::Scope Isolatescope(Isolate);
@@ -28,6 +486,15 @@ v8::Local<v8::FunctionTemplate> FScriptArrayWrapper::ToFunctionTemplate(v8::Isol
     Result->PrototypeTemplate()->Set(
         FV8Utils::InternalString(Isolate, "IsValidIndex"), v8::FunctionTemplate::New(Isolate, IsValidIndex));
     Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Empty"), v8::FunctionTemplate::New(Isolate, Empty));
+    Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "FromJsArray"), v8::FunctionTemplate::New(Isolate, FromJsArray));
+    Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "ToJsArray"), v8::FunctionTemplate::New(Isolate, ToJsArray));
+#ifndef WITH_QUICKJS
+    Result->PrototypeTemplate()->Set(
+        FV8Utils::InternalString(Isolate, "ToTypedArray"), v8::FunctionTemplate::New(Isolate, ToTypedArray));
+    Result->PrototypeTemplate()->Set(
+        FV8Utils::InternalString(Isolate, "SetFromTypedArray"), v8::FunctionTemplate::New(Isolate, SetFromTypedArray));
+    Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "CopyTo"), v8::FunctionTemplate::New(Isolate, CopyTo));
+#endif
 
     return Result;
 }
@@ -204,6 +671,195 @@ void FScriptArrayWrapper::Empty(const v8::FunctionCallbackInfo<v8::Value>& Info)
     FScriptArrayEx::Empty(Self, Inner->Property);
 }
 
+void FScriptArrayWrapper::FromJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    CHECK_V8_ARGS_LEN(1);
+
+    auto Self = FV8Utils::GetPointerFast<FScriptArray>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+    if (!Info[0]->IsArray())
+    {
+        FV8Utils::ThrowException(Isolate, "Array expected");
+        return;
+    }
+
+    v8::Local<v8::Array> Source = Info[0].As<v8::Array>();
+    const int32 Count = static_cast<int32>(Source->Length());
+    const int32 ElementSize = GetSizeWithAlignment(Inner->Property);
+
+    FScriptArrayEx::Destruct(Self, Inner->Property, 0, Self->Num());
+    // one allocation for the final size instead of growing per element
+#if ENGINE_MAJOR_VERSION > 4
+    Self->Empty(Count, ElementSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+#else
+    Self->Empty(Count, ElementSize);
+#endif
+    AddUninitialized(Self, ElementSize, Count);
+    Construct(Self, Inner, 0, Count);
+
+    FBulkElementTranslator Translator(Inner);
+    for (int32 i = 0; i < Count; ++i)
+    {
+        v8::Local<v8::Value> Element;
+        if (!Source->Get(Context, i).ToLocal(&Element))
+        {
+            return;
+        }
+        // an accessor on the source may have touched this array, do not cache the data pointer
+        if (i >= Self->Num())
+        {
+            return;
+        }
+        Translator.JsToUE(Isolate, Context, Element, GetData(Self, ElementSize, i));
+    }
+}
+
+void FScriptArrayWrapper::ToJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    auto Self = FV8Utils::GetPointerFast<FScriptArray>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+
+    const int32 Num = Self->Num();
+    const int32 ElementSize = GetSizeWithAlignment(Inner->Property);
+    v8::Local<v8::Array> Result = v8::Array::New(Isolate, Num);
+    FBulkElementTranslator Translator(Inner);
+    for (int32 i = 0; i < Num; ++i)
+    {
+        (void) Result->Set(Context, i, Translator.UEToJs(Isolate, Context, GetData(Self, ElementSize, i)));
+    }
+    Info.GetReturnValue().Set(Result);
+}
+
+#ifndef WITH_QUICKJS
+void FScriptArrayWrapper::ToTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+
+    auto Self = FV8Utils::GetPointerFast<FScriptArray>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+    const ETypedArrayKind Kind = GetElementKind(Inner->Property);
+    if (Kind == ETypedArrayKind::None)
+    {
+        FV8Utils::ThrowException(Isolate, "element type is not numeric");
+        return;
+    }
+
+    Info.GetReturnValue().Set(NewTypedArrayCopy(Isolate, Self->GetData(), Self->Num(), Kind));
+}
+
+void FScriptArrayWrapper::SetFromTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    CHECK_V8_ARGS_LEN(1);
+
+    auto Self = FV8Utils::GetPointerFast<FScriptArray>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+    const ETypedArrayKind Kind = GetElementKind(Inner->Property);
+    if (Kind == ETypedArrayKind::None)
+    {
+        FV8Utils::ThrowException(Isolate, "element type is not numeric");
+        return;
+    }
+    const int32 NewNum = GetNumericSourceLength(Info[0]);
+    if (NewNum < 0)
+    {
+        FV8Utils::ThrowException(Isolate, "TypedArray or Array expected");
+        return;
+    }
+
+    v8::Local<v8::Value> Source = Info[0];
+    TArray<uint8> Staging;
+    if (!StageNumericSource(Context, Source, Kind, NewNum, Staging))
+    {
+        return;
+    }
+
+    const int32 ElementSize = GetKindSize(Kind);
+    const int32 OldNum = Self->Num();
+    const uint8* OldData = static_cast<const uint8*>(Self->GetData());
+    // a source over this very array (an external buffer made by native code) is freed by the resize, copy it out first
+    TArray<uint8> SourceCopy;
+    if (NewNum != OldNum && Source->IsTypedArray())
+    {
+        const uint8* SourceData = GetTypedArrayData(Source.As<v8::TypedArray>());
+        if (SourceData >= OldData && SourceData < OldData + OldNum * ElementSize)
+        {
+            const ETypedArrayKind SourceKind = GetTypedArrayKind(Source);
+            SourceCopy.Append(SourceData, NewNum * GetKindSize(SourceKind));
+            Source = NewTypedArrayCopy(Isolate, SourceCopy.GetData(), NewNum, SourceKind);
+        }
+    }
+
+    if (NewNum > OldNum)
+    {
+        AddUninitialized(Self, ElementSize, NewNum - OldNum);
+    }
+    else if (NewNum < OldNum)
+    {
+#if ENGINE_MAJOR_VERSION > 4
+        Self->Remove(NewNum, OldNum - NewNum, ElementSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+#else
+        Self->Remove(NewNum, OldNum - NewNum, ElementSize);
+#endif
+    }
+
+    CopyFromNumericSource(Source, Staging, Self->GetData(), Kind, NewNum);
+}
+
+void FScriptArrayWrapper::CopyTo(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+
+    auto Self = FV8Utils::GetPointerFast<FScriptArray>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+    const ETypedArrayKind Kind = GetElementKind(Inner->Property);
+    if (Kind == ETypedArrayKind::None)
+    {
+        FV8Utils::ThrowException(Isolate, "element type is not numeric");
+        return;
+    }
+    CopyToTypedArray(Info, static_cast<const uint8*>(Self->GetData()), Self->Num(), Kind);
+}
+#endif
+
 FORCEINLINE int32 FScriptArrayWrapper::AddUninitialized(FScriptArray* ScriptArray, int32 ElementSize, int32 Count)
 {
 #if ENGINE_MAJOR_VERSION > 4
@@ -283,6 +939,8 @@ v8::Local<v8::FunctionTemplate> FScriptSetWrapper::ToFunctionTemplate(v8::Isolat
     Result->PrototypeTemplate()->Set(
         FV8Utils::InternalString(Isolate, "IsValidIndex"), v8::FunctionTemplate::New(Isolate, IsValidIndex));
     Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Empty"), v8::FunctionTemplate::New(Isolate, Empty));
+    Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "FromJsArray"), v8::FunctionTemplate::New(Isolate, FromJsArray));
+    Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "ToJsArray"), v8::FunctionTemplate::New(Isolate, ToJsArray));
 
     return Result;
 }
@@ -453,6 +1111,88 @@ void FScriptSetWrapper::Empty(const v8::FunctionCallbackInfo<v8::Value>& Info)
     FScriptSetEx::Empty(Self, Inner->Property);
 }
 
+void FScriptSetWrapper::FromJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    CHECK_V8_ARGS_LEN(1);
+
+    auto Self = FV8Utils::GetPointerFast<FScriptSet>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+    if (!Info[0]->IsArray())
+    {
+        FV8Utils::ThrowException(Isolate, "Array expected");
+        return;
+    }
+    auto Property = Inner->Property;
+
+    v8::Local<v8::Array> Source = Info[0].As<v8::Array>();
+    const int32 Count = static_cast<int32>(Source->Length());
+    auto ScriptLayout = FScriptSet::GetScriptLayout(Property->GetSize(), Property->GetMinAlignment());
+    FScriptSetEx::Destruct(Self, Property, 0, Self->GetMaxIndex());
+    Self->Empty(Count, ScriptLayout);
+
+    // one conversion buffer for all elements
+    void* DataPtr = FMemory_Alloca(GetSizeWithAlignment(Property));
+    Property->InitializeValue(DataPtr);
+    FBulkElementTranslator Translator(Inner);
+    for (int32 i = 0; i < Count; ++i)
+    {
+        v8::Local<v8::Value> JsElement;
+        if (!Source->Get(Context, i).ToLocal(&JsElement))
+        {
+            break;
+        }
+        Translator.JsToUE(Isolate, Context, JsElement, DataPtr);
+        Self->Add(
+            DataPtr, ScriptLayout, [Property](const void* Element) { return Property->GetValueTypeHash(Element); },
+            [Property](const void* A, const void* B) { return Property->Identical(A, B); },
+            [Property, DataPtr](void* Element)
+            {
+                Property->InitializeValue(Element);
+                Property->CopySingleValue(Element, DataPtr);
+            },
+            [Property](void* Element) { Property->DestroyValue(Element); });
+    }
+    Property->DestroyValue(DataPtr);
+}
+
+void FScriptSetWrapper::ToJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    auto Self = FV8Utils::GetPointerFast<FScriptSet>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+    auto Property = Inner->Property;
+
+    auto ScriptLayout = FScriptSet::GetScriptLayout(Property->GetSize(), Property->GetMinAlignment());
+    v8::Local<v8::Array> Result = v8::Array::New(Isolate, Self->Num());
+    FBulkElementTranslator Translator(Inner);
+    const int32 MaxIndex = Self->GetMaxIndex();
+    for (int32 i = 0, Count = 0; i < MaxIndex; ++i)
+    {
+        if (Self->IsValidIndex(i))
+        {
+            (void) Result->Set(Context, Count++, Translator.UEToJs(Isolate, Context, Self->GetData(i, ScriptLayout)));
+        }
+    }
+    Info.GetReturnValue().Set(Result);
+}
+
 int32 FScriptSetWrapper::FindIndexInner(const v8::FunctionCallbackInfo<v8::Value>& Info)
 {
     v8::Isolate* Isolate = Info.GetIsolate();
@@ -501,6 +1241,8 @@ v8::Local<v8::FunctionTemplate> FScriptMapWrapper::ToFunctionTemplate(v8::Isolat
         FV8Utils::InternalString(Isolate, "IsValidIndex"), v8::FunctionTemplate::New(Isolate, IsValidIndex));
     Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "GetKey"), v8::FunctionTemplate::New(Isolate, GetKey));
     Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Empty"), v8::FunctionTemplate::New(Isolate, Empty));
+    Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "FromObject"), v8::FunctionTemplate::New(Isolate, FromObject));
+    Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "ToJsArray"), v8::FunctionTemplate::New(Isolate, ToJsArray));
 
     return Result;
 }
@@ -730,6 +1472,137 @@ void FScriptMapWrapper::Empty(const v8::FunctionCallbackInfo<v8::Value>& Info)
     FScriptMapEx::Empty(Self, KeyProperty, ValueProperty);
 }
 
+void FScriptMapWrapper::FromObject(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    CHECK_V8_ARGS_LEN(1);
+
+    auto Self = FV8Utils::GetPointerFast<FScriptMap>(Info.Holder(), 0);
+    auto KeyPropertyTranslator = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    auto KeyProperty = KeyPropertyTranslator->Property;
+    auto ValuePropertyTranslator = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 2);
+    auto ValueProperty = ValuePropertyTranslator->Property;
+    if (!KeyPropertyTranslator->IsPropertyValid() || !ValuePropertyTranslator->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "key/value info is invalid!");
+        return;
+    }
+    if (!Info[0]->IsObject())
+    {
+        FV8Utils::ThrowException(Isolate, "Object or Map expected");
+        return;
+    }
+
+    v8::Local<v8::Object> Source = Info[0].As<v8::Object>();
+    // a Map is read as flat [key0, value0, key1, value1...], a plain object by its own property names
+    v8::Local<v8::Array> Pairs;
+    v8::Local<v8::Array> Keys;
+    int32 Count = 0;
+#ifndef WITH_QUICKJS
+    if (Source->IsMap())
+    {
+        Pairs = Source.As<v8::Map>()->AsArray();
+        Count = static_cast<int32>(Pairs->Length() / 2);
+    }
+    else
+#endif
+    {
+        if (!Source->GetOwnPropertyNames(Context).ToLocal(&Keys))
+        {
+            return;
+        }
+        Count = static_cast<int32>(Keys->Length());
+    }
+
+    auto ScriptLayout = GetScriptLayout(KeyProperty, ValueProperty);
+    FScriptMapEx::Destruct(Self, KeyProperty, ValueProperty, 0, Self->GetMaxIndex());
+    Self->Empty(Count, ScriptLayout);
+
+    void* KeyPtr = FMemory_Alloca(GetSizeWithAlignment(KeyProperty));
+    KeyProperty->InitializeValue(KeyPtr);
+    void* ValuePtr = FMemory_Alloca(GetSizeWithAlignment(ValueProperty));
+    ValueProperty->InitializeValue(ValuePtr);
+
+    FBulkElementTranslator KeyTranslator(KeyPropertyTranslator);
+    FBulkElementTranslator ValueTranslator(ValuePropertyTranslator);
+    for (int32 i = 0; i < Count; ++i)
+    {
+        v8::Local<v8::Value> Key;
+        v8::Local<v8::Value> Value;
+        if (!Pairs.IsEmpty())
+        {
+            if (!Pairs->Get(Context, i * 2).ToLocal(&Key) || !Pairs->Get(Context, i * 2 + 1).ToLocal(&Value))
+            {
+                break;
+            }
+        }
+        else if (!Keys->Get(Context, i).ToLocal(&Key) || !Source->Get(Context, Key).ToLocal(&Value))
+        {
+            break;
+        }
+        KeyTranslator.JsToUE(Isolate, Context, Key, KeyPtr);
+        ValueTranslator.JsToUE(Isolate, Context, Value, ValuePtr);
+
+        Self->Add(
+            KeyPtr, ValuePtr, ScriptLayout, [KeyProperty](const void* ElementKey) { return KeyProperty->GetValueTypeHash(ElementKey); },
+            [KeyProperty](const void* A, const void* B) { return KeyProperty->Identical(A, B); },
+            [KeyProperty, KeyPtr](void* NewElementKey)
+            {
+                KeyProperty->InitializeValue(NewElementKey);
+                KeyProperty->CopySingleValue(NewElementKey, KeyPtr);
+            },
+            [ValueProperty, ValuePtr](void* NewElementValue)
+            {
+                ValueProperty->InitializeValue(NewElementValue);
+                ValueProperty->CopySingleValue(NewElementValue, ValuePtr);
+            },
+            [ValueProperty, ValuePtr](void* ExistingElementValue) { ValueProperty->CopySingleValue(ExistingElementValue, ValuePtr); },
+            [KeyProperty](void* ElementKey) { KeyProperty->DestroyValue(ElementKey); },
+            [ValueProperty](void* ElementValue) { ValueProperty->DestroyValue(ElementValue); });
+    }
+    KeyProperty->DestroyValue(KeyPtr);
+    ValueProperty->DestroyValue(ValuePtr);
+}
+
+void FScriptMapWrapper::ToJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    auto Self = FV8Utils::GetPointerFast<FScriptMap>(Info.Holder(), 0);
+    auto KeyPropertyTranslator = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    auto KeyProperty = KeyPropertyTranslator->Property;
+    auto ValuePropertyTranslator = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 2);
+    auto ValueProperty = ValuePropertyTranslator->Property;
+    if (!KeyPropertyTranslator->IsPropertyValid() || !ValuePropertyTranslator->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "key/value info is invalid!");
+        return;
+    }
+
+    auto ScriptLayout = GetScriptLayout(KeyProperty, ValueProperty);
+    v8::Local<v8::Array> Result = v8::Array::New(Isolate, Self->Num());
+    FBulkElementTranslator KeyTranslator(KeyPropertyTranslator);
+    FBulkElementTranslator ValueTranslator(ValuePropertyTranslator);
+    const int32 MaxIndex = Self->GetMaxIndex();
+    for (int32 i = 0, Count = 0; i < MaxIndex; ++i)
+    {
+        if (Self->IsValidIndex(i))
+        {
+            uint8* Data = static_cast<uint8*>(Self->GetData(i, ScriptLayout));
+            v8::Local<v8::Array> Pair = v8::Array::New(Isolate, 2);
+            (void) Pair->Set(Context, 0, KeyTranslator.UEToJs(Isolate, Context, Data + GetKeyOffset(ScriptLayout)));
+            (void) Pair->Set(Context, 1, ValueTranslator.UEToJs(Isolate, Context, Data + ScriptLayout.ValueOffset));
+            (void) Result->Set(Context, Count++, Pair);
+        }
+    }
+    Info.GetReturnValue().Set(Result);
+}
+
 FScriptMapLayout FScriptMapWrapper::GetScriptLayout(const PropertyMacro* KeyProperty, const PropertyMacro* ValueProperty)
 {
     return FScriptMap::GetScriptLayout(
@@ -747,6 +1620,13 @@ v8::Local<v8::FunctionTemplate> FFixSizeArrayWrapper::ToFunctionTemplate(v8::Iso
     Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Get"), v8::FunctionTemplate::New(Isolate, Get));
     Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "GetRef"), v8::FunctionTemplate::New(Isolate, GetRef));
     Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Set"), v8::FunctionTemplate::New(Isolate, Set));
+#ifndef WITH_QUICKJS
+    Result->PrototypeTemplate()->Set(
+        FV8Utils::InternalString(Isolate, "ToTypedArray"), v8::FunctionTemplate::New(Isolate, ToTypedArray));
+    Result->PrototypeTemplate()->Set(
+        FV8Utils::InternalString(Isolate, "SetFromTypedArray"), v8::FunctionTemplate::New(Isolate, SetFromTypedArray));
+    Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "CopyTo"), v8::FunctionTemplate::New(Isolate, CopyTo));
+#endif
     // Result->PrototypeTemplate()->SetIndexedPropertyHandler(Getter, Setter);
 
     return Result;
@@ -847,4 +1727,85 @@ void FFixSizeArrayWrapper::Set(const v8::FunctionCallbackInfo<v8::Value>& Info)
 
     Inner->JsToUE(Isolate, Context, Info[1], Ptr, true);
 }
+
+#ifndef WITH_QUICKJS
+void FFixSizeArrayWrapper::ToTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+
+    auto Self = FV8Utils::GetPointerFast<uint8>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+    const ETypedArrayKind Kind = GetElementKind(Inner->Property);
+    if (Kind == ETypedArrayKind::None)
+    {
+        FV8Utils::ThrowException(Isolate, "element type is not numeric");
+        return;
+    }
+
+    Info.GetReturnValue().Set(NewTypedArrayCopy(Isolate, Self, Inner->Property->ArrayDim, Kind));
+}
+
+void FFixSizeArrayWrapper::SetFromTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    CHECK_V8_ARGS_LEN(1);
+
+    auto Self = FV8Utils::GetPointerFast<uint8>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+    const ETypedArrayKind Kind = GetElementKind(Inner->Property);
+    if (Kind == ETypedArrayKind::None)
+    {
+        FV8Utils::ThrowException(Isolate, "element type is not numeric");
+        return;
+    }
+    const int32 Length = GetNumericSourceLength(Info[0]);
+    if (Length < 0)
+    {
+        FV8Utils::ThrowException(Isolate, "TypedArray or Array expected");
+        return;
+    }
+
+    const int32 Count = FMath::Min(Length, Inner->Property->ArrayDim);
+    TArray<uint8> Staging;
+    if (StageNumericSource(Context, Info[0], Kind, Count, Staging))
+    {
+        CopyFromNumericSource(Info[0], Staging, Self, Kind, Count);
+    }
+}
+
+void FFixSizeArrayWrapper::CopyTo(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::HandleScope HandleScope(Isolate);
+
+    auto Self = FV8Utils::GetPointerFast<uint8>(Info.Holder(), 0);
+    auto Inner = FV8Utils::GetPointerFast<FPropertyTranslator>(Info.Holder(), 1);
+    if (!Inner->IsPropertyValid())
+    {
+        FV8Utils::ThrowException(Isolate, "item info is invalid!");
+        return;
+    }
+    const ETypedArrayKind Kind = GetElementKind(Inner->Property);
+    if (Kind == ETypedArrayKind::None)
+    {
+        FV8Utils::ThrowException(Isolate, "element type is not numeric");
+        return;
+    }
+    CopyToTypedArray(Info, Self, Inner->Property->ArrayDim, Kind);
+}
+#endif
 }    // namespace PUERTS_NAMESPACE
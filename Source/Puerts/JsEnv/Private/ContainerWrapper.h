@@ -325,6 +325,33 @@ private:
     // 作用：清空容器
     static void Empty(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
+    // 参数：js数组
+    // 返回：无
+    // 作用：用js数组替换容器内容，一次分配好内存，数值、FString、FName元素不经过通用的PropertyTranslator
+    static void FromJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：无
+    // 返回：js数组（值类型，有内存拷贝）
+    // 作用：一次调用把整个容器转换为js数组
+    static void ToJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+#ifndef WITH_QUICKJS
+    // 参数：无
+    // 返回：Float32Array/Int32Array/Uint8Array...
+    // 作用：一次拷贝出数值类型数组的全部元素。返回的TypedArray持有自己的内存，不随TArray变化，修改后用SetFromTypedArray写回
+    static void ToTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：TypedArray或者数字数组
+    // 返回：无
+    // 作用：把容器长度设为参数长度并整体拷贝，元素类型一致时直接memcpy
+    static void SetFromTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数1：目标TypedArray；参数2（可选）：容器中的起始索引
+    // 返回：拷贝的元素个数
+    // 作用：批量拷贝到目标TypedArray
+    static void CopyTo(const v8::FunctionCallbackInfo<v8::Value>& Info);
+#endif
+
     FORCEINLINE static int32 AddUninitialized(FScriptArray* ScriptArray, int32 ElementSize, int32 Count = 1);
 
     FORCEINLINE static uint8* GetData(FScriptArray* ScriptArray, int32 ElementSize, int32 Index);
@@ -360,6 +387,15 @@ private:
 
     static void Empty(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
+    // 参数：js数组
+    // 返回：无
+    // 作用：用js数组替换集合内容，重复元素只保留一个
+    static void FromJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：无
+    // 返回：js数组（值类型，有内存拷贝）
+    static void ToJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
     FORCEINLINE static int32 FindIndexInner(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
     FORCEINLINE static void InternalGet(const v8::FunctionCallbackInfo<v8::Value>& Info, bool PassByPointer);
@@ -389,6 +425,15 @@ private:
 
     static void Empty(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
+    // 参数：普通js对象（自身属性名作为key）或者js Map
+    // 返回：无
+    // 作用：用参数的键值对替换容器内容
+    static void FromObject(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：无
+    // 返回：[key, value]数组构成的js数组，可以直接传给new Map()
+    static void ToJsArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
     FORCEINLINE static FScriptMapLayout GetScriptLayout(const PropertyMacro* KeyProperty, const PropertyMacro* ValueProperty);
 
     FORCEINLINE static void InternalGet(const v8::FunctionCallbackInfo<v8::Value>& Info, bool PassByPointer);
@@ -412,6 +457,15 @@ private:
 
     static void Set(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
+#ifndef WITH_QUICKJS
+    // 同FScriptArrayWrapper
+    static void ToTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void SetFromTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void CopyTo(const v8::FunctionCallbackInfo<v8::Value>& Info);
+#endif
+
     FORCEINLINE static void InternalGet(const v8::FunctionCallbackInfo<v8::Value>& Info, bool PassByPointer);
 };
 }    // namespace PUERTS_NAMESPACE
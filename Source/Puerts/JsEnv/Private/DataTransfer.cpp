@@ -10,6 +10,7 @@
 #include "ObjectMapper.h"
 #if USING_IN_UNREAL_ENGINE
 #include "V8Utils.h"
+#include "StructWrapper.h"
 #endif
 
 namespace PUERTS_NAMESPACE
@@ -65,6 +66,11 @@ v8::Local<v8::Value> DataTransfer::FindOrAddStruct(
     return FV8Utils::IsolateData<IObjectMapper>(Isolate)->FindOrAddStruct(Isolate, Context, ScriptStruct, Ptr, PassByPointer);
 }
 
+void* DataTransfer::NewStruct(UScriptStruct* ScriptStruct)
+{
+    return FScriptStructWrapper::Alloc(ScriptStruct);
+}
+
 bool DataTransfer::IsInstanceOf(v8::Isolate* Isolate, UStruct* Struct, v8::Local<v8::Value> JsObject)
 {
     return JsObject->IsObject() && FV8Utils::IsolateData<IObjectMapper>(Isolate)->IsInstanceOf(Struct, JsObject.As<v8::Object>());
@@ -11,6 +11,19 @@
 #include "Misc/FileHelper.h"
 #include "Algo/Reverse.h"
 #include "Runtime/Launch/Resources/Version.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/IConsoleManager.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "JSLogger.h"
+#include "ScriptArchive.h"
+#if WITH_EDITOR
+#include "IDirectoryWatcher.h"
+#include "DirectoryWatcherModule.h"
+#include "Modules/ModuleManager.h"
+#endif
 
 #if (ENGINE_MAJOR_VERSION >= 5)
 #include "HAL/PlatformFileManager.h"
@@ -52,10 +65,72 @@ static FString PathNormalize(const FString& PathIn)
     }
 }
 
+static const TCHAR* ResolveManifestName = TEXT("ModuleResolveManifest.json");
+
+static const TCHAR* ContentDirToken = TEXT("{Content}/");
+
+static TSet<DefaultJSModuleLoader*> LiveLoaders;
+
+static FCriticalSection LiveLoadersCritical;
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommand SaveResolveManifestCommand(TEXT("Puerts.SaveModuleResolveManifest"),
+    TEXT("Save the require() resolutions of all module loaders, ship the generated file to skip module probing"),
+    FConsoleCommandDelegate::CreateLambda(
+        []()
+        {
+            FScopeLock ScopeLock(&LiveLoadersCritical);
+            for (DefaultJSModuleLoader* Loader : LiveLoaders)
+            {
+                Loader->SaveResolveManifest();
+            }
+        }));
+#endif
+
+// the manifest is written on the development machine and read on device, keep the paths relative to the content dir
+static FString TokenizeContentDir(const FString& Path, const FString& ContentDir)
+{
+    return Path.StartsWith(ContentDir) ? ContentDirToken + Path.Mid(ContentDir.Len()) : Path;
+}
+
+static FString DetokenizeContentDir(const FString& Path, const FString& ContentDir)
+{
+    return Path.StartsWith(ContentDirToken) ? ContentDir + Path.Mid(FCString::Strlen(ContentDirToken)) : Path;
+}
+
+DefaultJSModuleLoader::DefaultJSModuleLoader(const FString& InScriptRoot) : ScriptRoot(InScriptRoot)
+{
+    {
+        FScopeLock ScopeLock(&LiveLoadersCritical);
+        LiveLoaders.Add(this);
+    }
+#if !WITH_EDITOR
+    LoadResolveManifest();
+#endif
+}
+
+DefaultJSModuleLoader::~DefaultJSModuleLoader()
+{
+    {
+        FScopeLock ScopeLock(&LiveLoadersCritical);
+        LiveLoaders.Remove(this);
+    }
+#if WITH_EDITOR
+    UnwatchScriptRoots();
+#endif
+}
+
 bool DefaultJSModuleLoader::CheckExists(const FString& PathIn, FString& Path, FString& AbsolutePath)
 {
     IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
     FString NormalizedPath = PathNormalize(PathIn);
+    const FScriptArchive& Archive = FScriptArchive::Get();
+    if (Archive.Find(NormalizedPath))
+    {
+        AbsolutePath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*NormalizedPath);
+        Path = NormalizedPath;
+        return true;
+    }
     if (PlatformFile.FileExists(*NormalizedPath))
     {
         AbsolutePath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*NormalizedPath);
@@ -95,6 +170,45 @@ bool DefaultJSModuleLoader::SearchModuleWithExtInDir(
 }
 
 bool DefaultJSModuleLoader::Search(const FString& RequiredDir, const FString& RequiredModule, FString& Path, FString& AbsolutePath)
+{
+    if (!EnableSearchCache)
+    {
+        return SearchWithoutCache(RequiredDir, RequiredModule, Path, AbsolutePath);
+    }
+
+    const FString Key = RequiredDir + TEXT("|") + RequiredModule;
+    {
+        FScopeLock ScopeLock(&SearchCacheCritical);
+        if (const FResolvedModule* Cached = SearchCache.Find(Key))
+        {
+            if (Cached->Found)
+            {
+                Path = Cached->Path;
+                AbsolutePath = Cached->AbsolutePath;
+            }
+            return Cached->Found;
+        }
+    }
+
+    FResolvedModule Resolved;
+    const bool Found = SearchWithoutCache(RequiredDir, RequiredModule, Resolved.Path, Resolved.AbsolutePath);
+    Resolved.Found = Found;
+    if (Found)
+    {
+        Path = Resolved.Path;
+        AbsolutePath = Resolved.AbsolutePath;
+    }
+
+#if WITH_EDITOR
+    WatchScriptRoots();
+#endif
+    FScopeLock ScopeLock(&SearchCacheCritical);
+    SearchCache.Add(Key, MoveTemp(Resolved));
+    return Found;
+}
+
+bool DefaultJSModuleLoader::SearchWithoutCache(
+    const FString& RequiredDir, const FString& RequiredModule, FString& Path, FString& AbsolutePath)
 {
     if (SearchModuleInDir(RequiredDir, RequiredModule, Path, AbsolutePath))
     {
@@ -127,6 +241,14 @@ bool DefaultJSModuleLoader::Search(const FString& RequiredDir, const FString& Re
 
 bool DefaultJSModuleLoader::Load(const FString& Path, TArray<uint8>& Content)
 {
+    const FScriptArchive& Archive = FScriptArchive::Get();
+    if (const FScriptArchive::FEntry* Entry = Archive.Find(Path))
+    {
+        Content.Reset((int32) Entry->Size + 2);
+        Content.Append(Archive.GetData(*Entry), (int32) Entry->Size);
+        return true;
+    }
+
     // return (FPaths::FileExists(FullPath) && FFileHelper::LoadFileToString(Content, *FullPath));
     IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
     IFileHandle* FileHandle = PlatformFile.OpenRead(*Path);
@@ -143,9 +265,172 @@ bool DefaultJSModuleLoader::Load(const FString& Path, TArray<uint8>& Content)
     return false;
 }
 
+bool DefaultJSModuleLoader::LoadView(const FString& Path, FModuleContentView& View)
+{
+    const FScriptArchive& Archive = FScriptArchive::Get();
+    const FScriptArchive::FEntry* Entry = Archive.Find(Path);
+    if (!Entry)
+    {
+        return false;
+    }
+    View.Data = Archive.GetData(*Entry);
+    View.Size = (int32) Entry->Size;
+    View.OneByte = (Entry->Flags & FScriptArchive::EF_OneByte) != 0;
+    View.CodeCache = Archive.GetCodeCache(*Entry);
+    View.CodeCacheSize = (int32) Entry->CodeCacheSize;
+    return true;
+}
+
 FString& DefaultJSModuleLoader::GetScriptRoot()
 {
     return ScriptRoot;
 }
 
+void DefaultJSModuleLoader::InvalidateSearchCache()
+{
+    FScopeLock ScopeLock(&SearchCacheCritical);
+    SearchCache.Empty();
+}
+
+FString DefaultJSModuleLoader::GetResolveManifestPath() const
+{
+    return FPaths::ProjectContentDir() / ScriptRoot / ResolveManifestName;
+}
+
+bool DefaultJSModuleLoader::SaveResolveManifest()
+{
+    const FString ContentDir = PathNormalize(FPaths::ProjectContentDir()) + TEXT("/");
+    TSharedRef<FJsonObject> Modules = MakeShared<FJsonObject>();
+    {
+        FScopeLock ScopeLock(&SearchCacheCritical);
+        for (auto& KV : SearchCache)
+        {
+            FString RequiredDir;
+            FString RequiredModule;
+            KV.Key.Split(TEXT("|"), &RequiredDir, &RequiredModule);
+            const FString Key = TokenizeContentDir(RequiredDir, ContentDir) + TEXT("|") + RequiredModule;
+            if (KV.Value.Found)
+            {
+                Modules->SetStringField(Key, TokenizeContentDir(KV.Value.Path, ContentDir));
+            }
+            else
+            {
+                Modules->SetField(Key, MakeShared<FJsonValueNull>());
+            }
+        }
+    }
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetObjectField(TEXT("modules"), Modules);
+
+    FString Output;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+    FJsonSerializer::Serialize(Root, Writer);
+
+    const FString ManifestPath = GetResolveManifestPath();
+    if (!FFileHelper::SaveStringToFile(Output, *ManifestPath))
+    {
+        UE_LOG(Puerts, Error, TEXT("save module resolve manifest to %s fail"), *ManifestPath);
+        return false;
+    }
+    UE_LOG(Puerts, Log, TEXT("%d module resolutions saved to %s"), Modules->Values.Num(), *ManifestPath);
+    return true;
+}
+
+void DefaultJSModuleLoader::LoadResolveManifest()
+{
+    FString Input;
+    if (!FFileHelper::LoadFileToString(Input, *GetResolveManifestPath()))
+    {
+        return;
+    }
+
+    TSharedPtr<FJsonObject> Root;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Input);
+    const TSharedPtr<FJsonObject>* Modules = nullptr;
+    if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || !Root->TryGetObjectField(TEXT("modules"), Modules))
+    {
+        UE_LOG(Puerts, Warning, TEXT("invalid module resolve manifest: %s"), *GetResolveManifestPath());
+        return;
+    }
+
+    const FString ContentDir = PathNormalize(FPaths::ProjectContentDir()) + TEXT("/");
+    FScopeLock ScopeLock(&SearchCacheCritical);
+    for (auto& KV : (*Modules)->Values)
+    {
+        FString RequiredDir;
+        FString RequiredModule;
+        KV.Key.Split(TEXT("|"), &RequiredDir, &RequiredModule);
+
+        FResolvedModule Resolved;
+        Resolved.Found = KV.Value.IsValid() && KV.Value->Type == EJson::String;
+        if (Resolved.Found)
+        {
+            Resolved.Path = DetokenizeContentDir(KV.Value->AsString(), ContentDir);
+            Resolved.AbsolutePath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*Resolved.Path);
+        }
+        SearchCache.Add(DetokenizeContentDir(RequiredDir, ContentDir) + TEXT("|") + RequiredModule, MoveTemp(Resolved));
+    }
+}
+
+#if WITH_EDITOR
+void DefaultJSModuleLoader::WatchScriptRoots()
+{
+    if (WatchedRoots.Num() > 0)
+    {
+        return;
+    }
+
+    TArray<FString> Roots;
+    Roots.Add(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir() / ScriptRoot));
+    Roots.AddUnique(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir() / TEXT("JavaScript")));
+
+    FDirectoryWatcherModule& DirectoryWatcherModule =
+        FModuleManager::Get().LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+    IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+    if (!DirectoryWatcher)
+    {
+        return;
+    }
+    for (const FString& Root : Roots)
+    {
+        if (WatchedRoots.Contains(Root) || !FPaths::DirectoryExists(Root))
+        {
+            continue;
+        }
+        FDelegateHandle DelegateHandle;
+        // content changes do not affect resolution, only files and directories coming and going do
+        DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(Root,
+            IDirectoryWatcher::FDirectoryChanged::CreateLambda(
+                [this](const TArray<FFileChangeData>& FileChanges)
+                {
+                    for (const FFileChangeData& Change : FileChanges)
+                    {
+                        if (Change.Action != FFileChangeData::FCA_Modified)
+                        {
+                            InvalidateSearchCache();
+                            return;
+                        }
+                    }
+                }),
+            DelegateHandle, IDirectoryWatcher::IncludeDirectoryChanges);
+        WatchedRoots.Emplace(Root, DelegateHandle);
+    }
+}
+
+void DefaultJSModuleLoader::UnwatchScriptRoots()
+{
+    FDirectoryWatcherModule* DirectoryWatcherModule =
+        FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+    if (DirectoryWatcherModule && DirectoryWatcherModule->Get())
+    {
+        for (auto& KV : WatchedRoots)
+        {
+            DirectoryWatcherModule->Get()->UnregisterDirectoryChangedCallback_Handle(KV.Key, KV.Value);
+        }
+    }
+    WatchedRoots.Empty();
+}
+#endif
+
 }    // namespace PUERTS_NAMESPACE
@@ -8,6 +8,7 @@
 
 #include "FunctionTranslator.h"
 #include "V8Utils.h"
+#include "JsEnvTrace.h"
 #include "Misc/DefaultValueHelper.h"
 #include <mutex>
 
@@ -263,6 +264,7 @@ void FFunctionTranslator::Call(
 #endif
 
     auto CallFunctionPtr = CallFunction.Get();
+    PUERTS_TRACE_SCOPE_CACHED(TraceSpecId, CallFunctionPtr->GetOuter()->GetName() + TEXT(".") + CallFunctionPtr->GetName());
     if ((Function->FunctionFlags & FUNC_Native) && !(Function->FunctionFlags & FUNC_Net) &&
         !CallFunctionPtr->HasAnyFunctionFlags(FUNC_UbergraphFunction))
     {
@@ -277,6 +279,7 @@ void FFunctionTranslator::Call(
 void FFunctionTranslator::SlowCall(v8::Isolate* Isolate, v8::Local<v8::Context>& Context,
     const v8::FunctionCallbackInfo<v8::Value>& Info, UObject* CallObject, UFunction* CallFunction, void* Params)
 {
+    PUERTS_TRACE_SCOPE(PuertsSlowCall);
     if (Params)
     {
         FMemory::Memzero(Params, ParamsBufferSize);
@@ -295,6 +298,7 @@ void FFunctionTranslator::SlowCall(v8::Isolate* Isolate, v8::Local<v8::Context>&
 void FFunctionTranslator::FastCall(v8::Isolate* Isolate, v8::Local<v8::Context>& Context,
     const v8::FunctionCallbackInfo<v8::Value>& Info, UObject* CallObject, UFunction* CallFunction, void* Params)
 {
+    PUERTS_TRACE_SCOPE(PuertsFastCall);
     if (Params)
     {
         FMemory::Memzero(Params, ParamsBufferSize);
@@ -114,6 +114,9 @@ protected:
     uint32 ParamsBufferSize;
 
     void* ArgumentDefaultValues;
+
+    // insights event type of calls through this translator, see JsEnvTrace.h
+    uint32 TraceSpecId = 0;
 #if WITH_EDITOR
     FName FunctionName;
 #endif
@@ -100,4 +100,30 @@ void FJsEnv::ForceReloadJsFile(const FString& ModuleName)
 {
     GameScript->ForceReloadJsFile(ModuleName);
 }
+
+void FJsEnv::GetLoadStats(FJsEnvLoadStats& OutStats)
+{
+    GameScript->GetLoadStats(OutStats);
+}
+
+void FJsEnv::SetHeapLimits(const FJsEnvHeapLimits& Limits)
+{
+    GameScript->SetHeapLimits(Limits);
+}
+
+bool FJsEnv::StartCpuProfiling(int32 SamplingIntervalUs, bool bFrameStats)
+{
+    return GameScript->StartCpuProfiling(SamplingIntervalUs, bFrameStats);
+}
+
+bool FJsEnv::StopCpuProfiling(const FString& OutBasePath)
+{
+    return GameScript->StopCpuProfiling(OutBasePath);
+}
+
+FSimpleMulticastDelegate& FJsEnv::OnWaitForScriptFiles()
+{
+    static FSimpleMulticastDelegate Delegate;
+    return Delegate;
+}
 }    // namespace PUERTS_NAMESPACE
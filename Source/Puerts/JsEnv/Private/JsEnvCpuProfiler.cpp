@@ -0,0 +1,331 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#include "JsEnvCpuProfiler.h"
+
+#ifndef WITH_QUICKJS
+
+#include "JsEnvStats.h"
+#include "JSLogger.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("JS Sampled Time (ms)"), STAT_PuertsJsSampledMs, STATGROUP_Puerts);
+
+CSV_DEFINE_CATEGORY(PuertsJS, true);
+
+TRACE_DECLARE_FLOAT_COUNTER(PuertsJsSampledMs, TEXT("Puerts/JsSampledMsPerFrame"));
+
+namespace PUERTS_NAMESPACE
+{
+static const char* SessionTitle = "puerts-session";
+
+// hottest functions of a frame reported to the csv profiler
+static constexpr int32 FrameHotFunctionNum = 5;
+
+static FString EscapeJson(const FString& In)
+{
+    FString Out;
+    Out.Reserve(In.Len());
+    for (TCHAR Char : In)
+    {
+        switch (Char)
+        {
+            case TEXT('"'):
+                Out += TEXT("\\\"");
+                break;
+            case TEXT('\\'):
+                Out += TEXT("\\\\");
+                break;
+            case TEXT('\n'):
+                Out += TEXT("\\n");
+                break;
+            case TEXT('\r'):
+                Out += TEXT("\\r");
+                break;
+            case TEXT('\t'):
+                Out += TEXT("\\t");
+                break;
+            default:
+                if (Char < 0x20)
+                {
+                    Out += FString::Printf(TEXT("\\u%04x"), (uint32) Char);
+                }
+                else
+                {
+                    Out.AppendChar(Char);
+                }
+        }
+    }
+    return Out;
+}
+
+static FString GetFunctionName(const v8::CpuProfileNode* Node)
+{
+    const FString Name = UTF8_TO_TCHAR(Node->GetFunctionNameStr());
+    return Name.IsEmpty() ? FString(TEXT("(anonymous)")) : Name;
+}
+
+// (program) and (idle) are samples taken while no js was running
+static bool IsScriptNode(const v8::CpuProfileNode* Node)
+{
+    const char* Name = Node->GetFunctionNameStr();
+    return FCStringAnsi::Strcmp(Name, "(root)") != 0 && FCStringAnsi::Strcmp(Name, "(program)") != 0 &&
+           FCStringAnsi::Strcmp(Name, "(idle)") != 0;
+}
+
+static FString GetFrameLabel(const v8::CpuProfileNode* Node)
+{
+    const FString Url = UTF8_TO_TCHAR(Node->GetScriptResourceNameStr());
+    FString Label = Url.IsEmpty()
+                        ? GetFunctionName(Node)
+                        : FString::Printf(TEXT("%s %s:%d"), *GetFunctionName(Node), *FPaths::GetCleanFilename(Url), Node->GetLineNumber());
+    // ; separates frames and , separates csv columns
+    Label.ReplaceCharInline(TEXT(';'), TEXT(':'));
+    Label.ReplaceCharInline(TEXT(','), TEXT(' '));
+    return Label;
+}
+
+// chrome devtools .cpuprofile layout, line and column numbers are 0 based there
+static FString ToCpuProfileJson(const v8::CpuProfile* Profile)
+{
+    FString Json = TEXT("{\"nodes\":[");
+    TArray<const v8::CpuProfileNode*> Pending;
+    Pending.Add(Profile->GetTopDownRoot());
+    bool bFirst = true;
+    while (Pending.Num() > 0)
+    {
+        const v8::CpuProfileNode* Node = Pending.Pop(false);
+        if (!bFirst)
+        {
+            Json += TEXT(",");
+        }
+        bFirst = false;
+
+        Json += FString::Printf(TEXT("{\"id\":%u,\"callFrame\":{\"functionName\":\"%s\",\"scriptId\":\"%d\",\"url\":\"%s\","
+                                     "\"lineNumber\":%d,\"columnNumber\":%d},\"hitCount\":%u,\"children\":["),
+            Node->GetNodeId(), *EscapeJson(UTF8_TO_TCHAR(Node->GetFunctionNameStr())), Node->GetScriptId(),
+            *EscapeJson(UTF8_TO_TCHAR(Node->GetScriptResourceNameStr())), Node->GetLineNumber() - 1, Node->GetColumnNumber() - 1,
+            Node->GetHitCount());
+        const int32 ChildrenCount = Node->GetChildrenCount();
+        for (int32 i = 0; i < ChildrenCount; ++i)
+        {
+            const v8::CpuProfileNode* Child = Node->GetChild(i);
+            Json += FString::Printf(i == 0 ? TEXT("%u") : TEXT(",%u"), Child->GetNodeId());
+            Pending.Add(Child);
+        }
+        Json += TEXT("]}");
+    }
+
+    Json += FString::Printf(TEXT("],\"startTime\":%lld,\"endTime\":%lld,\"samples\":["), (long long) Profile->GetStartTime(),
+        (long long) Profile->GetEndTime());
+    const int32 SamplesCount = Profile->GetSamplesCount();
+    for (int32 i = 0; i < SamplesCount; ++i)
+    {
+        Json += FString::Printf(i == 0 ? TEXT("%u") : TEXT(",%u"), Profile->GetSample(i)->GetNodeId());
+    }
+    Json += TEXT("],\"timeDeltas\":[");
+    int64_t LastTimestamp = Profile->GetStartTime();
+    for (int32 i = 0; i < SamplesCount; ++i)
+    {
+        const int64_t Timestamp = Profile->GetSampleTimestamp(i);
+        Json += FString::Printf(i == 0 ? TEXT("%lld") : TEXT(",%lld"), (long long) (Timestamp - LastTimestamp));
+        LastTimestamp = Timestamp;
+    }
+    Json += TEXT("]}");
+    return Json;
+}
+
+// one "frame;frame;frame count" line per call path that has self samples
+static FString ToFoldedStacks(const v8::CpuProfile* Profile)
+{
+    FString Folded;
+    TArray<TPair<const v8::CpuProfileNode*, FString>> Pending;
+    const v8::CpuProfileNode* Root = Profile->GetTopDownRoot();
+    for (int32 i = 0; i < Root->GetChildrenCount(); ++i)
+    {
+        Pending.Emplace(Root->GetChild(i), FString());
+    }
+    while (Pending.Num() > 0)
+    {
+        TPair<const v8::CpuProfileNode*, FString> Item = Pending.Pop(false);
+        const FString Stack = Item.Value.IsEmpty() ? GetFrameLabel(Item.Key) : Item.Value + TEXT(";") + GetFrameLabel(Item.Key);
+        if (Item.Key->GetHitCount() > 0)
+        {
+            Folded += FString::Printf(TEXT("%s %u\n"), *Stack, Item.Key->GetHitCount());
+        }
+        for (int32 i = 0; i < Item.Key->GetChildrenCount(); ++i)
+        {
+            Pending.Emplace(Item.Key->GetChild(i), Stack);
+        }
+    }
+    return Folded;
+}
+
+FJsEnvCpuProfiler::FJsEnvCpuProfiler(v8::Isolate* InIsolate) : Isolate(InIsolate)
+{
+}
+
+FJsEnvCpuProfiler::~FJsEnvCpuProfiler()
+{
+    if (Profiler)
+    {
+        Profiler->Dispose();
+        Profiler = nullptr;
+    }
+}
+
+v8::Local<v8::String> FJsEnvCpuProfiler::FrameTitle(uint32 Index) const
+{
+    const FString Title = FString::Printf(TEXT("puerts-frame-%u"), Index);
+    return v8::String::NewFromUtf8(Isolate, TCHAR_TO_UTF8(*Title), v8::NewStringType::kNormal).ToLocalChecked();
+}
+
+bool FJsEnvCpuProfiler::Start(int32 InSamplingIntervalUs, bool bInFrameStats)
+{
+    if (Profiler)
+    {
+        return false;
+    }
+
+#ifdef THREAD_SAFE
+    v8::Locker Locker(Isolate);
+#endif
+    v8::Isolate::Scope IsolateScope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+
+    SamplingIntervalUs = FMath::Max(InSamplingIntervalUs, 50);
+    bFrameStats = bInFrameStats;
+    Profiler = v8::CpuProfiler::New(Isolate);
+    Profiler->SetSamplingInterval(SamplingIntervalUs);
+    Profiler->StartProfiling(v8::String::NewFromUtf8(Isolate, SessionTitle, v8::NewStringType::kNormal).ToLocalChecked(), true);
+    if (bFrameStats)
+    {
+        Profiler->StartProfiling(FrameTitle(FrameIndex), false);
+    }
+    return true;
+}
+
+bool FJsEnvCpuProfiler::Stop(const FString& OutBasePath)
+{
+    if (!Profiler)
+    {
+        return false;
+    }
+
+#ifdef THREAD_SAFE
+    v8::Locker Locker(Isolate);
+#endif
+    v8::Isolate::Scope IsolateScope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+
+    if (bFrameStats)
+    {
+        if (v8::CpuProfile* FrameProfile = Profiler->StopProfiling(FrameTitle(FrameIndex)))
+        {
+            FrameProfile->Delete();
+        }
+    }
+
+    bool Result = false;
+    v8::CpuProfile* Profile =
+        Profiler->StopProfiling(v8::String::NewFromUtf8(Isolate, SessionTitle, v8::NewStringType::kNormal).ToLocalChecked());
+    if (Profile)
+    {
+        const FString ProfilePath = OutBasePath + TEXT(".cpuprofile");
+        const FString FoldedPath = OutBasePath + TEXT(".folded");
+        Result = FFileHelper::SaveStringToFile(ToCpuProfileJson(Profile), *ProfilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM) &&
+                 FFileHelper::SaveStringToFile(ToFoldedStacks(Profile), *FoldedPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+        UE_LOG(Puerts, Log, TEXT("js cpu profile of %d samples written to %s"), Profile->GetSamplesCount(), *ProfilePath);
+        Profile->Delete();
+    }
+
+    Profiler->Dispose();
+    Profiler = nullptr;
+    return Result;
+}
+
+void FJsEnvCpuProfiler::OnEndFrame()
+{
+    if (!Profiler || !bFrameStats)
+    {
+        return;
+    }
+
+#ifdef THREAD_SAFE
+    v8::Locker Locker(Isolate);
+#endif
+    v8::Isolate::Scope IsolateScope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+
+    // start the next frame before stopping this one so no samples fall in between
+    const uint32 LastFrameIndex = FrameIndex++;
+    Profiler->StartProfiling(FrameTitle(FrameIndex), false);
+    v8::CpuProfile* Profile = Profiler->StopProfiling(FrameTitle(LastFrameIndex));
+    if (!Profile)
+    {
+        return;
+    }
+
+    TMap<FString, uint32> SelfHits;
+    uint32 ScriptHits = 0;
+    TArray<const v8::CpuProfileNode*> Pending;
+    Pending.Add(Profile->GetTopDownRoot());
+    while (Pending.Num() > 0)
+    {
+        const v8::CpuProfileNode* Node = Pending.Pop(false);
+        if (Node->GetHitCount() > 0 && IsScriptNode(Node))
+        {
+            SelfHits.FindOrAdd(GetFrameLabel(Node)) += Node->GetHitCount();
+            ScriptHits += Node->GetHitCount();
+        }
+        for (int32 i = 0; i < Node->GetChildrenCount(); ++i)
+        {
+            Pending.Add(Node->GetChild(i));
+        }
+    }
+    Profile->Delete();
+
+    const float MsPerHit = SamplingIntervalUs / 1000.f;
+    const float ScriptMs = ScriptHits * MsPerHit;
+    INC_FLOAT_STAT_BY(STAT_PuertsJsSampledMs, ScriptMs);
+    CSV_CUSTOM_STAT(PuertsJS, SampledMs, ScriptMs, ECsvCustomStatOp::Accumulate);
+    // several envs report into the same counter, it restarts every frame
+    static uint64 TraceCounterFrame = 0;
+    if (TraceCounterFrame != GFrameCounter)
+    {
+        TraceCounterFrame = GFrameCounter;
+        TRACE_COUNTER_SET(PuertsJsSampledMs, ScriptMs);
+    }
+    else
+    {
+        TRACE_COUNTER_ADD(PuertsJsSampledMs, ScriptMs);
+    }
+
+#if CSV_PROFILER
+    if (SelfHits.Num() > 0 && FCsvProfiler::Get()->IsCapturing())
+    {
+        SelfHits.ValueSort([](uint32 A, uint32 B) { return A > B; });
+        int32 Reported = 0;
+        for (const auto& Pair : SelfHits)
+        {
+            if (Reported++ >= FrameHotFunctionNum)
+            {
+                break;
+            }
+            FCsvProfiler::RecordCustomStat(
+                FName(*Pair.Key), CSV_CATEGORY_INDEX(PuertsJS), Pair.Value * MsPerHit, ECsvCustomStatOp::Accumulate);
+        }
+    }
+#endif
+}
+}    // namespace PUERTS_NAMESPACE
+
+#endif
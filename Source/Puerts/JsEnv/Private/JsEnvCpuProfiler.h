@@ -0,0 +1,64 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#ifndef WITH_QUICKJS
+
+#include "CoreMinimal.h"
+
+#include "NamespaceDef.h"
+
+PRAGMA_DISABLE_UNDEFINED_IDENTIFIER_WARNINGS
+#pragma warning(push, 0)
+#include "v8.h"
+#include "v8-profiler.h"
+#pragma warning(pop)
+PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS
+
+namespace PUERTS_NAMESPACE
+{
+// Sampling profiler of one env that works without the inspector, so packaged builds can be profiled too. A session is
+// written as a .cpuprofile (loadable in Chrome DevTools / VS Code) plus a folded stack summary for flame graph tools.
+// With frame stats on, a second profile is rotated every frame and its hottest functions are reported as stats, csv
+// stats and an insights counter, so script cost lines up with game frames.
+class FJsEnvCpuProfiler
+{
+public:
+    explicit FJsEnvCpuProfiler(v8::Isolate* InIsolate);
+
+    ~FJsEnvCpuProfiler();
+
+    bool Start(int32 InSamplingIntervalUs, bool bInFrameStats);
+
+    // writes OutBasePath.cpuprofile and OutBasePath.folded
+    bool Stop(const FString& OutBasePath);
+
+    bool IsProfiling() const
+    {
+        return Profiler != nullptr;
+    }
+
+    void OnEndFrame();
+
+private:
+    v8::Local<v8::String> FrameTitle(uint32 Index) const;
+
+    v8::Isolate* Isolate;
+
+    v8::CpuProfiler* Profiler = nullptr;
+
+    int32 SamplingIntervalUs = 0;
+
+    bool bFrameStats = false;
+
+    uint32 FrameIndex = 0;
+};
+}    // namespace PUERTS_NAMESPACE
+
+#endif
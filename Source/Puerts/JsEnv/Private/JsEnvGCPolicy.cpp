@@ -0,0 +1,147 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#include "JsEnvGCPolicy.h"
+
+#ifndef WITH_QUICKJS
+
+#include "JsEnvModule.h"
+#include "JsEnvStats.h"
+#include "JSLogger.h"
+#include "Misc/CoreDelegates.h"
+#include "UObject/UObjectGlobals.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Heap Used (MB)"), STAT_PuertsHeapUsedMB, STATGROUP_Puerts);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Heap Total (MB)"), STAT_PuertsHeapTotalMB, STATGROUP_Puerts);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("External Memory (MB)"), STAT_PuertsExternalMemoryMB, STATGROUP_Puerts);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Idle GC Notifications"), STAT_PuertsIdleGCNotifications, STATGROUP_Puerts);
+
+CSV_DEFINE_CATEGORY(Puerts, true);
+
+namespace PUERTS_NAMESPACE
+{
+// spare time shorter than this is not worth waking the gc for
+static constexpr double MinIdleSeconds = 0.001;
+
+// memory pressure makes v8 start incremental marking, telling it again while that runs only costs time
+static constexpr double PressureIntervalSeconds = 1.0;
+
+FJsEnvGCPolicy::FJsEnvGCPolicy(v8::Isolate* InIsolate) : Isolate(InIsolate)
+{
+    MemoryTrimHandle = FCoreDelegates::GetMemoryTrimDelegate().AddLambda([this]() { FullGCRequested = true; });
+    PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddLambda([this](const FString&) { FullGCRequested = true; });
+}
+
+FJsEnvGCPolicy::~FJsEnvGCPolicy()
+{
+    FCoreDelegates::GetMemoryTrimDelegate().Remove(MemoryTrimHandle);
+    FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+    if (NearHeapLimitCallbackAdded)
+    {
+        Isolate->RemoveNearHeapLimitCallback(&FJsEnvGCPolicy::OnNearHeapLimit, 0);
+    }
+}
+
+void FJsEnvGCPolicy::SetHeapLimits(const FJsEnvHeapLimits& InLimits)
+{
+    Limits = InLimits;
+    if (Limits.HardLimitBytes > 0 && !NearHeapLimitCallbackAdded)
+    {
+        Isolate->AddNearHeapLimitCallback(&FJsEnvGCPolicy::OnNearHeapLimit, this);
+        NearHeapLimitCallbackAdded = true;
+    }
+    else if (Limits.HardLimitBytes == 0 && NearHeapLimitCallbackAdded)
+    {
+        Isolate->RemoveNearHeapLimitCallback(&FJsEnvGCPolicy::OnNearHeapLimit, RaisedHeapBytes > 0 ? InitialHeapLimitBytes : 0);
+        NearHeapLimitCallbackAdded = false;
+        RaisedHeapBytes = 0;
+    }
+}
+
+void FJsEnvGCPolicy::RestoreHeapLimit()
+{
+    // the headroom handed out near the limit is only meant to last until the full gc, without this every trip near the
+    // limit would leave it a quarter higher. Removing the callback with a limit is the only way v8 lets us set it back
+    if (RaisedHeapBytes > 0 && NearHeapLimitCallbackAdded)
+    {
+        Isolate->RemoveNearHeapLimitCallback(&FJsEnvGCPolicy::OnNearHeapLimit, InitialHeapLimitBytes);
+        Isolate->AddNearHeapLimitCallback(&FJsEnvGCPolicy::OnNearHeapLimit, this);
+    }
+    RaisedHeapBytes = 0;
+}
+
+size_t FJsEnvGCPolicy::OnNearHeapLimit(void* Data, size_t CurrentHeapLimit, size_t InitialHeapLimit)
+{
+    // runs inside a gc: nothing may be allocated on the js heap here, just log, schedule a full gc and give v8 some room
+    // so the env survives until then. Past twice the initial limit v8 is left to fail.
+    FJsEnvGCPolicy* Self = static_cast<FJsEnvGCPolicy*>(Data);
+    Self->FullGCRequested = true;
+    Self->InitialHeapLimitBytes = InitialHeapLimit;
+
+    const size_t Headroom = InitialHeapLimit / 4;
+    if (Self->RaisedHeapBytes + Headroom > InitialHeapLimit)
+    {
+        UE_LOG(Puerts, Error, TEXT("js heap exhausted, limit %llu MB"), (uint64) (CurrentHeapLimit >> 20));
+        return CurrentHeapLimit;
+    }
+    Self->RaisedHeapBytes += Headroom;
+    UE_LOG(Puerts, Warning, TEXT("js heap near its hard limit (%llu MB), raised to %llu MB until the next full gc"),
+        (uint64) (CurrentHeapLimit >> 20), (uint64) ((CurrentHeapLimit + Headroom) >> 20));
+    return CurrentHeapLimit + Headroom;
+}
+
+void FJsEnvGCPolicy::OnEndFrame(double IdleSeconds)
+{
+#ifdef THREAD_SAFE
+    v8::Locker Locker(Isolate);
+#endif
+    v8::HeapStatistics Statistics;
+    Isolate->GetHeapStatistics(&Statistics);
+
+    const float UsedMB = Statistics.used_heap_size() / (1024.f * 1024.f);
+    const float TotalMB = Statistics.total_heap_size() / (1024.f * 1024.f);
+    const float ExternalMB = Statistics.external_memory() / (1024.f * 1024.f);
+    INC_FLOAT_STAT_BY(STAT_PuertsHeapUsedMB, UsedMB);
+    INC_FLOAT_STAT_BY(STAT_PuertsHeapTotalMB, TotalMB);
+    INC_FLOAT_STAT_BY(STAT_PuertsExternalMemoryMB, ExternalMB);
+    CSV_CUSTOM_STAT(Puerts, HeapUsedMB, UsedMB, ECsvCustomStatOp::Accumulate);
+    CSV_CUSTOM_STAT(Puerts, HeapTotalMB, TotalMB, ECsvCustomStatOp::Accumulate);
+    CSV_CUSTOM_STAT(Puerts, ExternalMemoryMB, ExternalMB, ECsvCustomStatOp::Accumulate);
+
+    if (FullGCRequested.exchange(false))
+    {
+        Isolate->LowMemoryNotification();
+        RestoreHeapLimit();
+        return;
+    }
+
+    if (Limits.SoftLimitBytes > 0 && Statistics.used_heap_size() > Limits.SoftLimitBytes)
+    {
+        const double Now = FPlatformTime::Seconds();
+        if (Now - LastPressureSeconds > PressureIntervalSeconds)
+        {
+            LastPressureSeconds = Now;
+            Isolate->MemoryPressureNotification(v8::MemoryPressureLevel::kModerate);
+        }
+    }
+
+    // give what is left of the frame to the v8 gc
+    if (IdleSeconds > MinIdleSeconds)
+    {
+        auto Platform = static_cast<v8::Platform*>(IJsEnvModule::Get().GetV8Platform());
+        if (Platform)
+        {
+            Isolate->IdleNotificationDeadline(Platform->MonotonicallyIncreasingTime() + IdleSeconds);
+            INC_DWORD_STAT(STAT_PuertsIdleGCNotifications);
+        }
+    }
+}
+}    // namespace PUERTS_NAMESPACE
+
+#endif
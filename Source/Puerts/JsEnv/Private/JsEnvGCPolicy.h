@@ -0,0 +1,68 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#ifndef WITH_QUICKJS
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "JsEnv.h"
+
+#include "NamespaceDef.h"
+
+PRAGMA_DISABLE_UNDEFINED_IDENTIFIER_WARNINGS
+#pragma warning(push, 0)
+#include "v8.h"
+#pragma warning(pop)
+PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS
+
+namespace PUERTS_NAMESPACE
+{
+// Decides when the v8 heap of one env is collected, so major gcs land in spare frame time, on memory warnings and on map
+// loads instead of in the middle of gameplay frames, and reports the heap as stats / csv counters.
+class FJsEnvGCPolicy
+{
+public:
+    explicit FJsEnvGCPolicy(v8::Isolate* InIsolate);
+
+    ~FJsEnvGCPolicy();
+
+    void SetHeapLimits(const FJsEnvHeapLimits& InLimits);
+
+    // called once the frame is painted, IdleSeconds is what is left of the frame budget
+    void OnEndFrame(double IdleSeconds);
+
+private:
+    static size_t OnNearHeapLimit(void* Data, size_t CurrentHeapLimit, size_t InitialHeapLimit);
+
+    void RestoreHeapLimit();
+
+    v8::Isolate* Isolate;
+
+    FJsEnvHeapLimits Limits;
+
+    // set from memory warnings (any thread), map loads and the near heap limit callback, served at the end of the frame
+    std::atomic<bool> FullGCRequested{false};
+
+    double LastPressureSeconds = 0;
+
+    size_t RaisedHeapBytes = 0;
+
+    size_t InitialHeapLimitBytes = 0;
+
+    bool NearHeapLimitCallbackAdded = false;
+
+    FDelegateHandle MemoryTrimHandle;
+
+    FDelegateHandle PreLoadMapHandle;
+};
+}    // namespace PUERTS_NAMESPACE
+
+#endif
@@ -33,6 +33,12 @@
 
 #include "V8InspectorImpl.h"
 #include "Kismet/KismetRenderingLibrary.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/App.h"
+#include "JsEnvStats.h"
+#include "JsEnvTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ScriptArchive.h"
 #if USE_WASM3
 #include "WasmModuleInstance.h"
 #endif
@@ -90,6 +96,48 @@ PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS
 void InitWebsocketPPWrap(v8::Local<v8::Context> Context);
 #endif
 
+DECLARE_CYCLE_STAT(TEXT("Check Delegate Proxies"), STAT_PuertsCheckDelegateProxies, STATGROUP_Puerts);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Delegates"), STAT_PuertsDelegates, STATGROUP_Puerts);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dead Delegates Released"), STAT_PuertsDeadDelegatesReleased, STATGROUP_Puerts);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Script Time Per Frame (ms)"), STAT_PuertsScriptFrameMs, STATGROUP_Puerts);
+
+#if PUERTS_TRACE_ENABLED
+TRACE_DECLARE_INT_COUNTER(PuertsWrappersCreated, TEXT("Puerts/WrappersCreatedPerFrame"));
+
+static uint64 WrappersCreatedFrame = 0;
+
+// once per frame whatever the number of envs, also from frames that create no wrapper so the counter does not keep the
+// last busy frame's value
+static void TraceWrappersCreatedNewFrame()
+{
+    if (PUERTS_TRACE_IS_ENABLED() && WrappersCreatedFrame != GFrameCounter)
+    {
+        WrappersCreatedFrame = GFrameCounter;
+        TRACE_COUNTER_SET(PuertsWrappersCreated, 0);
+    }
+}
+
+static void TraceWrapperCreated()
+{
+    if (PUERTS_TRACE_IS_ENABLED())
+    {
+        TraceWrappersCreatedNewFrame();
+        TRACE_COUNTER_INCREMENT(PuertsWrappersCreated);
+    }
+}
+#define PUERTS_TRACE_WRAPPER_CREATED() TraceWrapperCreated()
+#define PUERTS_TRACE_WRAPPERS_NEW_FRAME() TraceWrappersCreatedNewFrame()
+#else
+#define PUERTS_TRACE_WRAPPER_CREATED()
+#define PUERTS_TRACE_WRAPPERS_NEW_FRAME()
+#endif
+
+static float ScriptFrameBudgetRatio = 0.5f;
+static FAutoConsoleVariableRef CVarScriptFrameBudgetRatio(TEXT("Puerts.ScriptFrameBudgetRatio"), ScriptFrameBudgetRatio,
+    TEXT("Share of the frame time budget js may use before shouldYield() returns true"), ECVF_Default);
+
+static const double FrameScriptHistogramBoundsMs[] = {0.5, 1, 2, 4, 8, 16, 33};
+
 namespace PUERTS_NAMESPACE
 {
 #if !defined(WITH_QUICKJS)
@@ -345,10 +393,48 @@ struct FCodeCacheHeader
 };
 #endif
 
+#ifndef WITH_QUICKJS
+// source text owned by the module loader (e.g. the mapped script archive), v8 reads it in place
+class FBorrowedOneByteSource : public v8::String::ExternalOneByteStringResource
+{
+public:
+    FBorrowedOneByteSource(const uint8* InData, int32 InSize) : Data(reinterpret_cast<const char*>(InData)), Size(InSize)
+    {
+    }
+
+    virtual const char* data() const override
+    {
+        return Data;
+    }
+
+    virtual size_t length() const override
+    {
+        return Size;
+    }
+
+private:
+    const char* Data;
+    size_t Size;
+};
+#endif
+
+static v8::MaybeLocal<v8::String> NewSourceFromView(v8::Isolate* Isolate, const FModuleContentView& View)
+{
+#ifndef WITH_QUICKJS
+    if (View.OneByte && View.Size > 0)
+    {
+        return v8::String::NewExternalOneByte(Isolate, new FBorrowedOneByteSource(View.Data, View.Size));
+    }
+#endif
+    return v8::MaybeLocal<v8::String>();
+}
+
 FJsEnvImpl::FJsEnvImpl(std::shared_ptr<IJSModuleLoader> InModuleLoader, std::shared_ptr<ILogger> InLogger, int InDebugPort,
     std::function<void(const FString&)> InOnSourceLoadedCallback, const FString InFlags, void* InExternalRuntime,
     void* InExternalContext)
 {
+    FJsEnv::OnWaitForScriptFiles().Broadcast();
+
     GUObjectArray.AddUObjectDeleteListener(static_cast<FUObjectArray::FUObjectDeleteListener*>(this));
 
     if (!InFlags.IsEmpty())
@@ -549,6 +635,24 @@ FJsEnvImpl::FJsEnvImpl(std::shared_ptr<IJSModuleLoader> InModuleLoader, std::sha
     MethodBindingHelper<&FJsEnvImpl::ClearInterval>::Bind(Isolate, Context, Global, "clearInterval", This);
     //#endif
 
+    MethodBindingHelper<&FJsEnvImpl::RequestAnimationFrame>::Bind(Isolate, Context, Global, "requestAnimationFrame", This);
+
+    MethodBindingHelper<&FJsEnvImpl::CancelAnimationFrame>::Bind(Isolate, Context, Global, "cancelAnimationFrame", This);
+
+    MethodBindingHelper<&FJsEnvImpl::RequestIdleCallback>::Bind(Isolate, Context, Global, "requestIdleCallback", This);
+
+    MethodBindingHelper<&FJsEnvImpl::CancelIdleCallback>::Bind(Isolate, Context, Global, "cancelIdleCallback", This);
+
+    MethodBindingHelper<&FJsEnvImpl::GetFrameDeadline>::Bind(Isolate, Context, Global, "__tgjsGetFrameDeadline", This);
+
+    MethodBindingHelper<&FJsEnvImpl::FrameTimeRemaining>::Bind(Isolate, Context, Global, "__tgjsFrameTimeRemaining", This);
+
+    MethodBindingHelper<&FJsEnvImpl::ScheduleContinuation>::Bind(Isolate, Context, Global, "__tgjsScheduleContinuation", This);
+
+    MethodBindingHelper<&FJsEnvImpl::CancelContinuation>::Bind(Isolate, Context, Global, "__tgjsCancelContinuation", This);
+
+    MethodBindingHelper<&FJsEnvImpl::GetFrameStats>::Bind(Isolate, Context, Global, "__tgjsGetFrameStats", This);
+
 #if USE_WASM3
     MethodBindingHelper<&FJsEnvImpl::Wasm_NewMemory>::Bind(Isolate, Context, Global, "__tgjsWasm_NewMemory", This);
     MethodBindingHelper<&FJsEnvImpl::Wasm_MemoryGrowth>::Bind(Isolate, Context, Global, "__tgjsWasm_MemoryGrowth", This);
@@ -633,6 +737,7 @@ FJsEnvImpl::FJsEnvImpl(std::shared_ptr<IJSModuleLoader> InModuleLoader, std::sha
     ExecuteModule("puerts/events.js");
     ExecuteModule("puerts/promises.js");
     ExecuteModule("puerts/argv.js");
+    ExecuteModule("puerts/frame.js");
     ExecuteModule("puerts/jit_stub.js");
     ExecuteModule("puerts/hot_reload.js");
     ExecuteModule("puerts/pesaddon.js");
@@ -663,6 +768,18 @@ FJsEnvImpl::FJsEnvImpl(std::shared_ptr<IJSModuleLoader> InModuleLoader, std::sha
     DelegateProxiesCheckerHandler =
         FUETicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FJsEnvImpl::CheckDelegateProxies), 1);
 
+    // one ticker drives all setTimeout/setInterval of this env
+    TimerTickerHandle = FUETicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FJsEnvImpl::TickTimers), 0);
+
+    // OnBeginFrame is broadcast before slate tick, OnEndFrame after the frame is presented
+    FrameClockOrigin = FPlatformTime::Seconds();
+    FrameStartSeconds = FrameClockOrigin;
+    BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddRaw(this, &FJsEnvImpl::OnBeginFrame);
+    EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FJsEnvImpl::OnEndFrame);
+#ifndef WITH_QUICKJS
+    GCPolicy = MakeUnique<FJsEnvGCPolicy>(Isolate);
+#endif
+
     ManualReleaseCallbackMap.Reset(Isolate, v8::Map::New(Isolate));
 
     UserObjectRetainer.SetName(TEXT("Puerts_UserObjectRetainer"));
@@ -695,6 +812,11 @@ FJsEnvImpl::FJsEnvImpl(std::shared_ptr<IJSModuleLoader> InModuleLoader, std::sha
     InitWebsocketPPWrap(Context);
     ExecuteModule("puerts/websocketpp.js");
 #endif
+#if !defined(WITH_QUICKJS) && !defined(WITH_NODEJS)
+    WorkerHost = MakeUnique<FJsWorkerHost>(ModuleLoader);
+    WorkerHost->Init(Context);
+    ExecuteModule("puerts/worker.js");
+#endif
 #ifdef WITH_QUICKJS
     auto rt = Isolate->runtime_;
     JS_SetMaxStackSize(rt, 1024 * 1024);
@@ -722,6 +844,11 @@ FJsEnvImpl::~FJsEnvImpl()
     StopPolling();
 #endif
 
+#if !defined(WITH_QUICKJS) && !defined(WITH_NODEJS)
+    // joins the worker threads, must happen before the isolate holding their wrappers goes away
+    WorkerHost.Reset();
+#endif
+
 #ifndef WITH_QUICKJS
     for (auto& KV : HashToModuleInfo)
     {
@@ -748,6 +875,15 @@ FJsEnvImpl::~FJsEnvImpl()
 
     FUETicker::GetCoreTicker().RemoveTicker(DelegateProxiesCheckerHandler);
 
+    FUETicker::GetCoreTicker().RemoveTicker(TimerTickerHandle);
+
+    FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+    FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+#ifndef WITH_QUICKJS
+    GCPolicy.Reset();
+    CpuProfiler.Reset();
+#endif
+
     {
         auto Isolate = MainIsolate;
 #ifdef THREAD_SAFE
@@ -806,6 +942,10 @@ FJsEnvImpl::~FJsEnvImpl()
             }
             Iter->second.JsCallbacks.Reset();
         }
+        DEC_DWORD_STAT_BY(STAT_PuertsDelegates, DelegateMap.size());
+        DelegateMap.clear();
+        DelegatesOfOwner.Empty();
+        DeadOwnerDelegates.clear();
 
         for (auto& KV : AutoReleaseCallbacksMap)
         {
@@ -826,12 +966,12 @@ FJsEnvImpl::~FJsEnvImpl()
         BindInfoMap.Empty();
 #endif
 
-        for (auto Iter = TimerInfos.CreateIterator(); Iter; ++Iter)
-        {
-            Iter->Value.Callback.Reset();
-            FUETicker::GetCoreTicker().RemoveTicker(Iter->Value.TickerHandle);
-        }
-        TimerInfos.Empty();
+        TimerWheel.Clear();
+        TimerInfos.clear();
+        AnimationFrameCallbacks.clear();
+        IdleCallbacks.clear();
+        FiringFrameCallbacks.clear();
+        Continuations.clear();
 
 #if !defined(ENGINE_INDEPENDENT_JSENV)
         for (auto& GeneratedClass : GeneratedClasses)
@@ -1518,6 +1658,8 @@ void FJsEnvImpl::ReloadModule(FName ModuleName, const FString& JsSource)
     v8::Locker Locker(MainIsolate);
 #endif
     // Logger->Info(FString::Printf(TEXT("start reload js module [%s]"), *ModuleName.ToString()));
+    // a reload may follow added or moved files the directory watcher has not reported yet
+    ModuleLoader->InvalidateSearchCache();
     JsHotReload(ModuleName, JsSource);
 }
 
@@ -1536,6 +1678,7 @@ void FJsEnvImpl::ReloadSource(const FString& Path, const PString& JsSource)
     v8::Context::Scope ContextScope(Context);
     auto LocalReloadJs = MyReloadJs.Get(Isolate);
 
+    ModuleLoader->InvalidateSearchCache();
     Logger->Info(FString::Printf(TEXT("reload js [%s]"), *Path));
     v8::TryCatch TryCatch(Isolate);
     v8::Handle<v8::Value> Args[] = {
@@ -1566,6 +1709,7 @@ void FJsEnvImpl::ForceReloadJsFile(const FString& ModuleName)
     v8::Context::Scope ContextScope(Context);
     auto ReloadJs = ForceReloadJs.Get(Isolate);
 
+    ModuleLoader->InvalidateSearchCache();
     FString OutPath, OutDebugPath;
 
     if (ModuleLoader->Search(TEXT(""), ModuleName, OutPath, OutDebugPath))
@@ -1588,6 +1732,59 @@ void FJsEnvImpl::ForceReloadJsFile(const FString& ModuleName)
     }
 }
 
+void FJsEnvImpl::SetHeapLimits(const FJsEnvHeapLimits& Limits)
+{
+#ifndef WITH_QUICKJS
+    GCPolicy->SetHeapLimits(Limits);
+#endif
+}
+
+bool FJsEnvImpl::StartCpuProfiling(int32 SamplingIntervalUs, bool bFrameStats)
+{
+#ifndef WITH_QUICKJS
+    if (!CpuProfiler)
+    {
+        CpuProfiler = MakeUnique<FJsEnvCpuProfiler>(MainIsolate);
+    }
+    return CpuProfiler->Start(SamplingIntervalUs, bFrameStats);
+#else
+    Logger->Warn(TEXT("cpu profiling is not supported by quickjs"));
+    return false;
+#endif
+}
+
+bool FJsEnvImpl::StopCpuProfiling(const FString& OutBasePath)
+{
+#ifndef WITH_QUICKJS
+    return CpuProfiler && CpuProfiler->Stop(OutBasePath);
+#else
+    return false;
+#endif
+}
+
+void FJsEnvImpl::GetLoadStats(FJsEnvLoadStats& OutStats)
+{
+#ifdef SINGLE_THREAD_VERIFY
+    ensureMsgf(BoundThreadId == FPlatformTLS::GetCurrentThreadId(), TEXT("Access by illegal thread!"));
+#endif
+    OutStats.LiveObjectWrappers = ObjectMap.Num();
+    OutStats.LiveStructWrappers = StructCache.Num();
+    OutStats.ScriptSeconds = FPlatformTime::ToSeconds64(ScriptCycles);
+#ifndef WITH_QUICKJS
+    auto Isolate = MainIsolate;
+#ifdef THREAD_SAFE
+    v8::Locker Locker(Isolate);
+#endif
+    v8::HeapStatistics Statistics;
+    Isolate->GetHeapStatistics(&Statistics);
+    OutStats.UsedHeapSize = Statistics.used_heap_size();
+    OutStats.TotalHeapSize = Statistics.total_heap_size();
+#else
+    OutStats.UsedHeapSize = 0;
+    OutStats.TotalHeapSize = 0;
+#endif    // !WITH_QUICKJS
+}
+
 #if !defined(ENGINE_INDEPENDENT_JSENV)
 void FJsEnvImpl::TryBindJs(const class UObjectBase* InObject)
 {
@@ -1847,6 +2044,7 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAdd(
         auto Result = TemplateInfoPtr->Template.Get(Isolate)->InstanceTemplate()->NewInstance(Context).ToLocalChecked();
         auto ClassWrapper = static_cast<FClassWrapper*>(TemplateInfoPtr->StructWrapper.get());
         Bind(ClassWrapper, UEObject, Result);
+        PUERTS_TRACE_WRAPPER_CREATED();
         if (!SkipTypeScriptInitial && ClassWrapper->IsTypeScriptGeneratedClass)
         {
             TypeScriptInitial(UEObject->GetClass(), UEObject);
@@ -1887,6 +2085,7 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAddStruct(
     auto TemplateInfoPtr = GetTemplateInfoOfType(ScriptStruct, Existed);
     auto Result = TemplateInfoPtr->Template.Get(Isolate)->InstanceTemplate()->NewInstance(Context).ToLocalChecked();
     BindStruct(static_cast<FScriptStructWrapper*>(TemplateInfoPtr->StructWrapper.get()), Ptr, Result, PassByPointer);
+    PUERTS_TRACE_WRAPPER_CREATED();
     return Result;
 }
 
@@ -1913,6 +2112,8 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAddDelegate(v8::Isolate* Isolate, v8::Loc
             else
             {
                 ClearDelegate(Isolate, Context, DelegatePtr);
+                // the address is reused by a new owner, the entry is replaced below
+                EraseDelegate(Iter);
             }
         }
     }
@@ -1950,9 +2151,10 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAddDelegate(v8::Isolate* Isolate, v8::Loc
         {
             Function = MulticastDelegateProperty->SignatureFunction;
         }
-        DelegateMap[DelegatePtr] = {v8::UniquePersistent<v8::Object>(Isolate, JSObject), TWeakObjectPtr<UObject>(Owner),
-            DelegateProperty, MulticastDelegateProperty, Function, PassByPointer, nullptr,
-            v8::UniquePersistent<v8::Array>(Isolate, v8::Array::New(Isolate))};
+        AddDelegate(DelegatePtr,
+            {v8::UniquePersistent<v8::Object>(Isolate, JSObject), TWeakObjectPtr<UObject>(Owner), DelegateProperty,
+                MulticastDelegateProperty, Function, PassByPointer, nullptr,
+                v8::UniquePersistent<v8::Array>(Isolate, v8::Array::New(Isolate)), Owner});
         return JSObject;
     }
 }
@@ -2000,6 +2202,8 @@ void FJsEnvImpl::InvokeDelegateCallback(UDynamicDelegateProxy* Proxy, void* Para
         }
     }
 
+    FScriptTimeScope ScriptTimeScope(this);
+    PUERTS_TRACE_SCOPE_CACHED(Iter->second->TraceSpecId, TEXT("Delegate ") + SignatureFunction->GetName());
     auto Isolate = MainIsolate;
     v8::Isolate::Scope IsolateScope(Isolate);
     v8::HandleScope HandleScope(Isolate);
@@ -2166,6 +2370,14 @@ void FJsEnvImpl::NotifyUObjectDeleted(const class UObjectBase* ObjectBase, int32
     MixinFunctionMap.Remove((UFunction*) ObjectBase);
     ContainerMeta.NotifyElementTypeDeleted((UField*) ObjectBase);
 
+    JsCallbackPrototypeMap.erase((UFunction*) ObjectBase);
+
+    if (TArray<void*>* DelegatesPtr = DelegatesOfOwner.Find((UObject*) ObjectBase))
+    {
+        DeadOwnerDelegates.insert(DeadOwnerDelegates.end(), DelegatesPtr->GetData(), DelegatesPtr->GetData() + DelegatesPtr->Num());
+        DelegatesOfOwner.Remove((UObject*) ObjectBase);
+    }
+
     auto CallbacksPtr = AutoReleaseCallbacksMap.Find((UObject*) ObjectBase);
     if (CallbacksPtr)
     {
@@ -2269,6 +2481,7 @@ void FJsEnvImpl::InvokeMixinMethod(UObject* ContextObject, UJSGeneratedFunction*
 #ifdef SINGLE_THREAD_VERIFY
     ensureMsgf(BoundThreadId == FPlatformTLS::GetCurrentThreadId(), TEXT("Access by illegal thread!"));
 #endif
+    FScriptTimeScope ScriptTimeScope(this);
     auto Isolate = MainIsolate;
 #ifdef THREAD_SAFE
     v8::Locker Locker(Isolate);
@@ -2318,6 +2531,7 @@ void FJsEnvImpl::InvokeTsMethod(UObject* ContextObject, UFunction* Function, FFr
 #ifdef SINGLE_THREAD_VERIFY
     ensureMsgf(BoundThreadId == FPlatformTLS::GetCurrentThreadId(), TEXT("Access by illegal thread!"));
 #endif
+    FScriptTimeScope ScriptTimeScope(this);
 #ifdef THREAD_SAFE
     v8::Locker Locker(MainIsolate);
 #endif
@@ -2454,11 +2668,7 @@ bool FJsEnvImpl::AddToDelegate(
     {
         Logger->Warn("try to bind a delegate with invalid owner!");
         ClearDelegate(Isolate, Context, DelegatePtr);
-        if (!Iter->second.PassByPointer)
-        {
-            delete ((FScriptDelegate*) Iter->first);
-        }
-        DelegateMap.erase(Iter);
+        EraseDelegate(Iter);
         return false;
     }
 
@@ -2694,11 +2904,7 @@ bool FJsEnvImpl::RemoveFromDelegate(
     {
         Logger->Warn("try to unbind a delegate with invalid owner!");
         ClearDelegate(Isolate, Context, DelegatePtr);
-        if (!Iter->second.PassByPointer)
-        {
-            delete ((FScriptDelegate*) Iter->first);
-        }
-        DelegateMap.erase(Iter);
+        EraseDelegate(Iter);
         return false;
     }
 
@@ -2790,58 +2996,78 @@ bool FJsEnvImpl::ClearDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
     return true;
 }
 
-bool FJsEnvImpl::CheckDelegateProxies(float Tick)
+void FJsEnvImpl::AddDelegate(void* DelegatePtr, DelegateObjectInfo&& Info)
 {
-#ifdef SINGLE_THREAD_VERIFY
-    ensureMsgf(BoundThreadId == FPlatformTLS::GetCurrentThreadId(), TEXT("Access by illegal thread!"));
-#endif
-    auto Isolate = MainIsolate;
-#ifdef THREAD_SAFE
-    v8::Locker Locker(Isolate);
-#endif
-
-    std::vector<void*> PendingToRemove;
-    for (auto& KV : DelegateMap)
+    UObject* Owner = Info.OwnerKey;
+    auto Result = DelegateMap.emplace(DelegatePtr, std::move(Info));
+    check(Result.second);
+    INC_DWORD_STAT(STAT_PuertsDelegates);
+    if (Owner)
     {
-        if (!KV.second.Owner.IsValid())
-        {
-            PendingToRemove.push_back(KV.first);
-        }
+        DelegatesOfOwner.FindOrAdd(Owner).Add(DelegatePtr);
+    }
+    else
+    {
+        DeadOwnerDelegates.push_back(DelegatePtr);
     }
+}
 
-    if (PendingToRemove.size() > 0)
+void FJsEnvImpl::EraseDelegate(FDelegateMap::iterator Iter)
+{
+    if (Iter->second.OwnerKey)
     {
-        v8::Isolate::Scope IsolateScope(Isolate);
-        v8::HandleScope HandleScope(Isolate);
-        v8::Local<v8::Context> Context = DefaultContext.Get(Isolate);
-        v8::Context::Scope ContextScope(Context);
-        for (int i = 0; i < PendingToRemove.size(); ++i)
+        if (TArray<void*>* Delegates = DelegatesOfOwner.Find(Iter->second.OwnerKey))
         {
-            ClearDelegate(Isolate, Context, PendingToRemove[i]);
-            if (!DelegateMap[PendingToRemove[i]].PassByPointer)
+            Delegates->RemoveSingleSwap(Iter->first);
+            if (Delegates->Num() == 0)
             {
-                delete ((FScriptDelegate*) PendingToRemove[i]);
+                DelegatesOfOwner.Remove(Iter->second.OwnerKey);
             }
-            DelegateMap.erase(PendingToRemove[i]);
         }
     }
+    if (!Iter->second.PassByPointer)
+    {
+        delete ((FScriptDelegate*) Iter->first);
+    }
+    DelegateMap.erase(Iter);
+    DEC_DWORD_STAT(STAT_PuertsDelegates);
+}
+
+bool FJsEnvImpl::CheckDelegateProxies(float Tick)
+{
+#ifdef SINGLE_THREAD_VERIFY
+    ensureMsgf(BoundThreadId == FPlatformTLS::GetCurrentThreadId(), TEXT("Access by illegal thread!"));
+#endif
+    SCOPE_CYCLE_COUNTER(STAT_PuertsCheckDelegateProxies);
 
-    // Collecting invalid function translators to remove.
-    std::vector<UFunction*> PendingToRemoveJsCallbacks;
-    for (auto& KV : JsCallbackPrototypeMap)
+    if (DeadOwnerDelegates.empty())
     {
-        if ((nullptr == KV.first) || (!KV.second->IsValid()))
-        {
-            PendingToRemoveJsCallbacks.push_back(KV.first);
-        }
+        return true;
     }
 
-    if (PendingToRemoveJsCallbacks.size() > 0)
+    auto Isolate = MainIsolate;
+#ifdef THREAD_SAFE
+    v8::Locker Locker(Isolate);
+#endif
+
+    std::vector<void*> PendingToRemove;
+    PendingToRemove.swap(DeadOwnerDelegates);
+
+    v8::Isolate::Scope IsolateScope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = DefaultContext.Get(Isolate);
+    v8::Context::Scope ContextScope(Context);
+    for (void* DelegatePtr : PendingToRemove)
     {
-        for (int32 i = 0; i < PendingToRemoveJsCallbacks.size(); i++)
+        // may have been released already, or the address reused by a delegate with a living owner
+        auto Iter = DelegateMap.find(DelegatePtr);
+        if (Iter == DelegateMap.end() || Iter->second.Owner.IsValid())
         {
-            JsCallbackPrototypeMap.erase(PendingToRemoveJsCallbacks[i]);
+            continue;
         }
+        ClearDelegate(Isolate, Context, DelegatePtr);
+        EraseDelegate(DelegateMap.find(DelegatePtr));
+        INC_DWORD_STAT(STAT_PuertsDeadDelegatesReleased);
     }
 
     return true;
@@ -3531,6 +3757,7 @@ void FJsEnvImpl::Start(const FString& ModuleNameOrScript, const TArray<TPair<FSt
         return;
     }
 
+    FScriptTimeScope ScriptTimeScope(this);
     auto Isolate = MainIsolate;
 #ifdef THREAD_SAFE
     v8::Locker Locker(Isolate);
@@ -3734,19 +3961,29 @@ v8::MaybeLocal<v8::Module> FJsEnvImpl::FetchESModuleTree(v8::Local<v8::Context>
     }
 
     Logger->Info(FString::Printf(TEXT("Fetch ES Module: %s"), *FileName));
+    PUERTS_TRACE_SCOPE_TEXT(TEXT("FetchESModule ") + FileName);
     TArray<uint8> Data;
-    if (!ModuleLoader->Load(FileName, Data))
-    {
-        FV8Utils::ThrowException(MainIsolate, FString::Printf(TEXT("can not load [%s]"), *FileName));
-        return v8::MaybeLocal<v8::Module>();
-    }
-
     v8::Local<v8::String> Source;
 
     v8::ScriptCompiler::CachedData* CachedCode = nullptr;
     v8::ScriptCompiler::CompileOptions Options = v8::ScriptCompiler::CompileOptions::kNoCompileOptions;
+    FModuleContentView View;
+    if (ModuleLoader->LoadView(FileName, View) && NewSourceFromView(Isolate, View).ToLocal(&Source))
+    {
+        if (View.CodeCacheSize > 0)
+        {
+            // BufferNotOwned, the cache lives as long as the source
+            CachedCode = new v8::ScriptCompiler::CachedData(View.CodeCache, View.CodeCacheSize);
+            Options = v8::ScriptCompiler::CompileOptions::kConsumeCodeCache;
+        }
+    }
+    else if (!ModuleLoader->Load(FileName, Data))
+    {
+        FV8Utils::ThrowException(MainIsolate, FString::Printf(TEXT("can not load [%s]"), *FileName));
+        return v8::MaybeLocal<v8::Module>();
+    }
 #if defined(WITH_V8_BYTECODE)
-    if (FileName.EndsWith(TEXT(".mbc")))
+    else if (FileName.EndsWith(TEXT(".mbc")))
     {
         FCodeCacheHeader* CodeCacheHeader = (FCodeCacheHeader*) Data.GetData();
         if (CodeCacheHeader->FlagHash != Expect_FlagHash)
@@ -3775,8 +4012,8 @@ v8::MaybeLocal<v8::Module> FJsEnvImpl::FetchESModuleTree(v8::Local<v8::Context>
         Options = v8::ScriptCompiler::CompileOptions::kConsumeCodeCache;
         Source = Ret.As<v8::String>();
     }
-    else
 #endif
+    else
     {
         FString Script;
         FFileHelper::BufferToString(Script, Data.GetData(), Data.Num());
@@ -3875,6 +4112,7 @@ v8::MaybeLocal<v8::Module> FJsEnvImpl::FetchESModuleTree(v8::Local<v8::Context>
 
 void FJsEnvImpl::ExecuteModule(const FString& ModuleName)
 {
+    PUERTS_TRACE_SCOPE_TEXT(TEXT("ExecuteModule ") + ModuleName);
     FString OutPath;
     FString DebugPath;
     TArray<uint8> Data;
@@ -4138,6 +4376,15 @@ void FJsEnvImpl::LoadModule(const v8::FunctionCallbackInfo<v8::Value>& Info)
     CHECK_V8_ARGS(EArgString);
 
     FString Path = FV8Utils::ToFString(Isolate, Info[0]);
+    PUERTS_TRACE_SCOPE_TEXT(TEXT("LoadModule ") + Path);
+    FModuleContentView View;
+    v8::Local<v8::String> Source;
+    if (ModuleLoader->LoadView(Path, View) && NewSourceFromView(Isolate, View).ToLocal(&Source))
+    {
+        Info.GetReturnValue().Set(Source);
+        return;
+    }
+
     TArray<uint8> Data;
     if (!ModuleLoader->Load(Path, Data))
     {
@@ -4163,34 +4410,45 @@ void FJsEnvImpl::SetTimeout(const v8::FunctionCallbackInfo<v8::Value>& Info)
 {
     CHECK_V8_ARGS(EArgFunction, EArgNumber);
 
-    SetFTickerDelegate(Info, false);
+    AddTimer(Info, false);
 }
 
-void FJsEnvImpl::SetFTickerDelegate(const v8::FunctionCallbackInfo<v8::Value>& Info, bool Continue)
+void FJsEnvImpl::AddTimer(const v8::FunctionCallbackInfo<v8::Value>& Info, bool Continue)
 {
     v8::Isolate* Isolate = Info.GetIsolate();
     v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
 
-    while (!(++TimerID))    // TimerID > 0
+    while (!(++TimerID) || TimerInfos.find(TimerID) != TimerInfos.end())    // TimerID > 0
     {
     }
     uint32_t DelegateHandleId = TimerID;
-    FTimerInfo& TimerInfo = TimerInfos.Emplace(DelegateHandleId, FTimerInfo());
+    FTimerInfo& TimerInfo =
+        TimerInfos.emplace(std::piecewise_construct, std::forward_as_tuple(DelegateHandleId), std::forward_as_tuple())
+            .first->second;
     TimerInfo.Callback.Reset(Isolate, v8::Local<v8::Function>::Cast(Info[0]));
+    TimerInfo.Id = DelegateHandleId;
+    TimerInfo.Continue = Continue;
 
-    float Millisecond = Info[1]->NumberValue(Context).ToChecked();
-    float Delay = Millisecond / 1000.f;
+    double Millisecond = Info[1]->NumberValue(Context).ToChecked();
+    TimerInfo.IntervalMs = Millisecond > 0 ? static_cast<uint64>(FMath::CeilToDouble(Millisecond)) : 0;
 
-    TimerInfo.TickerHandle =
-        FUETicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, DelegateHandleId, Continue](float)
-                                                 { return this->TimerCallback(DelegateHandleId, Continue); }),
-            Delay);
+    TimerWheel.Schedule(&TimerInfo, TimerWheel.Now() + TimerInfo.IntervalMs);
 
     Info.GetReturnValue().Set(DelegateHandleId);
 }
 
-bool FJsEnvImpl::TimerCallback(int DelegateHandleId, bool Continue)
+bool FJsEnvImpl::TickTimers(float DeltaTime)
 {
+    TimerElapsedSeconds += DeltaTime;
+
+    FTimerWheel::FList Expired;
+    TimerWheel.Advance(static_cast<uint64>(TimerElapsedSeconds * 1000), Expired);
+    if (Expired.IsEmpty())
+    {
+        return true;
+    }
+
+    FScriptTimeScope ScriptTimeScope(this);
     v8::Isolate* Isolate = MainIsolate;
 #ifdef SINGLE_THREAD_VERIFY
     ensureMsgf(BoundThreadId == FPlatformTLS::GetCurrentThreadId(), TEXT("Access by illegal thread!"));
@@ -4204,44 +4462,50 @@ bool FJsEnvImpl::TimerCallback(int DelegateHandleId, bool Continue)
     v8::Local<v8::Context> Context = DefaultContext.Get(Isolate);
     v8::Context::Scope ContextScope(Context);
 
-    FTimerInfo* PTimeInfo = TimerInfos.Find(DelegateHandleId);
-    if (!PTimeInfo)
+    // clearTimeout inside a callback unlinks the cleared timer from Expired as well, so always pop from the head
+    while (FTimerWheel::FNode* Node = Expired.PopFront())
     {
-        Logger->Warn(FString::Printf(TEXT("Try to callback a invalid timer: %d"), DelegateHandleId));
-        return false;
-    }
-
-    auto OriginHandle = PTimeInfo->TickerHandle;
-    v8::Local<v8::Function> Function = TimerInfos[DelegateHandleId].Callback.Get(Isolate);
+        FTimerInfo* TimerInfo = static_cast<FTimerInfo*>(Node);
+        const uint32_t DelegateHandleId = TimerInfo->Id;
 
-    v8::TryCatch TryCatch(Isolate);
-    (void) (Function->Call(Context, Context->Global(), 0, nullptr));
+        {
+            v8::HandleScope CallbackScope(Isolate);
+            v8::Local<v8::Function> Function = TimerInfo->Callback.Get(Isolate);
+            PUERTS_TRACE_SCOPE_TEXT(TEXT("Timer ") + FV8Utils::ToFString(Isolate, Function->GetDebugName()));
 
-    if (TryCatch.HasCaught())
-    {
-        FString Message =
-            FString::Printf(TEXT("Exception in Timer Callback: %s"), *(FV8Utils::TryCatchToString(Isolate, &TryCatch)));
-        Logger->Error(Message);
-    }
+            v8::TryCatch TryCatch(Isolate);
+            (void) (Function->Call(Context, Context->Global(), 0, nullptr));
 
-    auto ClearInCallback = !TimerInfos.Contains(DelegateHandleId) || (OriginHandle != TimerInfos[DelegateHandleId].TickerHandle);
+            if (TryCatch.HasCaught())
+            {
+                FString Message =
+                    FString::Printf(TEXT("Exception in Timer Callback: %s"), *(FV8Utils::TryCatchToString(Isolate, &TryCatch)));
+                Logger->Error(Message);
+            }
+        }
 
-    if (!Continue && !ClearInCallback)
-    {
-        RemoveFTickerDelegateHandle(DelegateHandleId);
+        auto Iter = TimerInfos.find(DelegateHandleId);
+        if (Iter == TimerInfos.end())    // cleared in callback
+        {
+            continue;
+        }
+        if (Iter->second.Continue)
+        {
+            TimerWheel.Schedule(&Iter->second, TimerWheel.Now() + Iter->second.IntervalMs);
+        }
+        else
+        {
+            TimerInfos.erase(Iter);
+        }
     }
 
-    return Continue && !ClearInCallback;
+    return true;
 }
 
-void FJsEnvImpl::RemoveFTickerDelegateHandle(int DelegateHandleId)
+void FJsEnvImpl::RemoveTimer(uint32_t DelegateHandleId)
 {
-    if (!TimerInfos.Contains(DelegateHandleId))
-    {
-        return;
-    }
-    FUETicker::GetCoreTicker().RemoveTicker(TimerInfos[DelegateHandleId].TickerHandle);
-    TimerInfos.Remove(DelegateHandleId);
+    // erasing the info unlinks it from whatever list of the wheel it is in
+    TimerInfos.erase(DelegateHandleId);
 }
 
 void FJsEnvImpl::ClearInterval(const v8::FunctionCallbackInfo<v8::Value>& Info)
@@ -4263,7 +4527,7 @@ void FJsEnvImpl::ClearInterval(const v8::FunctionCallbackInfo<v8::Value>& Info)
     {
         CHECK_V8_ARGS(EArgInt32);
         int HandleId = Info[0]->Int32Value(Context).ToChecked();
-        RemoveFTickerDelegateHandle(HandleId);
+        RemoveTimer(static_cast<uint32_t>(HandleId));
     }
 }
 
@@ -4277,7 +4541,436 @@ void FJsEnvImpl::SetInterval(const v8::FunctionCallbackInfo<v8::Value>& Info)
 
     CHECK_V8_ARGS(EArgFunction, EArgNumber);
 
-    SetFTickerDelegate(Info, true);
+    AddTimer(Info, true);
+}
+
+void FJsEnvImpl::RequestAnimationFrame(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+
+    CHECK_V8_ARGS(EArgFunction);
+
+    while (!(++FrameCallbackID))    // FrameCallbackID > 0
+    {
+    }
+    AnimationFrameCallbacks.push_back(
+        {FrameCallbackID, v8::Global<v8::Function>(Isolate, Info[0].As<v8::Function>()), 0, EFrameCallbackKind::AnimationFrame});
+
+    Info.GetReturnValue().Set(FrameCallbackID);
+}
+
+void FJsEnvImpl::CancelFrameCallback(std::vector<FFrameCallbackInfo>& Callbacks, EFrameCallbackKind Kind, uint32_t Id)
+{
+    // pending lists are never iterated while script runs, so the entry goes away at once instead of lingering (an idle
+    // callback would otherwise keep being scanned for its timeout every frame)
+    for (auto It = Callbacks.begin(); It != Callbacks.end(); ++It)
+    {
+        if (It->Id == Id && It->Kind == Kind)
+        {
+            Callbacks.erase(It);
+            return;
+        }
+    }
+
+    // the callback may be canceled by another one fired in the same frame, that list is being walked so only clear it
+    for (auto& Callback : FiringFrameCallbacks)
+    {
+        if (Callback.Id == Id && Callback.Kind == Kind)
+        {
+            Callback.Callback.Reset();
+            return;
+        }
+    }
+}
+
+void FJsEnvImpl::CancelAnimationFrame(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    if (Info.Length() == 0 || Info[0]->IsNullOrUndefined())
+    {
+        return;
+    }
+    CHECK_V8_ARGS(EArgInt32);
+    CancelFrameCallback(AnimationFrameCallbacks, EFrameCallbackKind::AnimationFrame, static_cast<uint32_t>(Info[0]->Int32Value(Context).ToChecked()));
+}
+
+void FJsEnvImpl::RequestIdleCallback(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    CHECK_V8_ARGS(EArgFunction);
+
+    double TimeoutAt = 0;
+    if (Info.Length() > 1 && Info[1]->IsObject())
+    {
+        auto Options = Info[1].As<v8::Object>();
+        auto MaybeTimeout = Options->Get(Context, FV8Utils::ToV8String(Isolate, "timeout"));
+        if (!MaybeTimeout.IsEmpty() && MaybeTimeout.ToLocalChecked()->IsNumber())
+        {
+            double Timeout = MaybeTimeout.ToLocalChecked()->NumberValue(Context).ToChecked();
+            if (Timeout > 0)
+            {
+                TimeoutAt = FPlatformTime::Seconds() + Timeout / 1000.0;
+            }
+        }
+    }
+
+    while (!(++FrameCallbackID))    // FrameCallbackID > 0
+    {
+    }
+    IdleCallbacks.push_back(
+        {FrameCallbackID, v8::Global<v8::Function>(Isolate, Info[0].As<v8::Function>()), TimeoutAt, EFrameCallbackKind::Idle});
+
+    Info.GetReturnValue().Set(FrameCallbackID);
+}
+
+void FJsEnvImpl::CancelIdleCallback(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    if (Info.Length() == 0 || Info[0]->IsNullOrUndefined())
+    {
+        return;
+    }
+    CHECK_V8_ARGS(EArgInt32);
+    CancelFrameCallback(IdleCallbacks, EFrameCallbackKind::Idle, static_cast<uint32_t>(Info[0]->Int32Value(Context).ToChecked()));
+}
+
+void FJsEnvImpl::IdleDeadlineTimeRemaining(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    double Remaining = IdleDeadlineSeconds - FPlatformTime::Seconds();
+    Info.GetReturnValue().Set(Remaining > 0 ? Remaining * 1000.0 : 0.0);
+}
+
+void FJsEnvImpl::GetFrameDeadline(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    // same clock as the timestamp passed to requestAnimationFrame callbacks
+    Info.GetReturnValue().Set((ScriptDeadlineSeconds - FrameClockOrigin) * 1000.0);
+}
+
+void FJsEnvImpl::FrameTimeRemaining(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    double Remaining = ScriptDeadlineSeconds - FPlatformTime::Seconds();
+    Info.GetReturnValue().Set(Remaining > 0 ? Remaining * 1000.0 : 0.0);
+}
+
+void FJsEnvImpl::ScheduleContinuation(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    CHECK_V8_ARGS(EArgFunction);
+
+    while (!(++FrameCallbackID))    // FrameCallbackID > 0
+    {
+    }
+    Continuations.push_back(
+        {FrameCallbackID, v8::Global<v8::Function>(Isolate, Info[0].As<v8::Function>()), 0, EFrameCallbackKind::Continuation});
+
+    Info.GetReturnValue().Set(FrameCallbackID);
+}
+
+void FJsEnvImpl::CancelContinuation(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    if (Info.Length() == 0 || Info[0]->IsNullOrUndefined())
+    {
+        return;
+    }
+    CHECK_V8_ARGS(EArgInt32);
+    CancelFrameCallback(Continuations, EFrameCallbackKind::Continuation, static_cast<uint32_t>(Info[0]->Int32Value(Context).ToChecked()));
+}
+
+void FJsEnvImpl::GetFrameStats(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+    auto Bounds = v8::Array::New(Isolate, FrameScriptHistogramBuckets - 1);
+    auto Histogram = v8::Array::New(Isolate, FrameScriptHistogramBuckets);
+    for (int i = 0; i < FrameScriptHistogramBuckets; ++i)
+    {
+        if (i < FrameScriptHistogramBuckets - 1)
+        {
+            (void) (Bounds->Set(Context, i, v8::Number::New(Isolate, FrameScriptHistogramBoundsMs[i])));
+        }
+        (void) (Histogram->Set(Context, i, v8::Integer::NewFromUnsigned(Isolate, FrameScriptHistogram[i])));
+    }
+
+    auto Result = v8::Object::New(Isolate);
+    (void) (Result->Set(Context, FV8Utils::ToV8String(Isolate, "frames"), v8::Integer::NewFromUnsigned(Isolate, FramesSampled)));
+    (void) (Result->Set(Context, FV8Utils::ToV8String(Isolate, "lastMs"), v8::Number::New(Isolate, LastFrameScriptMs)));
+    (void) (Result->Set(Context, FV8Utils::ToV8String(Isolate, "maxMs"), v8::Number::New(Isolate, MaxFrameScriptMs)));
+    (void) (Result->Set(Context, FV8Utils::ToV8String(Isolate, "budgetMs"),
+        v8::Number::New(Isolate, GetFrameBudgetSeconds() * ScriptFrameBudgetRatio * 1000.0)));
+    (void) (Result->Set(Context, FV8Utils::ToV8String(Isolate, "boundsMs"), Bounds));
+    (void) (Result->Set(Context, FV8Utils::ToV8String(Isolate, "histogram"), Histogram));
+    (void) (Result->Set(Context, FV8Utils::ToV8String(Isolate, "pendingContinuations"),
+        v8::Integer::NewFromUnsigned(Isolate, static_cast<uint32_t>(Continuations.size()))));
+    Info.GetReturnValue().Set(Result);
+
+    if (Info.Length() > 0 && Info[0]->BooleanValue(Isolate))
+    {
+        FMemory::Memzero(FrameScriptHistogram);
+        FramesSampled = 0;
+        MaxFrameScriptMs = 0;
+    }
+}
+
+void FJsEnvImpl::RecordFrameScriptTime()
+{
+    // ScriptCycles only grows when an outermost FScriptTimeScope closes, so this is the js time of the last frame
+    const double FrameMs = FPlatformTime::ToMilliseconds64(ScriptCycles - FrameScriptCyclesBase);
+    FrameScriptCyclesBase = ScriptCycles;
+
+    int Bucket = 0;
+    while (Bucket < FrameScriptHistogramBuckets - 1 && FrameMs >= FrameScriptHistogramBoundsMs[Bucket])
+    {
+        ++Bucket;
+    }
+    ++FrameScriptHistogram[Bucket];
+    ++FramesSampled;
+    LastFrameScriptMs = FrameMs;
+    MaxFrameScriptMs = FMath::Max(MaxFrameScriptMs, FrameMs);
+    INC_FLOAT_STAT_BY(STAT_PuertsScriptFrameMs, FrameMs);
+}
+
+void FJsEnvImpl::RunContinuations(v8::Isolate* Isolate, v8::Local<v8::Context> Context)
+{
+    v8::Local<v8::Value> Args[] = {v8::Number::New(Isolate, (ScriptDeadlineSeconds - FrameClockOrigin) * 1000.0)};
+
+    // continuations scheduled by continuations may still run in this frame, at least one runs per frame so work always
+    // progresses even when animation frame callbacks used up the budget
+    bool RanAny = false;
+    while (!Continuations.empty())
+    {
+        std::vector<FFrameCallbackInfo>& Callbacks = FiringFrameCallbacks;
+        Callbacks.swap(Continuations);
+
+        size_t i = 0;
+        for (; i < Callbacks.size(); ++i)
+        {
+            if (Callbacks[i].Callback.IsEmpty())
+            {
+                continue;
+            }
+            if (RanAny && FPlatformTime::Seconds() >= ScriptDeadlineSeconds)
+            {
+                break;
+            }
+            RanAny = true;
+            v8::HandleScope CallbackScope(Isolate);
+            v8::Local<v8::Function> Function = Callbacks[i].Callback.Get(Isolate);
+            Callbacks[i].Callback.Reset();
+
+            v8::TryCatch TryCatch(Isolate);
+            (void) (Function->Call(Context, Context->Global(), 1, Args));
+
+            if (TryCatch.HasCaught())
+            {
+                Logger->Error(FString::Printf(
+                    TEXT("Exception in Continuation Callback: %s"), *(FV8Utils::TryCatchToString(Isolate, &TryCatch))));
+            }
+        }
+
+        if (i < Callbacks.size())
+        {
+            // out of budget, what is left goes first next frame
+            Continuations.insert(Continuations.begin(), std::make_move_iterator(Callbacks.begin() + i),
+                std::make_move_iterator(Callbacks.end()));
+            Callbacks.clear();
+            break;
+        }
+        Callbacks.clear();
+    }
+}
+
+double FJsEnvImpl::GetFrameBudgetSeconds() const
+{
+    if (FApp::UseFixedTimeStep())
+    {
+        return FApp::GetFixedDeltaTime();
+    }
+#if !defined(ENGINE_INDEPENDENT_JSENV)
+    if (GEngine)
+    {
+        float MaxFPS = GEngine->GetMaxFPS();
+        if (MaxFPS > 0)
+        {
+            return 1.0 / MaxFPS;
+        }
+    }
+#endif
+    return 1.0 / 60.0;
+}
+
+void FJsEnvImpl::OnBeginFrame()
+{
+    PUERTS_TRACE_WRAPPERS_NEW_FRAME();
+    FrameStartSeconds = FPlatformTime::Seconds();
+    ScriptDeadlineSeconds = FrameStartSeconds + GetFrameBudgetSeconds() * ScriptFrameBudgetRatio;
+    RecordFrameScriptTime();
+
+#if !defined(WITH_QUICKJS) && !defined(WITH_NODEJS)
+    const bool HasWorkerMessages = WorkerHost && WorkerHost->HasPendingMessages();
+#else
+    const bool HasWorkerMessages = false;
+#endif
+    if (AnimationFrameCallbacks.empty() && Continuations.empty() && !HasWorkerMessages)
+    {
+        return;
+    }
+
+    // callbacks requested while dispatching run on the next frame
+    std::vector<FFrameCallbackInfo>& Callbacks = FiringFrameCallbacks;
+    Callbacks.swap(AnimationFrameCallbacks);
+
+    FScriptTimeScope ScriptTimeScope(this);
+    v8::Isolate* Isolate = MainIsolate;
+#ifdef SINGLE_THREAD_VERIFY
+    ensureMsgf(BoundThreadId == FPlatformTLS::GetCurrentThreadId(), TEXT("Access by illegal thread!"));
+#endif
+#ifdef THREAD_SAFE
+    v8::Locker Locker(MainIsolate);
+#endif
+
+    v8::Isolate::Scope Isolatescope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = DefaultContext.Get(Isolate);
+    v8::Context::Scope ContextScope(Context);
+
+#if !defined(WITH_QUICKJS) && !defined(WITH_NODEJS)
+    // worker results are delivered before the animation frame callbacks, so those already see them
+    if (HasWorkerMessages)
+    {
+        WorkerHost->PollAll(Isolate, Context);
+    }
+#endif
+
+    v8::Local<v8::Value> Args[] = {v8::Number::New(Isolate, (FrameStartSeconds - FrameClockOrigin) * 1000.0)};
+
+    for (size_t i = 0; i < Callbacks.size(); ++i)
+    {
+        if (Callbacks[i].Callback.IsEmpty())
+        {
+            continue;
+        }
+        v8::HandleScope CallbackScope(Isolate);
+        v8::Local<v8::Function> Function = Callbacks[i].Callback.Get(Isolate);
+        Callbacks[i].Callback.Reset();
+
+        v8::TryCatch TryCatch(Isolate);
+        (void) (Function->Call(Context, Context->Global(), 1, Args));
+
+        if (TryCatch.HasCaught())
+        {
+            Logger->Error(FString::Printf(
+                TEXT("Exception in AnimationFrame Callback: %s"), *(FV8Utils::TryCatchToString(Isolate, &TryCatch))));
+        }
+    }
+    Callbacks.clear();
+
+    RunContinuations(Isolate, Context);
+}
+
+void FJsEnvImpl::OnEndFrame()
+{
+    const double Now = FPlatformTime::Seconds();
+    IdleDeadlineSeconds = FrameStartSeconds + GetFrameBudgetSeconds();
+
+    if (!IdleCallbacks.empty())
+    {
+        bool HasIdleTime = IdleDeadlineSeconds > Now;
+        bool HasTimeout = false;
+        for (auto& Callback : IdleCallbacks)
+        {
+            if (Callback.TimeoutAt > 0 && Callback.TimeoutAt <= Now)
+            {
+                HasTimeout = true;
+                break;
+            }
+        }
+
+        if (HasIdleTime || HasTimeout)
+        {
+            std::vector<FFrameCallbackInfo>& Callbacks = FiringFrameCallbacks;
+            Callbacks.swap(IdleCallbacks);
+
+            FScriptTimeScope ScriptTimeScope(this);
+            v8::Isolate* Isolate = MainIsolate;
+#ifdef SINGLE_THREAD_VERIFY
+            ensureMsgf(BoundThreadId == FPlatformTLS::GetCurrentThreadId(), TEXT("Access by illegal thread!"));
+#endif
+#ifdef THREAD_SAFE
+            v8::Locker Locker(MainIsolate);
+#endif
+
+            v8::Isolate::Scope Isolatescope(Isolate);
+            v8::HandleScope HandleScope(Isolate);
+            v8::Local<v8::Context> Context = DefaultContext.Get(Isolate);
+            v8::Context::Scope ContextScope(Context);
+
+            auto TimeRemaining = v8::FunctionTemplate::New(
+                Isolate,
+                [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+                {
+                    auto Self = static_cast<FJsEnvImpl*>((v8::Local<v8::External>::Cast(Info.Data()))->Value());
+                    Self->IdleDeadlineTimeRemaining(Info);
+                },
+                v8::External::New(Isolate, this))
+                                     ->GetFunction(Context)
+                                     .ToLocalChecked();
+
+            for (size_t i = 0; i < Callbacks.size(); ++i)
+            {
+                if (Callbacks[i].Callback.IsEmpty())
+                {
+                    continue;
+                }
+                const double CallbackNow = FPlatformTime::Seconds();
+                const bool DidTimeout = Callbacks[i].TimeoutAt > 0 && Callbacks[i].TimeoutAt <= CallbackNow;
+                if (!DidTimeout && IdleDeadlineSeconds <= CallbackNow)
+                {
+                    // out of budget, keep it for the next frame
+                    IdleCallbacks.push_back(std::move(Callbacks[i]));
+                    continue;
+                }
+
+                v8::HandleScope CallbackScope(Isolate);
+                v8::Local<v8::Function> Function = Callbacks[i].Callback.Get(Isolate);
+                Callbacks[i].Callback.Reset();
+
+                auto Deadline = v8::Object::New(Isolate);
+                Deadline->Set(Context, FV8Utils::ToV8String(Isolate, "didTimeout"), v8::Boolean::New(Isolate, DidTimeout)).Check();
+                Deadline->Set(Context, FV8Utils::ToV8String(Isolate, "timeRemaining"), TimeRemaining).Check();
+                v8::Local<v8::Value> Args[] = {Deadline};
+
+                v8::TryCatch TryCatch(Isolate);
+                (void) (Function->Call(Context, Context->Global(), 1, Args));
+
+                if (TryCatch.HasCaught())
+                {
+                    Logger->Error(FString::Printf(
+                        TEXT("Exception in IdleCallback: %s"), *(FV8Utils::TryCatchToString(Isolate, &TryCatch))));
+                }
+            }
+            Callbacks.clear();
+        }
+    }
+
+#ifndef WITH_QUICKJS
+    GCPolicy->OnEndFrame(IdleDeadlineSeconds - FPlatformTime::Seconds());
+    if (CpuProfiler)
+    {
+        CpuProfiler->OnEndFrame();
+    }
+#endif
 }
 
 #if !defined(ENGINE_INDEPENDENT_JSENV)
@@ -4615,14 +5308,23 @@ void FJsEnvImpl::ReadImageFileAsTexture2D(const v8::FunctionCallbackInfo<v8::Val
     CHECK_V8_ARGS(EArgString);
 
     const FString ImagePath = FV8Utils::ToFString(Isolate, Info[0]);
-    if (FPaths::FileExists(ImagePath))
+    const FScriptArchive& Archive = FScriptArchive::Get();
+    UTexture2D* Texture = nullptr;
+    if (const FScriptArchive::FEntry* Entry = Archive.Find(ImagePath))
     {
-        if (UTexture2D* Texture = UKismetRenderingLibrary::ImportFileAsTexture2D(nullptr, ImagePath))
-        {
-            auto Result = FV8Utils::IsolateData<IObjectMapper>(Isolate)->FindOrAdd(Isolate, Context, Texture->GetClass(), Texture);
-            Info.GetReturnValue().Set(Result);
-            return;
-        }
+        TArray<uint8> Buffer(Archive.GetData(*Entry), (int32) Entry->Size);
+        Texture = UKismetRenderingLibrary::ImportBufferAsTexture2D(nullptr, Buffer);
+    }
+    else if (FPaths::FileExists(ImagePath))
+    {
+        Texture = UKismetRenderingLibrary::ImportFileAsTexture2D(nullptr, ImagePath);
+    }
+
+    if (Texture)
+    {
+        auto Result = FV8Utils::IsolateData<IObjectMapper>(Isolate)->FindOrAdd(Isolate, Context, Texture->GetClass(), Texture);
+        Info.GetReturnValue().Set(Result);
+        return;
     }
 
     FV8Utils::ThrowException(Isolate, FString::Printf(TEXT("Image path not exist: %s"), *ImagePath));
@@ -4639,15 +5341,12 @@ void FJsEnvImpl::ReadTextFileContent(const v8::FunctionCallbackInfo<v8::Value>&
     CHECK_V8_ARGS(EArgString);
 
     const FString TextFilePath = FV8Utils::ToFString(Isolate, Info[0]);
-    if (FPaths::FileExists(TextFilePath))
+    FString OutContent;
+    if (FScriptArchive::Get().LoadFileToString(TextFilePath, OutContent))
     {
-        FString OutContent;
-        if (FFileHelper::LoadFileToString(OutContent, *TextFilePath))
-        {
-            const auto Result = FV8Utils::ToV8String(Isolate, OutContent);
-            Info.GetReturnValue().Set(Result);
-            return;
-        }
+        const auto Result = FV8Utils::ToV8String(Isolate, OutContent);
+        Info.GetReturnValue().Set(Result);
+        return;
     }
 
     FV8Utils::ThrowException(Isolate, FString::Printf(TEXT("Text file path not exist: %s"), *TextFilePath));
@@ -22,6 +22,10 @@
 #include "UECompatible.h"
 #include "ContainerMeta.h"
 #include "ObjectCacheNode.h"
+#include "TimerWheel.h"
+#include "JsWorker.h"
+#include "JsEnvGCPolicy.h"
+#include "JsEnvCpuProfiler.h"
 #include <unordered_map>
 
 #if ENGINE_MINOR_VERSION >= 25 || ENGINE_MAJOR_VERSION > 4
@@ -104,14 +108,18 @@ public:
         const auto startTime = FDateTime::Now();
         while (Inspector && !Inspector->Tick())
         {
+            int WaitMilliseconds = 50;
             if (timeout > 0)
             {
-                auto now = FDateTime::Now();
-                if ((now - startTime).GetTotalSeconds() >= timeout)
+                const double Remaining = timeout - (FDateTime::Now() - startTime).GetTotalSeconds();
+                if (Remaining <= 0)
                 {
                     break;
                 }
+                WaitMilliseconds = FMath::Min(WaitMilliseconds, FMath::CeilToInt(Remaining * 1000));
             }
+            // sleep until the front-end connects instead of spinning the game thread
+            Inspector->WaitForEvents(WaitMilliseconds);
         }
     }
 
@@ -139,6 +147,14 @@ public:
 
     virtual void ForceReloadJsFile(const FString& ModuleName) override;
 
+    virtual void GetLoadStats(FJsEnvLoadStats& OutStats) override;
+
+    virtual void SetHeapLimits(const FJsEnvHeapLimits& Limits) override;
+
+    virtual bool StartCpuProfiling(int32 SamplingIntervalUs, bool bFrameStats) override;
+
+    virtual bool StopCpuProfiling(const FString& OutBasePath) override;
+
 public:
     bool IsTypeScriptGeneratedClass(UClass* Class);
 
@@ -318,16 +334,46 @@ private:
 
     void SetTimeout(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
-    void SetFTickerDelegate(const v8::FunctionCallbackInfo<v8::Value>& Info, bool Continue);
+    void AddTimer(const v8::FunctionCallbackInfo<v8::Value>& Info, bool Continue);
 
-    bool TimerCallback(int DelegateHandleId, bool Continue);
+    bool TickTimers(float DeltaTime);
 
-    void RemoveFTickerDelegateHandle(int HandleId);
+    void RemoveTimer(uint32_t HandleId);
 
     void SetInterval(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
     void ClearInterval(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
+    void RequestAnimationFrame(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void CancelAnimationFrame(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void RequestIdleCallback(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void CancelIdleCallback(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void IdleDeadlineTimeRemaining(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void GetFrameDeadline(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void FrameTimeRemaining(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void ScheduleContinuation(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void CancelContinuation(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void GetFrameStats(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void RunContinuations(v8::Isolate* Isolate, v8::Local<v8::Context> Context);
+
+    void RecordFrameScriptTime();
+
+    void OnBeginFrame();
+
+    void OnEndFrame();
+
+    double GetFrameBudgetSeconds() const;
+
     void MergeObject(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
     void NewObjectByClass(const v8::FunctionCallbackInfo<v8::Value>& Info);
@@ -616,7 +662,7 @@ private:
 
     std::map<PropertyMacro*, ContainerPropertyInfo> ContainerPropertyMap;
 
-    std::map<UFunction*, std::unique_ptr<FFunctionTranslator>> JsCallbackPrototypeMap;
+    std::unordered_map<UFunction*, std::unique_ptr<FFunctionTranslator>> JsCallbackPrototypeMap;
 
     std::map<UStruct*, std::unique_ptr<ObjectMerger>> ObjectMergers;
 
@@ -630,6 +676,7 @@ private:
         bool PassByPointer;
         TWeakObjectPtr<UDynamicDelegateProxy> Proxy;
         v8::UniquePersistent<v8::Array> JsCallbacks;
+        UObject* OwnerKey;    // key in DelegatesOfOwner, stays valid for lookup after Owner dies
     };
 
     struct TsFunctionInfo
@@ -700,7 +747,19 @@ private:
 
     v8::UniquePersistent<v8::FunctionTemplate> SoftObjectPtrTemplate;
 
-    std::map<void*, DelegateObjectInfo> DelegateMap;
+    typedef std::unordered_map<void*, DelegateObjectInfo> FDelegateMap;
+
+    FDelegateMap DelegateMap;
+
+    // owner -> delegates it owns, so a dead owner is found from NotifyUObjectDeleted instead of scanning DelegateMap
+    TMap<UObject*, TArray<void*>> DelegatesOfOwner;
+
+    // delegates whose owner died (or never had one), released by CheckDelegateProxies
+    std::vector<void*> DeadOwnerDelegates;
+
+    void AddDelegate(void* DelegatePtr, DelegateObjectInfo&& Info);
+
+    void EraseDelegate(FDelegateMap::iterator Iter);
 
     TMap<UFunction*, TsFunctionInfo> TsFunctionMap;
 
@@ -710,13 +769,109 @@ private:
 
     bool ExtensionMethodsMapInited = false;
 
-    struct FTimerInfo
+    struct FTimerInfo : FTimerWheel::FNode
     {
         v8::Global<v8::Function> Callback;
-        FUETickDelegateHandle TickerHandle;
+        uint32_t Id = 0;
+        uint64 IntervalMs = 0;
+        bool Continue = false;
     };
     uint32_t TimerID = 0;
-    TMap<uint32_t, FTimerInfo> TimerInfos;
+    // node based, FTimerInfo must not move while it is linked in TimerWheel
+    std::unordered_map<uint32_t, FTimerInfo> TimerInfos;
+
+    FTimerWheel TimerWheel;
+
+    double TimerElapsedSeconds = 0;
+
+    // cycles spent in js entered from native, nested entries (js -> ue -> js) are counted once by the outermost scope
+    uint64 ScriptCycles = 0;
+
+    int32 ScriptCallDepth = 0;
+
+    struct FScriptTimeScope
+    {
+        explicit FScriptTimeScope(FJsEnvImpl* InEnv) : Env(InEnv), StartCycles(0)
+        {
+            if (Env->ScriptCallDepth++ == 0)
+            {
+                StartCycles = FPlatformTime::Cycles64();
+            }
+        }
+
+        ~FScriptTimeScope()
+        {
+            if (--Env->ScriptCallDepth == 0)
+            {
+                Env->ScriptCycles += FPlatformTime::Cycles64() - StartCycles;
+            }
+        }
+
+        FJsEnvImpl* Env;
+        uint64 StartCycles;
+    };
+
+    FUETickDelegateHandle TimerTickerHandle;
+
+#if !defined(WITH_QUICKJS) && !defined(WITH_NODEJS)
+    TUniquePtr<FJsWorkerHost> WorkerHost;
+#endif
+
+#ifndef WITH_QUICKJS
+    TUniquePtr<FJsEnvGCPolicy> GCPolicy;
+
+    TUniquePtr<FJsEnvCpuProfiler> CpuProfiler;
+#endif
+
+    // ids come from one counter, the kind keeps e.g. cancelAnimationFrame from canceling an idle callback
+    enum class EFrameCallbackKind : uint8
+    {
+        AnimationFrame,
+        Idle,
+        Continuation
+    };
+
+    struct FFrameCallbackInfo
+    {
+        uint32_t Id;
+        v8::Global<v8::Function> Callback;
+        double TimeoutAt;    // requestIdleCallback only, 0 means no timeout
+        EFrameCallbackKind Kind;
+    };
+    uint32_t FrameCallbackID = 0;
+    std::vector<FFrameCallbackInfo> AnimationFrameCallbacks;
+    std::vector<FFrameCallbackInfo> IdleCallbacks;
+    std::vector<FFrameCallbackInfo> FiringFrameCallbacks;
+    // time-sliced work (scheduler continuations), run after animation frame callbacks while the frame budget lasts
+    std::vector<FFrameCallbackInfo> Continuations;
+
+    void CancelFrameCallback(std::vector<FFrameCallbackInfo>& Callbacks, EFrameCallbackKind Kind, uint32_t Id);
+
+    double FrameClockOrigin = 0;
+
+    double FrameStartSeconds = 0;
+
+    double IdleDeadlineSeconds = 0;
+
+    // share of the frame budget script may take before shouldYield turns true
+    double ScriptDeadlineSeconds = 0;
+
+    // script time per frame, bucket i counts frames below FrameScriptHistogramBoundsMs[i], the last one the rest
+    static constexpr int FrameScriptHistogramBuckets = 8;
+
+    uint32 FrameScriptHistogram[FrameScriptHistogramBuckets] = {};
+
+    uint32 FramesSampled = 0;
+
+    double LastFrameScriptMs = 0;
+
+    double MaxFrameScriptMs = 0;
+
+    uint64 FrameScriptCyclesBase = 0;
+
+    FDelegateHandle BeginFrameHandle;
+
+    FDelegateHandle EndFrameHandle;
 
     FUETickDelegateHandle DelegateProxiesCheckerHandler;
 
@@ -10,6 +10,8 @@
 //#include "TGameJSCorePCH.h"
 #include "HAL/MemoryBase.h"
 #include "NamespaceDef.h"
+#include "ScriptArchive.h"
+#include "JsEnvTrace.h"
 PRAGMA_DISABLE_UNDEFINED_IDENTIFIER_WARNINGS
 #if defined(WITH_NODEJS)
 #pragma warning(push, 0)
@@ -23,6 +25,10 @@ PRAGMA_DISABLE_UNDEFINED_IDENTIFIER_WARNINGS
 #pragma warning(pop)
 PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS
 
+#if PUERTS_TRACE_ENABLED
+UE_TRACE_CHANNEL_DEFINE(PuertsChannel)
+#endif
+
 class FMallocWrapper final : public FMalloc
 {
 public:
@@ -241,6 +247,11 @@ void FJsEnvModule::StartupModule()
         UE_LOG(LogTemp, Error, TEXT("Initialize Node:  %s"), UTF8_TO_TCHAR(error.c_str()));
     }
 #endif
+
+#if !WITH_EDITOR
+    // loose files are used when the packed scripts are absent
+    PUERTS_NAMESPACE::FScriptArchive::Get().Mount(PUERTS_NAMESPACE::FScriptArchive::GetDefaultArchivePath());
+#endif
 }
 
 void FJsEnvModule::ShutdownModule()
@@ -258,6 +269,9 @@ void FJsEnvModule::ShutdownModule()
     v8::platform::DeletePlatform_Without_Stl(platform_);
 #endif
 
+    // external strings handed to v8 point into the archive, keep it mapped until v8 is gone
+    PUERTS_NAMESPACE::FScriptArchive::Get().Unmount();
+
 #if ENGINE_MAJOR_VERSION < 5 || ENGINE_MINOR_VERSION <= 5
     if (MallocWrapper && MallocWrapper == GMalloc)
     {
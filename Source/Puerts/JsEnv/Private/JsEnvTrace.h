@@ -0,0 +1,50 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+// Insights channel for the js <-> ue bridge, enable it with -trace=cpu,puerts or "Trace.Enable Puerts".
+// Events are only emitted while both this channel and the cpu channel are on.
+#define PUERTS_TRACE_ENABLED (CPUPROFILERTRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+#if PUERTS_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(PuertsChannel)
+
+#define PUERTS_TRACE_IS_ENABLED() bool(PuertsChannel | CpuChannel)
+
+// static event name
+#define PUERTS_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, PuertsChannel)
+
+// NameExpr (an FString expression) is evaluated once, the first time the scope is hit with the channel on,
+// SpecId (a uint32 initialized to 0) keeps the event type for later calls
+#define PUERTS_TRACE_SCOPE_CACHED(SpecId, NameExpr)                                 \
+    if (PUERTS_TRACE_IS_ENABLED() && SpecId == 0)                                   \
+    {                                                                               \
+        SpecId = FCpuProfilerTrace::OutputEventType(*FString(NameExpr));            \
+    }                                                                               \
+    FCpuProfilerTrace::FEventScope PREPROCESSOR_JOIN(__PuertsTraceScope, __LINE__)( \
+        SpecId, PuertsChannel);
+
+// NameExpr is evaluated on every hit while the channel is on, for names that are not known up front
+#define PUERTS_TRACE_SCOPE_TEXT(NameExpr)                                                  \
+    FCpuProfilerTrace::FDynamicEventScope PREPROCESSOR_JOIN(__PuertsTraceScope, __LINE__)( \
+        PUERTS_TRACE_IS_ENABLED() ? *FString(NameExpr) : TEXT(""), PuertsChannel);
+
+#else
+
+#define PUERTS_TRACE_IS_ENABLED() false
+#define PUERTS_TRACE_SCOPE(Name)
+#define PUERTS_TRACE_SCOPE_CACHED(SpecId, NameExpr)
+#define PUERTS_TRACE_SCOPE_TEXT(NameExpr)
+
+#endif
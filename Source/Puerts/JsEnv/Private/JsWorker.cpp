@@ -0,0 +1,710 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#include "JsWorker.h"
+
+#if !defined(WITH_QUICKJS) && !defined(WITH_NODEJS)
+
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+#include "DataTransfer.h"
+#include "JSLogger.h"
+#include "V8Utils.h"
+
+namespace PUERTS_NAMESPACE
+{
+FJsWorkerMessage::~FJsWorkerMessage()
+{
+    if (Data)
+    {
+        FMemory::Free(Data);
+    }
+    for (auto& Pair : Transferred)
+    {
+        if (Pair.Key)
+        {
+            FMemory::Free(Pair.Key);
+        }
+    }
+}
+
+// the serializer buffer is allocated with FMemory so the message can own and free it on any thread
+class FMessageSerializerDelegate : public v8::ValueSerializer::Delegate
+{
+public:
+    explicit FMessageSerializerDelegate(v8::Isolate* InIsolate) : Isolate(InIsolate)
+    {
+    }
+
+    virtual void ThrowDataCloneError(v8::Local<v8::String> Message) override
+    {
+        Isolate->ThrowException(v8::Exception::Error(Message));
+    }
+
+    virtual void* ReallocateBufferMemory(void* OldBuffer, size_t Size, size_t* ActualSize) override
+    {
+        *ActualSize = Size;
+        return FMemory::Realloc(OldBuffer, Size);
+    }
+
+    virtual void FreeBufferMemory(void* Buffer) override
+    {
+        FMemory::Free(Buffer);
+    }
+
+private:
+    v8::Isolate* Isolate;
+};
+
+// structured clone of Value, ArrayBuffers listed in Transfer are moved into the message and detached in the sender.
+// returns null with an exception pending in Isolate if the value can not be cloned
+static TUniquePtr<FJsWorkerMessage> SerializeMessage(
+    v8::Isolate* Isolate, v8::Local<v8::Context> Context, v8::Local<v8::Value> Value, v8::Local<v8::Value> Transfer)
+{
+    FMessageSerializerDelegate Delegate(Isolate);
+    v8::ValueSerializer Serializer(Isolate, &Delegate);
+
+    TArray<v8::Local<v8::ArrayBuffer>, TInlineAllocator<4>> Buffers;
+    if (!Transfer.IsEmpty() && Transfer->IsArray())
+    {
+        v8::Local<v8::Array> TransferList = Transfer.As<v8::Array>();
+        for (uint32_t i = 0; i < TransferList->Length(); ++i)
+        {
+            v8::Local<v8::Value> Item;
+            if (!TransferList->Get(Context, i).ToLocal(&Item) || !Item->IsArrayBuffer())
+            {
+                FV8Utils::ThrowException(Isolate, "only ArrayBuffer can be transferred");
+                return nullptr;
+            }
+            v8::Local<v8::ArrayBuffer> Buffer = Item.As<v8::ArrayBuffer>();
+            if (!Buffer->IsDetachable() || Buffers.Contains(Buffer))
+            {
+                FV8Utils::ThrowException(Isolate, "ArrayBuffer can not be transferred");
+                return nullptr;
+            }
+            Serializer.TransferArrayBuffer(Buffers.Num(), Buffer);
+            Buffers.Add(Buffer);
+        }
+    }
+    else if (!Transfer.IsEmpty() && !Transfer->IsNullOrUndefined())
+    {
+        FV8Utils::ThrowException(Isolate, "transfer list must be an array");
+        return nullptr;
+    }
+
+    Serializer.WriteHeader();
+    if (!Serializer.WriteValue(Context, Value).FromMaybe(false))
+    {
+        return nullptr;
+    }
+
+    auto Message = MakeUnique<FJsWorkerMessage>();
+    std::pair<uint8_t*, size_t> Output = Serializer.Release();
+    Message->Data = Output.first;
+    Message->Size = Output.second;
+
+    // the contents are copied once, the receiving isolate adopts the copy without another one
+    for (auto& Buffer : Buffers)
+    {
+        size_t Length = 0;
+        void* Contents = DataTransfer::GetArrayBufferData(Buffer, Length);
+        void* Copy = FMemory::Malloc(FMath::Max<size_t>(Length, 1));
+        if (Length > 0)
+        {
+            FMemory::Memcpy(Copy, Contents, Length);
+        }
+        Message->Transferred.Add(TPair<void*, size_t>(Copy, Length));
+#if V8_MAJOR_VERSION >= 11
+        (void) Buffer->Detach(v8::Local<v8::Value>());
+#else
+        Buffer->Detach();
+#endif
+    }
+    return Message;
+}
+
+static v8::Local<v8::ArrayBuffer> AdoptArrayBuffer(v8::Isolate* Isolate, void* Contents, size_t Length)
+{
+#if defined(HAS_ARRAYBUFFER_NEW_WITHOUT_STL) || defined(WITH_BACKING_STORE_AUTO_FREE)
+    // the deleter may run on a v8 worker thread
+    auto Deleter = [](void* Data, size_t Length, void* DeleterData) { FMemory::Free(Data); };
+#if defined(HAS_ARRAYBUFFER_NEW_WITHOUT_STL)
+    return v8::ArrayBuffer_New_Without_Stl(Isolate, Contents, Length, Deleter, nullptr);
+#else
+    auto Backing = v8::ArrayBuffer::NewBackingStore(Contents, Length, Deleter, nullptr);
+    return v8::ArrayBuffer::New(Isolate, std::move(Backing));
+#endif
+#else
+    v8::Local<v8::ArrayBuffer> Buffer = v8::ArrayBuffer::New(Isolate, Length);
+    if (Length > 0)
+    {
+        FMemory::Memcpy(DataTransfer::GetArrayBufferData(Buffer), Contents, Length);
+    }
+    FMemory::Free(Contents);
+    return Buffer;
+#endif
+}
+
+static bool DeserializeMessage(
+    v8::Isolate* Isolate, v8::Local<v8::Context> Context, FJsWorkerMessage& Message, v8::Local<v8::Value>& OutValue)
+{
+    v8::ValueDeserializer Deserializer(Isolate, Message.Data, Message.Size);
+    for (int32 i = 0; i < Message.Transferred.Num(); ++i)
+    {
+        auto& Pair = Message.Transferred[i];
+        Deserializer.TransferArrayBuffer(i, AdoptArrayBuffer(Isolate, Pair.Key, Pair.Value));
+        Pair.Key = nullptr;
+    }
+    if (!Deserializer.ReadHeader(Context).FromMaybe(false))
+    {
+        return false;
+    }
+    return Deserializer.ReadValue(Context).ToLocal(&OutValue);
+}
+
+FJsWorker::FJsWorker(const FString& InScriptUrl, TArray<uint8>&& InSource) : ScriptUrl(InScriptUrl), Source(MoveTemp(InSource))
+{
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FJsWorker::~FJsWorker()
+{
+    Terminate();
+    FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+    WakeEvent = nullptr;
+    Self.Reset();
+}
+
+void FJsWorker::Start()
+{
+    Thread = FRunnableThread::Create(this, *FString::Printf(TEXT("PuertsWorker %s"), *FPaths::GetBaseFilename(ScriptUrl)), 0,
+        TPri_BelowNormal);
+}
+
+void FJsWorker::Terminate()
+{
+    if (Thread)
+    {
+        // Kill calls Stop and waits for Run to return
+        Thread->Kill(true);
+        delete Thread;
+        Thread = nullptr;
+    }
+    StopRequested = true;
+}
+
+void FJsWorker::Stop()
+{
+    StopRequested = true;
+    {
+        FScopeLock Lock(&IsolateLock);
+        if (WorkerIsolate)
+        {
+            WorkerIsolate->TerminateExecution();
+        }
+    }
+    WakeEvent->Trigger();
+}
+
+bool FJsWorker::PostToWorker(
+    v8::Isolate* Isolate, v8::Local<v8::Context> Context, v8::Local<v8::Value> Value, v8::Local<v8::Value> Transfer)
+{
+    if (StopRequested)
+    {
+        return false;
+    }
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    TUniquePtr<FJsWorkerMessage> Message = SerializeMessage(Isolate, Context, Value, Transfer);
+    OwnerCycles += FPlatformTime::Cycles64() - StartCycles;
+    if (!Message)
+    {
+        return false;
+    }
+    ++QueuedToWorker;
+    Inbox.Enqueue(MoveTemp(Message));
+    ++PostedMessages;
+    WakeEvent->Trigger();
+    return true;
+}
+
+static void OnWorkerGarbageCollected(const v8::WeakCallbackInfo<FJsWorker>& Data)
+{
+    FJsWorker* Worker = Data.GetParameter();
+    Worker->Host->DestroyWorker(Worker);
+}
+
+void FJsWorker::UpdateRetention()
+{
+    if (Self.IsEmpty())
+    {
+        return;
+    }
+    const bool Retain = ShouldRetain();
+    if (Retain && Self.IsWeak())
+    {
+        Self.ClearWeak();
+    }
+    else if (!Retain && !Self.IsWeak())
+    {
+        Self.SetWeak<FJsWorker>(this, OnWorkerGarbageCollected, v8::WeakCallbackType::kParameter);
+    }
+}
+
+static v8::Local<v8::Private> OnMessageKey(v8::Isolate* Isolate)
+{
+    return v8::Private::ForApi(Isolate, FV8Utils::InternalString(Isolate, "__puerts_worker_onmessage"));
+}
+
+static v8::Local<v8::Private> OnErrorKey(v8::Isolate* Isolate)
+{
+    return v8::Private::ForApi(Isolate, FV8Utils::InternalString(Isolate, "__puerts_worker_onerror"));
+}
+
+static v8::Local<v8::Function> GetHandle(v8::Local<v8::Context> Context, v8::Local<v8::Object> Owner, v8::Local<v8::Private> Key)
+{
+    v8::Local<v8::Value> Value;
+    if (Owner->GetPrivate(Context, Key).ToLocal(&Value) && Value->IsFunction())
+    {
+        return Value.As<v8::Function>();
+    }
+    return v8::Local<v8::Function>();
+}
+
+int32 FJsWorker::Poll(v8::Isolate* Isolate, v8::Local<v8::Context> Context, int32 Budget)
+{
+    if (Self.IsEmpty())
+    {
+        return 0;
+    }
+
+    int32 Dispatched = 0;
+    TUniquePtr<FJsWorkerMessage> Message;
+    while ((Budget <= 0 || Dispatched < Budget) && Outbox.Dequeue(Message))
+    {
+        ++Dispatched;
+        ++ReceivedMessages;
+
+        v8::HandleScope HandleScope(Isolate);
+        v8::TryCatch TryCatch(Isolate);
+        v8::Local<v8::Object> Owner = Self.Get(Isolate);
+        if (!Message->Error.IsEmpty())
+        {
+            v8::Local<v8::Function> OnError = GetHandle(Context, Owner, OnErrorKey(Isolate));
+            if (!OnError.IsEmpty())
+            {
+                v8::Local<v8::Value> Args[] = {FV8Utils::ToV8String(Isolate, Message->Error)};
+                (void) (OnError->Call(Context, v8::Undefined(Isolate), 1, Args));
+            }
+            else
+            {
+                UE_LOG(Puerts, Error, TEXT("uncaught exception in worker %s: %s"), *ScriptUrl, *Message->Error);
+            }
+        }
+        else
+        {
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            v8::Local<v8::Value> Data;
+            const bool Ok = DeserializeMessage(Isolate, Context, *Message, Data);
+            OwnerCycles += FPlatformTime::Cycles64() - StartCycles;
+            v8::Local<v8::Function> OnMessage = GetHandle(Context, Owner, OnMessageKey(Isolate));
+            if (Ok && !OnMessage.IsEmpty())
+            {
+                v8::Local<v8::Value> Args[] = {Data};
+                (void) (OnMessage->Call(Context, v8::Undefined(Isolate), 1, Args));
+            }
+        }
+
+        if (TryCatch.HasCaught())
+        {
+            UE_LOG(Puerts, Error, TEXT("exception in worker message handler: %s"), *FV8Utils::TryCatchToString(Isolate, &TryCatch));
+        }
+    }
+    return Dispatched;
+}
+
+void FJsWorker::Stats(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    auto Isolate = Info.GetIsolate();
+    auto Context = Isolate->GetCurrentContext();
+    auto Result = v8::Object::New(Isolate);
+    Result->Set(Context, FV8Utils::ToV8String(Isolate, "posted"), v8::Integer::NewFromUnsigned(Isolate, PostedMessages)).Check();
+    Result->Set(Context, FV8Utils::ToV8String(Isolate, "received"), v8::Integer::NewFromUnsigned(Isolate, ReceivedMessages))
+        .Check();
+    Result
+        ->Set(Context, FV8Utils::ToV8String(Isolate, "ownerMs"),
+            v8::Number::New(Isolate, FPlatformTime::ToMilliseconds64(OwnerCycles)))
+        .Check();
+    Result
+        ->Set(Context, FV8Utils::ToV8String(Isolate, "workerMs"),
+            v8::Number::New(Isolate, FPlatformTime::ToMilliseconds64(WorkerCycles.load(std::memory_order_relaxed))))
+        .Check();
+    Info.GetReturnValue().Set(Result);
+}
+
+// worker thread
+
+FString FJsWorker::FormatLog(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    auto Self = static_cast<FJsWorker*>(Info.Data().As<v8::External>()->Value());
+    FString Line = FString::Printf(TEXT("(worker %s)"), *FPaths::GetBaseFilename(Self->ScriptUrl));
+    for (int i = 0; i < Info.Length(); ++i)
+    {
+        Line += TEXT(" ");
+        Line += FV8Utils::ToFString(Info.GetIsolate(), Info[i]);
+    }
+    return Line;
+}
+
+void FJsWorker::PostToOwner(TUniquePtr<FJsWorkerMessage>&& Message)
+{
+    Outbox.Enqueue(MoveTemp(Message));
+}
+
+void FJsWorker::PostErrorToOwner(v8::Isolate* Isolate, v8::TryCatch& TryCatch)
+{
+    if (TryCatch.HasTerminated() || !TryCatch.HasCaught())
+    {
+        return;
+    }
+    auto Message = MakeUnique<FJsWorkerMessage>();
+    Message->Error = FV8Utils::TryCatchToString(Isolate, &TryCatch);
+    PostToOwner(MoveTemp(Message));
+}
+
+void FJsWorker::InitWorkerGlobals(v8::Isolate* Isolate, v8::Local<v8::Context> Context)
+{
+    auto Global = Context->Global();
+    auto This = v8::External::New(Isolate, this);
+
+    Global->Set(Context, FV8Utils::ToV8String(Isolate, "self"), Global).Check();
+
+    Global
+        ->Set(Context, FV8Utils::ToV8String(Isolate, "postMessage"),
+            v8::FunctionTemplate::New(
+                Isolate,
+                [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+                {
+                    auto Self = static_cast<FJsWorker*>(Info.Data().As<v8::External>()->Value());
+                    auto Isolate = Info.GetIsolate();
+                    TUniquePtr<FJsWorkerMessage> Message =
+                        SerializeMessage(Isolate, Isolate->GetCurrentContext(), Info[0], Info.Length() > 1 ? Info[1] : v8::Local<v8::Value>());
+                    if (Message)
+                    {
+                        Self->PostToOwner(MoveTemp(Message));
+                    }
+                },
+                This)
+                ->GetFunction(Context)
+                .ToLocalChecked())
+        .Check();
+
+    Global
+        ->Set(Context, FV8Utils::ToV8String(Isolate, "close"),
+            v8::FunctionTemplate::New(
+                Isolate,
+                [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+                { static_cast<FJsWorker*>(Info.Data().As<v8::External>()->Value())->StopRequested = true; },
+                This)
+                ->GetFunction(Context)
+                .ToLocalChecked())
+        .Check();
+
+    // console goes straight to the log, the owner's logger is not thread safe
+    auto Console = v8::Object::New(Isolate);
+    auto BindLog = [&](const char* Name, v8::FunctionCallback Callback)
+    { Console->Set(Context, FV8Utils::ToV8String(Isolate, Name), v8::Function::New(Context, Callback, This).ToLocalChecked()).Check(); };
+    BindLog("log", [](const v8::FunctionCallbackInfo<v8::Value>& Info) { UE_LOG(Puerts, Log, TEXT("%s"), *FormatLog(Info)); });
+    BindLog("warn", [](const v8::FunctionCallbackInfo<v8::Value>& Info) { UE_LOG(Puerts, Warning, TEXT("%s"), *FormatLog(Info)); });
+    BindLog("error", [](const v8::FunctionCallbackInfo<v8::Value>& Info) { UE_LOG(Puerts, Error, TEXT("%s"), *FormatLog(Info)); });
+    Global->Set(Context, FV8Utils::ToV8String(Isolate, "console"), Console).Check();
+}
+
+uint32 FJsWorker::Run()
+{
+    v8::Isolate::CreateParams CreateParams;
+    CreateParams.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+    v8::Isolate* Isolate = v8::Isolate::New(CreateParams);
+    {
+        FScopeLock Lock(&IsolateLock);
+        WorkerIsolate = Isolate;
+    }
+
+    {
+        v8::Isolate::Scope IsolateScope(Isolate);
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = v8::Context::New(Isolate);
+        v8::Context::Scope ContextScope(Context);
+
+        InitWorkerGlobals(Isolate, Context);
+
+        if (!StopRequested)
+        {
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            v8::TryCatch TryCatch(Isolate);
+            v8::Local<v8::String> Name = FV8Utils::ToV8String(Isolate, ScriptUrl);
+#if V8_MAJOR_VERSION > 8
+            v8::ScriptOrigin Origin(Isolate, Name);
+#else
+            v8::ScriptOrigin Origin(Name);
+#endif
+            v8::Local<v8::Script> Script;
+            if (!v8::Script::Compile(Context, FV8Utils::ToV8StringFromFileContent(Isolate, Source), &Origin).ToLocal(&Script) ||
+                Script->Run(Context).IsEmpty())
+            {
+                PostErrorToOwner(Isolate, TryCatch);
+            }
+            Isolate->PerformMicrotaskCheckpoint();
+            WorkerCycles += FPlatformTime::Cycles64() - StartCycles;
+        }
+        Source.Empty();
+
+        auto OnMessageKey = FV8Utils::ToV8String(Isolate, "onmessage");
+        auto DataKey = FV8Utils::ToV8String(Isolate, "data");
+        while (!StopRequested)
+        {
+            WakeEvent->Wait();
+
+            TUniquePtr<FJsWorkerMessage> Message;
+            while (!StopRequested && Inbox.Dequeue(Message))
+            {
+                const uint64 StartCycles = FPlatformTime::Cycles64();
+                v8::HandleScope MessageScope(Isolate);
+                v8::TryCatch TryCatch(Isolate);
+                v8::Local<v8::Value> Data;
+                v8::Local<v8::Value> Handler;
+                if (!DeserializeMessage(Isolate, Context, *Message, Data))
+                {
+                    PostErrorToOwner(Isolate, TryCatch);
+                }
+                else if (Context->Global()->Get(Context, OnMessageKey).ToLocal(&Handler) && Handler->IsFunction())
+                {
+                    auto Event = v8::Object::New(Isolate);
+                    Event->Set(Context, DataKey, Data).Check();
+                    v8::Local<v8::Value> Args[] = {Event};
+                    if (Handler.As<v8::Function>()->Call(Context, Context->Global(), 1, Args).IsEmpty())
+                    {
+                        PostErrorToOwner(Isolate, TryCatch);
+                    }
+                }
+                Isolate->PerformMicrotaskCheckpoint();
+                WorkerCycles += FPlatformTime::Cycles64() - StartCycles;
+                // replies are in the outbox by now, so the owner never sees the worker idle with an answer pending
+                --QueuedToWorker;
+            }
+        }
+    }
+
+    {
+        FScopeLock Lock(&IsolateLock);
+        WorkerIsolate = nullptr;
+    }
+    Isolate->Dispose();
+    delete CreateParams.array_buffer_allocator;
+    return 0;
+}
+
+FJsWorkerHost::FJsWorkerHost(std::shared_ptr<IJSModuleLoader> InModuleLoader) : ModuleLoader(InModuleLoader)
+{
+}
+
+FJsWorkerHost::~FJsWorkerHost()
+{
+    for (FJsWorker* Worker : Workers)
+    {
+        delete Worker;
+    }
+    Workers.Empty();
+    WorkerTemplate.Reset();
+}
+
+void FJsWorkerHost::DestroyWorker(FJsWorker* Worker)
+{
+    Workers.RemoveSingleSwap(Worker);
+    delete Worker;
+}
+
+bool FJsWorkerHost::HasPendingMessages() const
+{
+    for (const FJsWorker* Worker : Workers)
+    {
+        if (Worker->NeedsPoll())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FJsWorkerHost::PollAll(v8::Isolate* Isolate, v8::Local<v8::Context> Context)
+{
+    // handlers may create workers, and a gc they trigger may destroy some
+    TArray<FJsWorker*, TInlineAllocator<8>> Snapshot(Workers);
+    for (FJsWorker* Worker : Snapshot)
+    {
+        if (Workers.Contains(Worker))
+        {
+            Worker->Poll(Isolate, Context, MaxMessagesPerPoll);
+            Worker->UpdateRetention();
+        }
+    }
+}
+
+void FJsWorkerHost::NewWorker(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    if (!Info.IsConstructCall() || !Info[0]->IsString())
+    {
+        FV8Utils::ThrowException(Isolate, "usage: new PuertsWorker(scriptPath)");
+        return;
+    }
+
+    const FString ModuleName = FV8Utils::ToFString(Isolate, Info[0]);
+    FString OutPath;
+    FString OutDebugPath;
+    TArray<uint8> Data;
+    if (!ModuleLoader->Search(TEXT(""), ModuleName, OutPath, OutDebugPath) || !ModuleLoader->Load(OutPath, Data))
+    {
+        FV8Utils::ThrowException(Isolate, FString::Printf(TEXT("can not load worker script [%s]"), *ModuleName));
+        return;
+    }
+
+    FJsWorker* Worker = new FJsWorker(OutDebugPath.IsEmpty() ? OutPath : OutDebugPath, MoveTemp(Data));
+    Worker->Host = this;
+    Info.This()->SetAlignedPointerInInternalField(0, Worker);
+    Worker->Self.Reset(Isolate, Info.This());
+    Worker->UpdateRetention();
+    Workers.Add(Worker);
+    Worker->Start();
+}
+
+FJsWorker* FJsWorkerHost::GetWorker(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    FJsWorkerHost* Host = static_cast<FJsWorkerHost*>(Info.Data().As<v8::External>()->Value());
+    if (!Host->WorkerTemplate.Get(Isolate)->HasInstance(Info.This()))
+    {
+        FV8Utils::ThrowException(Isolate, "Illegal invocation, the receiver is not a PuertsWorker");
+        return nullptr;
+    }
+    return static_cast<FJsWorker*>(Info.This()->GetAlignedPointerFromInternalField(0));
+}
+
+void FJsWorkerHost::Init(v8::Local<v8::Context> Context)
+{
+    v8::Isolate* Isolate = Context->GetIsolate();
+    auto Template = v8::FunctionTemplate::New(
+        Isolate,
+        [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+        { static_cast<FJsWorkerHost*>(Info.Data().As<v8::External>()->Value())->NewWorker(Info); },
+        v8::External::New(Isolate, this));
+    Template->InstanceTemplate()->SetInternalFieldCount(1);
+    WorkerTemplate.Reset(Isolate, Template);
+    auto HostData = v8::External::New(Isolate, this);
+
+    Template->PrototypeTemplate()->Set(FV8Utils::ToV8String(Isolate, "postMessage"),
+        v8::FunctionTemplate::New(
+            Isolate,
+            [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+            {
+                auto Isolate = Info.GetIsolate();
+                if (FJsWorker* Worker = GetWorker(Info))
+                {
+                    Worker->PostToWorker(
+                        Isolate, Isolate->GetCurrentContext(), Info[0], Info.Length() > 1 ? Info[1] : v8::Local<v8::Value>());
+                    Worker->UpdateRetention();
+                }
+            },
+            HostData));
+
+    // kept on the wrapper itself, so the handles and the Worker they close over are collected together with it
+    Template->PrototypeTemplate()->Set(FV8Utils::ToV8String(Isolate, "setHandles"),
+        v8::FunctionTemplate::New(
+            Isolate,
+            [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+            {
+                auto Isolate = Info.GetIsolate();
+                auto Context = Isolate->GetCurrentContext();
+                if (!GetWorker(Info))
+                {
+                    return;
+                }
+                if (Info[0]->IsFunction())
+                {
+                    (void) Info.This()->SetPrivate(Context, OnMessageKey(Isolate), Info[0]);
+                }
+                if (Info[1]->IsFunction())
+                {
+                    (void) Info.This()->SetPrivate(Context, OnErrorKey(Isolate), Info[1]);
+                }
+            },
+            HostData));
+
+    // the script side Worker tells whether anybody listens, only then it outlives the references to it
+    Template->PrototypeTemplate()->Set(FV8Utils::ToV8String(Isolate, "setListening"),
+        v8::FunctionTemplate::New(
+            Isolate,
+            [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+            {
+                if (FJsWorker* Worker = GetWorker(Info))
+                {
+                    Worker->bHasListeners = Info[0]->BooleanValue(Info.GetIsolate());
+                    Worker->UpdateRetention();
+                }
+            },
+            HostData));
+
+    Template->PrototypeTemplate()->Set(FV8Utils::ToV8String(Isolate, "terminate"),
+        v8::FunctionTemplate::New(
+            Isolate,
+            [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+            {
+                auto Isolate = Info.GetIsolate();
+                auto Context = Isolate->GetCurrentContext();
+                FJsWorker* Worker = GetWorker(Info);
+                if (!Worker)
+                {
+                    return;
+                }
+                Worker->Terminate();
+                Worker->UpdateRetention();
+                // messages the worker posted before it was stopped are dropped
+                (void) Info.This()->DeletePrivate(Context, OnMessageKey(Isolate));
+                (void) Info.This()->DeletePrivate(Context, OnErrorKey(Isolate));
+            },
+            HostData));
+
+    Template->PrototypeTemplate()->Set(FV8Utils::ToV8String(Isolate, "stats"),
+        v8::FunctionTemplate::New(
+            Isolate,
+            [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+            {
+                if (FJsWorker* Worker = GetWorker(Info))
+                {
+                    Worker->Stats(Info);
+                }
+            },
+            HostData));
+
+    Template->Set(FV8Utils::ToV8String(Isolate, "setMaxMessagesPerPoll"),
+        v8::FunctionTemplate::New(
+            Isolate,
+            [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+            {
+                auto Host = static_cast<FJsWorkerHost*>(Info.Data().As<v8::External>()->Value());
+                Host->MaxMessagesPerPoll = FMath::Max(Info[0]->Int32Value(Info.GetIsolate()->GetCurrentContext()).FromMaybe(0), 0);
+            },
+            HostData));
+
+    Context->Global()
+        ->Set(Context, FV8Utils::ToV8String(Isolate, "PuertsWorker"), Template->GetFunction(Context).ToLocalChecked())
+        .Check();
+}
+}    // namespace PUERTS_NAMESPACE
+
+#endif
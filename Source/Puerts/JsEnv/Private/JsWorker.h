@@ -0,0 +1,184 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#if !defined(WITH_QUICKJS) && !defined(WITH_NODEJS)
+
+#include <atomic>
+#include <memory>
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include "JSModuleLoader.h"
+
+#include "NamespaceDef.h"
+
+PRAGMA_DISABLE_UNDEFINED_IDENTIFIER_WARNINGS
+#pragma warning(push, 0)
+#include "v8.h"
+#pragma warning(pop)
+PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS
+
+class FRunnableThread;
+class FEvent;
+
+namespace PUERTS_NAMESPACE
+{
+class FJsWorkerHost;
+
+// a value cloned out of one isolate, owns the serializer output and the contents of transferred ArrayBuffers
+struct FJsWorkerMessage
+{
+    uint8* Data = nullptr;
+    size_t Size = 0;
+    TArray<TPair<void*, size_t>> Transferred;
+    // set instead of Data for uncaught exceptions inside the worker
+    FString Error;
+
+    FJsWorkerMessage() = default;
+    FJsWorkerMessage(const FJsWorkerMessage&) = delete;
+    FJsWorkerMessage& operator=(const FJsWorkerMessage&) = delete;
+    ~FJsWorkerMessage();
+};
+
+// One plain v8 isolate running a script on its own thread. The isolate has no puerts bindings, so worker scripts can not
+// touch UObjects; they exchange structured clones with the owner env through two single-producer single-consumer queues.
+class FJsWorker : public FRunnable
+{
+public:
+    FJsWorker(const FString& InScriptUrl, TArray<uint8>&& InSource);
+
+    ~FJsWorker();
+
+    void Start();
+
+    // stop the worker thread, a running handler is interrupted
+    void Terminate();
+
+    // owner thread only
+
+    bool PostToWorker(v8::Isolate* Isolate, v8::Local<v8::Context> Context, v8::Local<v8::Value> Value, v8::Local<v8::Value> Transfer);
+
+    int32 Poll(v8::Isolate* Isolate, v8::Local<v8::Context> Context, int32 Budget);
+
+    bool HasPendingMessages() const
+    {
+        return !Outbox.IsEmpty();
+    }
+
+    // like a web Worker it lives on without script references while it has listeners or messages in flight, and is
+    // collectable once terminated or idle without listeners
+    bool ShouldRetain() const
+    {
+        return !StopRequested && (bHasListeners || QueuedToWorker > 0 || !Outbox.IsEmpty());
+    }
+
+    // make Self strong or weak according to ShouldRetain
+    void UpdateRetention();
+
+    // a frame poll is needed to deliver messages or to let go of a worker that became idle
+    bool NeedsPoll() const
+    {
+        return !Outbox.IsEmpty() || (!Self.IsEmpty() && !Self.IsWeak() && !ShouldRetain());
+    }
+
+    void Stats(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    FJsWorkerHost* Host = nullptr;
+
+    // the onmessage/onerror handles are private properties of this object instead of globals, they close over the script
+    // side Worker. Strong only while ShouldRetain, otherwise the wrapper, its handles and the thread are collected together
+    v8::Global<v8::Object> Self;
+
+    // the script side Worker has onmessage / onerror or event listeners
+    bool bHasListeners = false;
+
+protected:
+    virtual uint32 Run() override;
+
+    virtual void Stop() override;
+
+private:
+    void PostToOwner(TUniquePtr<FJsWorkerMessage>&& Message);
+
+    void PostErrorToOwner(v8::Isolate* Isolate, v8::TryCatch& TryCatch);
+
+    void InitWorkerGlobals(v8::Isolate* Isolate, v8::Local<v8::Context> Context);
+
+    static FString FormatLog(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    FString ScriptUrl;
+
+    TArray<uint8> Source;
+
+    TQueue<TUniquePtr<FJsWorkerMessage>, EQueueMode::Spsc> Inbox;
+
+    TQueue<TUniquePtr<FJsWorkerMessage>, EQueueMode::Spsc> Outbox;
+
+    FEvent* WakeEvent = nullptr;
+
+    FRunnableThread* Thread = nullptr;
+
+    std::atomic<bool> StopRequested{false};
+
+    // guards WorkerIsolate so Terminate never interrupts an isolate being disposed
+    FCriticalSection IsolateLock;
+
+    v8::Isolate* WorkerIsolate = nullptr;
+
+    uint32 PostedMessages = 0;
+
+    uint32 ReceivedMessages = 0;
+
+    // owner thread cycles spent cloning messages in and out, the price paid for moving work off the owner thread
+    uint64 OwnerCycles = 0;
+
+    std::atomic<uint64> WorkerCycles{0};
+
+    // posted by the owner and not yet handled by the worker
+    std::atomic<int32> QueuedToWorker{0};
+};
+
+// creates the PuertsWorker constructor in an env and keeps its workers alive until they are collected or the env goes away.
+// the env polls every worker at the beginning of a frame, a worker is kept alive natively only while FJsWorker::ShouldRetain
+class FJsWorkerHost
+{
+public:
+    explicit FJsWorkerHost(std::shared_ptr<IJSModuleLoader> InModuleLoader);
+
+    ~FJsWorkerHost();
+
+    void Init(v8::Local<v8::Context> Context);
+
+    void DestroyWorker(FJsWorker* Worker);
+
+    // the worker behind the receiver of a PuertsWorker method, throws and returns nullptr for any other receiver
+    static FJsWorker* GetWorker(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    bool HasPendingMessages() const;
+
+    // deliver up to MaxMessagesPerPoll messages of every worker to its handles
+    void PollAll(v8::Isolate* Isolate, v8::Local<v8::Context> Context);
+
+private:
+    void NewWorker(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    std::shared_ptr<IJSModuleLoader> ModuleLoader;
+
+    TArray<FJsWorker*> Workers;
+
+    v8::Global<v8::FunctionTemplate> WorkerTemplate;
+
+    // 0 means no limit
+    int32 MaxMessagesPerPoll = 64;
+};
+}    // namespace PUERTS_NAMESPACE
+
+#endif
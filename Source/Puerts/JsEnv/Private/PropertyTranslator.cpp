@@ -668,7 +668,7 @@ public:
 
         if (!PassByPointer)
         {
-            // FScriptStructWrapper::Alloc using new, so delete in static wrapper is safe
+            // allocated from FStructAllocator, released by FScriptStructWrapper::Free
             Ptr = FScriptStructWrapper::Alloc(StructProperty->Struct);
             StructProperty->CopySingleValue(Ptr, ValuePtr);
         }
@@ -0,0 +1,372 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#include "ScriptArchive.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Crc.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "JSLogger.h"
+#include "JsEnv.h"
+
+#if (ENGINE_MAJOR_VERSION >= 5)
+#include "HAL/PlatformFileManager.h"
+#else
+#include "HAL/PlatformFilemanager.h"
+#endif
+
+namespace PUERTS_NAMESPACE
+{
+static constexpr uint32 ScriptArchiveMagic = 0x41534A50;    // "PJSA"
+
+static constexpr uint32 ScriptArchiveVersion = 1;
+
+static constexpr int64 ScriptArchiveAlignment = 16;
+
+static const TCHAR* CodeCacheSuffix = TEXT(".codecache");
+
+struct FScriptArchiveHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint64 IndexOffset;
+    uint64 IndexSize;
+};
+
+static FArchive& operator<<(FArchive& Ar, FScriptArchive::FEntry& Entry)
+{
+    return Ar << Entry.Offset << Entry.Size << Entry.Hash << Entry.Flags << Entry.CodeCacheOffset << Entry.CodeCacheSize;
+}
+
+#if WITH_EDITOR
+static FAutoConsoleCommand PackScriptArchiveCommand(TEXT("Puerts.PackScriptArchive"),
+    TEXT("Pack the given content sub directories (default: JavaScript) into Content/JavaScript/ScriptArchive.bin"),
+    FConsoleCommandWithArgsDelegate::CreateLambda(
+        [](const TArray<FString>& Args)
+        {
+            FScriptArchive::Pack(Args.Num() > 0 ? Args : TArray<FString>{TEXT("JavaScript")}, FScriptArchive::GetDefaultArchivePath());
+        }));
+#endif
+
+static bool IsTextExtension(const FString& Extension)
+{
+    return Extension == TEXT("js") || Extension == TEXT("mjs") || Extension == TEXT("cjs") || Extension == TEXT("json") ||
+           Extension == TEXT("css") || Extension == TEXT("scss") || Extension == TEXT("atlas");
+}
+
+// what DefaultJSModuleLoader resolves at runtime: scripts, v8 bytecode, styles, images and animation data
+static bool IsPackedExtension(const FString& Extension)
+{
+    return IsTextExtension(Extension) || Extension == TEXT("mbc") || Extension == TEXT("cbc") || Extension == TEXT("skel") ||
+           Extension == TEXT("riv") || Extension == TEXT("png") || Extension == TEXT("jpg") || Extension == TEXT("jpeg") ||
+           Extension == TEXT("webp");
+}
+
+static bool IsOneByte(const TArray<uint8>& Content)
+{
+    for (uint8 Byte : Content)
+    {
+        if (Byte >= 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void WriteAligned(FArchive& Writer, TArray<uint8>& Content, uint64& OutOffset)
+{
+    static const uint8 Padding[ScriptArchiveAlignment] = {};
+    const int64 Pos = Writer.Tell();
+    const int64 Aligned = Align(Pos, ScriptArchiveAlignment);
+    if (Aligned != Pos)
+    {
+        Writer.Serialize(const_cast<uint8*>(Padding), Aligned - Pos);
+    }
+    OutOffset = Aligned;
+    Writer.Serialize(Content.GetData(), Content.Num());
+}
+
+FScriptArchive& FScriptArchive::Get()
+{
+    static FScriptArchive Instance;
+    return Instance;
+}
+
+FString FScriptArchive::GetDefaultArchivePath()
+{
+    return FPaths::ProjectContentDir() / TEXT("JavaScript") / TEXT("ScriptArchive.bin");
+}
+
+FSimpleMulticastDelegate& FScriptArchive::OnPrePack()
+{
+    static FSimpleMulticastDelegate Delegate;
+    return Delegate;
+}
+
+bool FScriptArchive::Pack(const TArray<FString>& InRoots, const FString& ArchivePath)
+{
+    FJsEnv::OnWaitForScriptFiles().Broadcast();
+    OnPrePack().Broadcast();
+
+    const FString FullContentDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir());
+    const FString FullArchivePath = FPaths::ConvertRelativePathToFull(ArchivePath);
+    const FString TempArchivePath = FullArchivePath + TEXT(".tmp");
+
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempArchivePath));
+    if (!Writer)
+    {
+        UE_LOG(Puerts, Error, TEXT("can not create script archive %s"), *TempArchivePath);
+        return false;
+    }
+
+    FScriptArchiveHeader Header = {ScriptArchiveMagic, ScriptArchiveVersion, 0, 0};
+    Writer->Serialize(&Header, sizeof(Header));
+
+    TArray<FString> Keys;
+    TArray<FEntry> PackedEntries;
+    TArray<uint8> Content;
+    for (const FString& Root : InRoots)
+    {
+        TArray<FString> Files;
+        IFileManager::Get().FindFilesRecursive(Files, *(FullContentDir / Root), TEXT("*"), true, false);
+        Files.Sort();
+        for (const FString& File : Files)
+        {
+            if (File == FullArchivePath || File == TempArchivePath || File.Contains(TEXT("/node_modules/")) ||
+                !IsPackedExtension(FPaths::GetExtension(File).ToLower()))
+            {
+                continue;
+            }
+            if (!FFileHelper::LoadFileToArray(Content, *File))
+            {
+                UE_LOG(Puerts, Error, TEXT("can not read %s, script archive not packed"), *File);
+                Writer.Reset();
+                IFileManager::Get().Delete(*TempArchivePath);
+                return false;
+            }
+
+            FEntry Entry;
+            Entry.Size = Content.Num();
+            Entry.Hash = FCrc::MemCrc32(Content.GetData(), Content.Num());
+            Entry.Flags = IsTextExtension(FPaths::GetExtension(File)) && IsOneByte(Content) ? EF_OneByte : 0;
+            WriteAligned(*Writer, Content, Entry.Offset);
+
+            const FString CodeCacheFile = File + CodeCacheSuffix;
+            if (FPaths::FileExists(CodeCacheFile) && FFileHelper::LoadFileToArray(Content, *CodeCacheFile))
+            {
+                Entry.CodeCacheSize = Content.Num();
+                WriteAligned(*Writer, Content, Entry.CodeCacheOffset);
+            }
+
+            Keys.Add(File.Mid(FullContentDir.Len()));
+            PackedEntries.Add(Entry);
+        }
+    }
+
+    TArray<uint8> Index;
+    FMemoryWriter IndexWriter(Index);
+    TArray<FString> RootList = InRoots;
+    IndexWriter << RootList;
+    int32 EntryNum = Keys.Num();
+    IndexWriter << EntryNum;
+    for (int32 i = 0; i < EntryNum; ++i)
+    {
+        IndexWriter << Keys[i] << PackedEntries[i];
+    }
+
+    WriteAligned(*Writer, Index, Header.IndexOffset);
+    Header.IndexSize = Index.Num();
+    Writer->Seek(0);
+    Writer->Serialize(&Header, sizeof(Header));
+    const bool Success = Writer->Close();
+    Writer.Reset();
+
+    if (!Success || !IFileManager::Get().Move(*FullArchivePath, *TempArchivePath, true, true))
+    {
+        UE_LOG(Puerts, Error, TEXT("write script archive %s fail"), *FullArchivePath);
+        IFileManager::Get().Delete(*TempArchivePath);
+        return false;
+    }
+
+    UE_LOG(Puerts, Log, TEXT("%d files packed into %s"), EntryNum, *FullArchivePath);
+    return true;
+}
+
+FScriptArchive::~FScriptArchive()
+{
+    Unmount();
+}
+
+bool FScriptArchive::Mount(const FString& ArchivePath)
+{
+    Unmount();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    MappedHandle.Reset(PlatformFile.OpenMapped(*ArchivePath));
+    if (MappedHandle)
+    {
+        MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+    }
+    if (MappedRegion)
+    {
+        Base = MappedRegion->GetMappedPtr();
+        BaseSize = MappedRegion->GetMappedSize();
+    }
+    else
+    {
+        MappedHandle.Reset();
+        if (!FFileHelper::LoadFileToArray(FallbackBuffer, *ArchivePath, FILEREAD_Silent))
+        {
+            return false;
+        }
+        Base = FallbackBuffer.GetData();
+        BaseSize = FallbackBuffer.Num();
+    }
+
+    const FScriptArchiveHeader* Header = reinterpret_cast<const FScriptArchiveHeader*>(Base);
+    if (BaseSize < sizeof(FScriptArchiveHeader) || Header->Magic != ScriptArchiveMagic || Header->Version != ScriptArchiveVersion ||
+        Header->IndexOffset + Header->IndexSize > BaseSize)
+    {
+        UE_LOG(Puerts, Error, TEXT("invalid script archive %s"), *ArchivePath);
+        Unmount();
+        return false;
+    }
+
+    TArray<uint8> Index(Base + Header->IndexOffset, (int32) Header->IndexSize);
+    FMemoryReader IndexReader(Index);
+    // packed roots, only informative now that a miss always falls back to the file system
+    TArray<FString> RootList;
+    IndexReader << RootList;
+    int32 EntryNum = 0;
+    IndexReader << EntryNum;
+    Entries.Reserve(EntryNum);
+    for (int32 i = 0; i < EntryNum && !IndexReader.IsError(); ++i)
+    {
+        FString Key;
+        FEntry Entry;
+        IndexReader << Key << Entry;
+        if (Entry.Offset + Entry.Size > BaseSize || Entry.CodeCacheOffset + Entry.CodeCacheSize > BaseSize)
+        {
+            IndexReader.SetError();
+            break;
+        }
+        Entry.Index = Entries.Num();
+        Entries.Add(MoveTemp(Key), Entry);
+    }
+    if (IndexReader.IsError())
+    {
+        UE_LOG(Puerts, Error, TEXT("corrupted script archive index %s"), *ArchivePath);
+        Unmount();
+        return false;
+    }
+
+    ContentDir = FPaths::ProjectContentDir();
+    FullContentDir = FPaths::ConvertRelativePathToFull(ContentDir);
+    VerifyStates = MakeUnique<std::atomic<uint8>[]>(Entries.Num());
+    for (int32 i = 0; i < Entries.Num(); ++i)
+    {
+        VerifyStates[i].store(VS_Unchecked, std::memory_order_relaxed);
+    }
+    UE_LOG(Puerts, Log, TEXT("script archive %s mounted, %d entries%s"), *ArchivePath, Entries.Num(),
+        MappedRegion ? TEXT("") : TEXT(" (not mapped)"));
+    return true;
+}
+
+void FScriptArchive::Unmount()
+{
+    Entries.Empty();
+    VerifyStates.Reset();
+    Base = nullptr;
+    BaseSize = 0;
+    MappedRegion.Reset();
+    MappedHandle.Reset();
+    FallbackBuffer.Empty();
+}
+
+FString FScriptArchive::ToEntryKey(const FString& Path) const
+{
+    // the module loader hands in paths built from FPaths::ProjectContentDir(), skip the full path conversion for them
+    FString Key = Path.StartsWith(ContentDir) ? Path.Mid(ContentDir.Len()) : FPaths::ConvertRelativePathToFull(Path);
+    if (Key.Contains(TEXT("..")) || Key.Contains(TEXT("\\")))
+    {
+        Key = FPaths::ConvertRelativePathToFull(ContentDir / Key);
+    }
+    if (!FPaths::IsRelative(Key))
+    {
+        if (!Key.StartsWith(FullContentDir))
+        {
+            return FString();
+        }
+        Key = Key.Mid(FullContentDir.Len());
+    }
+    return Key;
+}
+
+const FScriptArchive::FEntry* FScriptArchive::Find(const FString& Path) const
+{
+    if (!IsMounted())
+    {
+        return nullptr;
+    }
+    const FString Key = ToEntryKey(Path);
+    const FEntry* Entry = Key.IsEmpty() ? nullptr : Entries.Find(Key);
+    if (!Entry)
+    {
+        return nullptr;
+    }
+
+    // threads racing on an unchecked entry both compute the same result
+    std::atomic<uint8>& State = VerifyStates[Entry->Index];
+    uint8 Verified = State.load(std::memory_order_acquire);
+    if (Verified == VS_Unchecked)
+    {
+        Verified = FCrc::MemCrc32(GetData(*Entry), (int32) Entry->Size) == Entry->Hash ? VS_Valid : VS_Corrupted;
+        if (State.exchange(Verified, std::memory_order_acq_rel) == VS_Unchecked && Verified == VS_Corrupted)
+        {
+            UE_LOG(Puerts, Error, TEXT("crc mismatch for %s in the script archive, it is read from disk"), *Key);
+        }
+    }
+    return Verified == VS_Valid ? Entry : nullptr;
+}
+
+bool FScriptArchive::FileExists(const FString& Path) const
+{
+    if (Find(Path))
+    {
+        return true;
+    }
+    return FPaths::FileExists(Path);
+}
+
+bool FScriptArchive::LoadFileToArray(const FString& Path, TArray<uint8>& OutContent) const
+{
+    if (const FEntry* Entry = Find(Path))
+    {
+        OutContent.Reset((int32) Entry->Size);
+        OutContent.Append(GetData(*Entry), (int32) Entry->Size);
+        return true;
+    }
+    return FFileHelper::LoadFileToArray(OutContent, *Path, FILEREAD_Silent);
+}
+
+bool FScriptArchive::LoadFileToString(const FString& Path, FString& OutContent) const
+{
+    if (const FEntry* Entry = Find(Path))
+    {
+        FFileHelper::BufferToString(OutContent, GetData(*Entry), (int32) Entry->Size);
+        return true;
+    }
+    return FFileHelper::LoadFileToString(OutContent, *Path, FFileHelper::EHashOptions::None, FILEREAD_Silent);
+}
+}    // namespace PUERTS_NAMESPACE
@@ -0,0 +1,202 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#include "StructAllocator.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/IConsoleManager.h"
+#include "JsEnvStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Live Structs"), STAT_PuertsLiveStructs, STATGROUP_Puerts);
+DECLARE_MEMORY_STAT(TEXT("Struct Payload Memory"), STAT_PuertsStructMemory, STATGROUP_Puerts);
+DECLARE_MEMORY_STAT(TEXT("Struct Slab Memory"), STAT_PuertsStructSlabMemory, STATGROUP_Puerts);
+
+namespace PUERTS_NAMESPACE
+{
+// block sizes, header included
+static constexpr uint32 SizeClassBlockSizes[] = {32, 48, 64, 80, 96, 128, 160, 192, 256, 320};
+
+static constexpr uint32 SlabSize = 64 * 1024;
+
+static constexpr uint32 HeaderSize = 16;
+
+static constexpr uint8 LargeBlockClass = 0xFF;
+
+struct FStructBlockHeader
+{
+    FStructAllocator::FTypeStats* Stats;
+    uint32 Size;
+    uint8 SizeClass;
+    uint16 PayloadOffset;
+};
+static_assert(sizeof(FStructBlockHeader) <= HeaderSize, "struct block header too large");
+
+static FORCEINLINE FStructBlockHeader* GetHeader(void* Ptr)
+{
+    return reinterpret_cast<FStructBlockHeader*>(static_cast<uint8*>(Ptr) - HeaderSize);
+}
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommand DumpStructAllocStatsCommand(TEXT("Puerts.DumpStructAllocStats"),
+    TEXT("Log live count and bytes of every struct type allocated for JS"),
+    FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+        [](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) { FStructAllocator::Get().DumpTypeStats(Ar); }));
+#endif
+
+FStructAllocator& FStructAllocator::Get()
+{
+    // never destroyed, struct holders may be released after static destruction began
+    static FStructAllocator* Instance = new FStructAllocator();
+    return *Instance;
+}
+
+FStructAllocator::FStructAllocator()
+{
+    static_assert(UE_ARRAY_COUNT(SizeClassBlockSizes) == SizeClassNum, "size class count mismatch");
+    static_assert(SizeClassBlockSizes[SizeClassNum - 1] == MaxSmallBlockSize, "max small block size mismatch");
+    int32 Class = 0;
+    for (uint32 Units = 0; Units <= MaxSmallBlockSize / BlockGranularity; ++Units)
+    {
+        while (SizeClassBlockSizes[Class] < Units * BlockGranularity)
+        {
+            ++Class;
+        }
+        UnitsToClass[Units] = static_cast<uint8>(Class);
+    }
+    for (int32 i = 0; i < SizeClassNum; ++i)
+    {
+        SizeClasses[i].BlockSize = SizeClassBlockSizes[i];
+    }
+}
+
+FStructAllocator::FTypeStats* FStructAllocator::FindOrAddTypeStats(UScriptStruct* ScriptStruct)
+{
+    {
+        FReadScopeLock ReadLock(TypeStatsLock);
+        FTypeStats* const* Found = TypeStatsMap.Find(ScriptStruct);
+        if (Found && (*Found)->Struct.Get() == ScriptStruct)
+        {
+            return *Found;
+        }
+    }
+
+    FWriteScopeLock WriteLock(TypeStatsLock);
+    FTypeStats*& Stats = TypeStatsMap.FindOrAdd(ScriptStruct);
+    // a new struct can reuse the address of a collected one
+    if (!Stats || Stats->Struct.Get() != ScriptStruct)
+    {
+        TUniquePtr<FTypeStats> NewStats = MakeUnique<FTypeStats>();
+        NewStats->Struct = ScriptStruct;
+        NewStats->Name = ScriptStruct->GetName();
+        Stats = NewStats.Get();
+        AllTypeStats.Add(MoveTemp(NewStats));
+    }
+    return Stats;
+}
+
+void* FStructAllocator::AllocBlock(FSizeClass& SizeClass)
+{
+    FScopeLock ScopeLock(&SizeClass.Lock);
+    if (!SizeClass.FreeList)
+    {
+        uint8* Slab = static_cast<uint8*>(FMemory::Malloc(SlabSize, HeaderSize));
+        SizeClass.Slabs.Add(Slab);
+        INC_MEMORY_STAT_BY(STAT_PuertsStructSlabMemory, SlabSize);
+        // thread the slab in reverse so blocks are handed out in address order
+        for (uint32 Offset = (SlabSize / SizeClass.BlockSize) * SizeClass.BlockSize; Offset > 0;)
+        {
+            Offset -= SizeClass.BlockSize;
+            FFreeBlock* Block = reinterpret_cast<FFreeBlock*>(Slab + Offset);
+            Block->Next = SizeClass.FreeList;
+            SizeClass.FreeList = Block;
+        }
+    }
+    FFreeBlock* Block = SizeClass.FreeList;
+    SizeClass.FreeList = Block->Next;
+    return Block;
+}
+
+void* FStructAllocator::Malloc(UScriptStruct* ScriptStruct, int32 Size, int32 Alignment)
+{
+    FTypeStats* Stats = FindOrAddTypeStats(ScriptStruct);
+    Stats->LiveCount.fetch_add(1, std::memory_order_relaxed);
+    Stats->LiveBytes.fetch_add(Size, std::memory_order_relaxed);
+    Stats->TotalAllocs.fetch_add(1, std::memory_order_relaxed);
+    INC_DWORD_STAT(STAT_PuertsLiveStructs);
+    INC_MEMORY_STAT_BY(STAT_PuertsStructMemory, Size);
+
+    uint8* Payload;
+    uint8 SizeClass;
+    uint16 PayloadOffset;
+    const uint32 BlockSize = HeaderSize + Size;
+    // slab blocks are HeaderSize aligned
+    if (Alignment <= (int32) HeaderSize && BlockSize <= MaxSmallBlockSize)
+    {
+        SizeClass = UnitsToClass[(BlockSize + BlockGranularity - 1) / BlockGranularity];
+        PayloadOffset = HeaderSize;
+        Payload = static_cast<uint8*>(AllocBlock(SizeClasses[SizeClass])) + HeaderSize;
+    }
+    else
+    {
+        SizeClass = LargeBlockClass;
+        PayloadOffset = static_cast<uint16>(Align(HeaderSize, (uint32) Alignment));
+        Payload = static_cast<uint8*>(FMemory::Malloc(PayloadOffset + Size, FMath::Max(Alignment, (int32) HeaderSize))) + PayloadOffset;
+    }
+
+    FStructBlockHeader* Header = GetHeader(Payload);
+    Header->Stats = Stats;
+    Header->Size = Size;
+    Header->SizeClass = SizeClass;
+    Header->PayloadOffset = PayloadOffset;
+    return Payload;
+}
+
+void FStructAllocator::Free(void* Ptr)
+{
+    FStructBlockHeader* Header = GetHeader(Ptr);
+    Header->Stats->LiveCount.fetch_sub(1, std::memory_order_relaxed);
+    Header->Stats->LiveBytes.fetch_sub(Header->Size, std::memory_order_relaxed);
+    DEC_DWORD_STAT(STAT_PuertsLiveStructs);
+    DEC_MEMORY_STAT_BY(STAT_PuertsStructMemory, Header->Size);
+
+    if (Header->SizeClass == LargeBlockClass)
+    {
+        FMemory::Free(static_cast<uint8*>(Ptr) - Header->PayloadOffset);
+        return;
+    }
+
+    FSizeClass& SizeClass = SizeClasses[Header->SizeClass];
+    FFreeBlock* Block = reinterpret_cast<FFreeBlock*>(Header);
+    FScopeLock ScopeLock(&SizeClass.Lock);
+    Block->Next = SizeClass.FreeList;
+    SizeClass.FreeList = Block;
+}
+
+void FStructAllocator::GetTypeStats(TArray<FTypeStatsSnapshot>& OutStats) const
+{
+    FReadScopeLock ReadLock(TypeStatsLock);
+    OutStats.Reset(AllTypeStats.Num());
+    for (const TUniquePtr<FTypeStats>& Stats : AllTypeStats)
+    {
+        OutStats.Add({Stats->Name, Stats->LiveCount.load(std::memory_order_relaxed),
+            Stats->LiveBytes.load(std::memory_order_relaxed), Stats->TotalAllocs.load(std::memory_order_relaxed)});
+    }
+}
+
+void FStructAllocator::DumpTypeStats(FOutputDevice& Ar) const
+{
+    TArray<FTypeStatsSnapshot> Snapshots;
+    GetTypeStats(Snapshots);
+    Snapshots.Sort([](const FTypeStatsSnapshot& A, const FTypeStatsSnapshot& B) { return A.LiveBytes > B.LiveBytes; });
+
+    Ar.Logf(TEXT("%-40s %10s %12s %12s"), TEXT("Struct"), TEXT("Live"), TEXT("LiveBytes"), TEXT("TotalAllocs"));
+    for (const FTypeStatsSnapshot& Snapshot : Snapshots)
+    {
+        Ar.Logf(TEXT("%-40s %10d %12lld %12lld"), *Snapshot.Name, Snapshot.LiveCount, Snapshot.LiveBytes, Snapshot.TotalAllocs);
+    }
+}
+}    // namespace PUERTS_NAMESPACE
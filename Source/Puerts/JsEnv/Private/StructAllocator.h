@@ -0,0 +1,92 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "UObject/Class.h"
+#include "Misc/ScopeRWLock.h"
+#include "NamespaceDef.h"
+
+namespace PUERTS_NAMESPACE
+{
+// Size-class slab allocator for struct instances owned by JS (new UE.Vector2D(), struct return values...).
+// A header in front of each payload records the size class and the type statistics, so a block can be freed without its
+// UScriptStruct and from any thread: backing store deleters of POD structs run on v8 worker threads.
+class FStructAllocator
+{
+public:
+    struct FTypeStats
+    {
+        TWeakObjectPtr<UScriptStruct> Struct;
+        FString Name;
+        std::atomic<int32> LiveCount{0};
+        std::atomic<int64> LiveBytes{0};
+        std::atomic<int64> TotalAllocs{0};
+    };
+
+    struct FTypeStatsSnapshot
+    {
+        FString Name;
+        int32 LiveCount;
+        int64 LiveBytes;
+        int64 TotalAllocs;
+    };
+
+    static FStructAllocator& Get();
+
+    // uninitialized payload of Size bytes aligned to Alignment
+    void* Malloc(UScriptStruct* ScriptStruct, int32 Size, int32 Alignment);
+
+    void Free(void* Ptr);
+
+    void GetTypeStats(TArray<FTypeStatsSnapshot>& OutStats) const;
+
+    void DumpTypeStats(FOutputDevice& Ar) const;
+
+private:
+    struct FFreeBlock
+    {
+        FFreeBlock* Next;
+    };
+
+    struct FSizeClass
+    {
+        FCriticalSection Lock;
+        FFreeBlock* FreeList = nullptr;
+        TArray<void*> Slabs;
+        uint32 BlockSize = 0;
+    };
+
+    static constexpr int32 SizeClassNum = 10;
+
+    static constexpr uint32 BlockGranularity = 16;
+
+    static constexpr uint32 MaxSmallBlockSize = 320;
+
+    FStructAllocator();
+
+    FTypeStats* FindOrAddTypeStats(UScriptStruct* ScriptStruct);
+
+    void* AllocBlock(FSizeClass& SizeClass);
+
+    FSizeClass SizeClasses[SizeClassNum];
+
+    // block size in BlockGranularity units -> index into SizeClasses
+    uint8 UnitsToClass[MaxSmallBlockSize / BlockGranularity + 1];
+
+    mutable FRWLock TypeStatsLock;
+
+    TMap<const UScriptStruct*, FTypeStats*> TypeStatsMap;
+
+    // stats are never freed, live blocks of a collected struct still point to them
+    TArray<TUniquePtr<FTypeStats>> AllTypeStats;
+};
+}    // namespace PUERTS_NAMESPACE
@@ -7,6 +7,7 @@
  */
 
 #include "StructWrapper.h"
+#include "StructAllocator.h"
 #include "V8Utils.h"
 #include "ObjectMapper.h"
 #include "PathEscape.h"
@@ -633,10 +634,21 @@ void FScriptStructWrapper::New(
     }
 }
 
+static constexpr EStructFlags TrivialStructFlags = EStructFlags(STRUCT_IsPlainOldData | STRUCT_ZeroConstructor);
+
 void* FScriptStructWrapper::Alloc(UScriptStruct* InScriptStruct)
 {
-    void* ScriptStructMemory = new char[InScriptStruct->GetStructureSize()];
-    InScriptStruct->InitializeStruct(ScriptStructMemory);
+    const int32 Size = InScriptStruct->GetStructureSize();
+    void* ScriptStructMemory = FStructAllocator::Get().Malloc(InScriptStruct, Size, InScriptStruct->GetMinAlignment());
+    // Margin, Vector2D, LinearColor...: a zeroed block is a valid instance, skip the property walk
+    if ((InScriptStruct->StructFlags & TrivialStructFlags) == TrivialStructFlags)
+    {
+        FMemory::Memzero(ScriptStructMemory, Size);
+    }
+    else
+    {
+        InScriptStruct->InitializeStruct(ScriptStructMemory);
+    }
     return ScriptStructMemory;
 }
 
@@ -648,9 +660,10 @@ void FScriptStructWrapper::Free(TWeakObjectPtr<UStruct> InStruct, pesapi_finaliz
     }
     else
     {
-        if (InStruct.IsValid())
-            InStruct->DestroyStruct(Ptr);
-        delete[] static_cast<char*>(Ptr);
+        UScriptStruct* ScriptStruct = static_cast<UScriptStruct*>(InStruct.Get());
+        if (ScriptStruct && !(ScriptStruct->StructFlags & (STRUCT_IsPlainOldData | STRUCT_NoDestructor)))
+            ScriptStruct->DestroyStruct(Ptr);
+        FStructAllocator::Get().Free(Ptr);
     }
 }
 
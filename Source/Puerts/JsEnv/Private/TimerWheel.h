@@ -0,0 +1,227 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NamespaceDef.h"
+
+namespace PUERTS_NAMESPACE
+{
+// Hierarchical timer wheel with millisecond resolution, 4 levels x 64 slots (about 4.6 hours before a timer has to be
+// re-cascaded). Timers are intrusive nodes, so schedule and cancel are O(1) and never allocate.
+class FTimerWheel
+{
+public:
+    struct FNode
+    {
+        FNode* Prev = nullptr;
+        FNode* Next = nullptr;
+        uint64 Expire = 0;
+
+        FNode() = default;
+        FNode(const FNode&) = delete;
+        FNode& operator=(const FNode&) = delete;
+
+        ~FNode()
+        {
+            Unlink();
+        }
+
+        FORCEINLINE bool IsLinked() const
+        {
+            return Next != nullptr;
+        }
+
+        FORCEINLINE void Unlink()
+        {
+            if (Next)
+            {
+                Prev->Next = Next;
+                Next->Prev = Prev;
+                Prev = nullptr;
+                Next = nullptr;
+            }
+        }
+    };
+
+    // circular list with sentinel
+    struct FList
+    {
+        FNode Head;
+
+        FList()
+        {
+            Head.Prev = &Head;
+            Head.Next = &Head;
+        }
+
+        ~FList()
+        {
+            Clear();
+            Head.Prev = nullptr;
+            Head.Next = nullptr;
+        }
+
+        FORCEINLINE bool IsEmpty() const
+        {
+            return Head.Next == &Head;
+        }
+
+        FORCEINLINE void PushBack(FNode* Node)
+        {
+            Node->Prev = Head.Prev;
+            Node->Next = &Head;
+            Head.Prev->Next = Node;
+            Head.Prev = Node;
+        }
+
+        FORCEINLINE FNode* PopFront()
+        {
+            if (IsEmpty())
+            {
+                return nullptr;
+            }
+            FNode* Node = Head.Next;
+            Node->Unlink();
+            return Node;
+        }
+
+        // move all nodes of Other to the tail of this list
+        FORCEINLINE void Splice(FList& Other)
+        {
+            if (Other.IsEmpty())
+            {
+                return;
+            }
+            FNode* First = Other.Head.Next;
+            FNode* Last = Other.Head.Prev;
+            First->Prev = Head.Prev;
+            Head.Prev->Next = First;
+            Last->Next = &Head;
+            Head.Prev = Last;
+            Other.Head.Next = &Other.Head;
+            Other.Head.Prev = &Other.Head;
+        }
+
+        void Clear()
+        {
+            while (PopFront())
+            {
+            }
+        }
+    };
+
+    static constexpr int SlotBits = 6;
+    static constexpr int SlotsPerLevel = 1 << SlotBits;
+    static constexpr uint64 SlotMask = SlotsPerLevel - 1;
+    static constexpr int LevelNum = 4;
+    static constexpr uint64 MaxDelta = (uint64) 1 << (SlotBits * LevelNum);
+
+    FTimerWheel() : NextTick(1)
+    {
+    }
+
+    // last processed tick, timers should compute their expire time from it
+    FORCEINLINE uint64 Now() const
+    {
+        return NextTick - 1;
+    }
+
+    // a timer that is already due goes to the ready list and fires on the next Advance, never in the current one, so
+    // zero delay intervals fire once per Advance like they did with FTicker
+    void Schedule(FNode* Node, uint64 Expire)
+    {
+        Node->Unlink();
+        Node->Expire = Expire;
+        if (Expire < NextTick)
+        {
+            Ready.PushBack(Node);
+        }
+        else
+        {
+            Place(Node);
+        }
+    }
+
+    FORCEINLINE void Cancel(FNode* Node)
+    {
+        Node->Unlink();
+    }
+
+    // move all timers expired at or before Target to OutExpired
+    void Advance(uint64 Target, FList& OutExpired)
+    {
+        OutExpired.Splice(Ready);
+        while (NextTick <= Target)
+        {
+            const uint64 Index = NextTick & SlotMask;
+            if (Index == 0)
+            {
+                Cascade();
+            }
+            OutExpired.Splice(Slots[0][Index]);
+            ++NextTick;
+        }
+    }
+
+    void Clear()
+    {
+        Ready.Clear();
+        for (int Level = 0; Level < LevelNum; ++Level)
+        {
+            for (int Index = 0; Index < SlotsPerLevel; ++Index)
+            {
+                Slots[Level][Index].Clear();
+            }
+        }
+    }
+
+private:
+    void Place(FNode* Node)
+    {
+        uint64 Delta = Node->Expire - NextTick;
+        // too far away, park it in the farthest slot and it will be re-placed on cascade
+        uint64 SlotTime = Delta < MaxDelta ? Node->Expire : NextTick + MaxDelta - 1;
+        if (Delta >= MaxDelta)
+        {
+            Delta = MaxDelta - 1;
+        }
+        int Level = 0;
+        while (Delta >= ((uint64) 1 << (SlotBits * (Level + 1))))
+        {
+            ++Level;
+        }
+        Slots[Level][(SlotTime >> (SlotBits * Level)) & SlotMask].PushBack(Node);
+    }
+
+    void Cascade()
+    {
+        for (int Level = 1; Level < LevelNum; ++Level)
+        {
+            const uint64 Index = (NextTick >> (SlotBits * Level)) & SlotMask;
+            FList Pending;
+            Pending.Splice(Slots[Level][Index]);
+            while (FNode* Node = Pending.PopFront())
+            {
+                Place(Node);
+            }
+            if (Index != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    uint64 NextTick;
+
+    FList Ready;
+
+    FList Slots[LevelNum][SlotsPerLevel];
+};
+}    // namespace PUERTS_NAMESPACE
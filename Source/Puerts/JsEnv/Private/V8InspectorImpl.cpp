@@ -22,8 +22,13 @@
 #include "UECompatible.h"
 #endif
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <locale>
 #include <codecvt>
 
@@ -190,6 +195,8 @@ public:
 
     bool Tick() override;
 
+    void WaitForEvents(int Milliseconds) override;
+
     V8InspectorChannel* CreateV8InspectorChannel() override;
 
     v8::Local<v8::Context> ensureDefaultContextInGroup(int group_id) override
@@ -198,18 +205,43 @@ public:
     }
 
 private:
+    enum class EEventType
+    {
+        Open,
+        Message,
+        Close
+    };
+
+    struct FEvent
+    {
+        EEventType Type;
+        wspp_connection_hdl Handle;
+        // taken while the connection is alive, a close event may be handled after it is gone
+        void* Key;
+        std::string Payload;
+    };
+
+    // the v8 inspector is only created once somebody connects, an idle debug port costs no inspector state at all
+    v8_inspector::V8Inspector* GetOrCreateInspector();
+
+    // websocket server thread
     void OnHTTP(wspp_connection_hdl Handle);
 
     void OnOpen(wspp_connection_hdl Handle);
 
     void OnReceiveMessage(wspp_connection_hdl Handle, wspp_message_ptr Message);
 
-    void OnSendMessage(wspp_connection_hdl Handle, const std::string& Message);
-
     void OnClose(wspp_connection_hdl Handle);
 
     void OnFail(wspp_connection_hdl Handle);
 
+    void PushEvent(EEventType Type, wspp_connection_hdl Handle, std::string Payload);
+
+    // game thread
+    void OnSendMessage(wspp_connection_hdl Handle, const std::string& Message);
+
+    bool PopEvent(FEvent& OutEvent);
+
     void runMessageLoopOnPause(int ContextGroupId) override;
 
     void quitMessageLoopOnPause() override;
@@ -239,6 +271,19 @@ private:
 
     wspp_server Server;
 
+    std::thread ServerThread;
+
+    std::mutex EventsMutex;
+
+    std::condition_variable EventsCondition;
+
+    std::deque<FEvent> Events;
+
+    // lets Tick return without taking the lock (or any v8 scope) while nothing is pending
+    std::atomic<bool> HasPendingEvents;
+
+    bool ContextRegistered;
+
     std::string JSONVersion;
 
     std::string JSONList;
@@ -294,18 +339,16 @@ V8InspectorClientImpl::V8InspectorClientImpl(int32_t InPort, v8::Local<v8::Conte
         Isolate, v8::FunctionTemplate::New(Isolate, MicroTasksRunnerFunction)->GetFunction(InContext).ToLocalChecked());
     Port = InPort;
     IsAlive = false;
+    IsPaused = false;
     Connected = false;
+    HasPendingEvents = false;
+    ContextRegistered = false;
+#if defined(V8_HAS_WRAP_API_WITHOUT_STL)
+    V8Inspector = nullptr;
+#endif
 
     static int32_t CurrentCtxGroupID = 1;
     CtxGroupID = CurrentCtxGroupID++;
-    const uint8_t CtxNameConst[] = "V8InspectorContext";
-    v8_inspector::StringView CtxName(CtxNameConst, sizeof(CtxNameConst) - 1);
-#if defined(V8_HAS_WRAP_API_WITHOUT_STL)
-    V8Inspector = V8Inspector_Create_Without_Stl(Isolate, this);
-#else
-    V8Inspector = v8_inspector::V8Inspector::create(Isolate, this);
-#endif
-    V8Inspector->contextCreated(v8_inspector::V8ContextInfo(InContext, CtxGroupID, CtxName));
 
     if (Port < 0)
         return;
@@ -345,6 +388,23 @@ V8InspectorClientImpl::V8InspectorClientImpl(int32_t InPort, v8::Local<v8::Conte
 
         IsAlive = true;
 
+        ServerThread = std::thread(
+            [this]()
+            {
+                try
+                {
+                    Server.run();
+                }
+                catch (const wspp_exception& Exception)
+                {
+#if USING_UE
+                    ReportException(Exception, TEXT("Inspector Server"));
+#else
+                    puerts::PLog(puerts::Error, "Inspector Server: %s", Exception.what());
+#endif
+                }
+            });
+
 #if USING_UE
         FString InspectorUrl =
             FString::Printf(TEXT("devtools://devtools/bundled/inspector.html?v8only=true&ws=127.0.0.1:%d"), Port);
@@ -365,24 +425,45 @@ V8InspectorClientImpl::V8InspectorClientImpl(int32_t InPort, v8::Local<v8::Conte
         puerts::PLog(puerts::Error, "Failed to Startup Inspector.");
 #endif
     }
-
-    IsPaused = false;
 }
 
-V8InspectorChannel* V8InspectorClientImpl::CreateV8InspectorChannel()
+v8_inspector::V8Inspector* V8InspectorClientImpl::GetOrCreateInspector()
 {
+    if (!V8Inspector)
+    {
 #if defined(V8_HAS_WRAP_API_WITHOUT_STL)
-    return new V8InspectorChannelImpl(Isolate, V8Inspector, CtxGroupID);
+        V8Inspector = V8Inspector_Create_Without_Stl(Isolate, this);
 #else
-    return new V8InspectorChannelImpl(Isolate, V8Inspector.get(), CtxGroupID);
+        V8Inspector = v8_inspector::V8Inspector::create(Isolate, this);
+#endif
+        // scripts compiled before this point are reported by Debugger.enable as they are still alive
+        v8::Isolate::Scope IsolateScope(Isolate);
+        v8::HandleScope HandleScope(Isolate);
+        const uint8_t CtxNameConst[] = "V8InspectorContext";
+        v8_inspector::StringView CtxName(CtxNameConst, sizeof(CtxNameConst) - 1);
+        V8Inspector->contextCreated(v8_inspector::V8ContextInfo(Context.Get(Isolate), CtxGroupID, CtxName));
+        ContextRegistered = true;
+    }
+#if defined(V8_HAS_WRAP_API_WITHOUT_STL)
+    return V8Inspector;
+#else
+    return V8Inspector.get();
 #endif
 }
 
+V8InspectorChannel* V8InspectorClientImpl::CreateV8InspectorChannel()
+{
+    return new V8InspectorChannelImpl(Isolate, GetOrCreateInspector(), CtxGroupID);
+}
+
 V8InspectorClientImpl::~V8InspectorClientImpl()
 {
     Close();
 #if defined(V8_HAS_WRAP_API_WITHOUT_STL)
-    v8_inspector::V8Inspector_Destroy_Without_Stl(V8Inspector);
+    if (V8Inspector)
+    {
+        v8_inspector::V8Inspector_Destroy_Without_Stl(V8Inspector);
+    }
 #endif
 }
 
@@ -390,46 +471,134 @@ void V8InspectorClientImpl::Close()
 {
     if (IsAlive)
     {
+        // after the join every websocketpp object is only touched by this thread
+        Server.stop();
+        if (ServerThread.joinable())
+        {
+            ServerThread.join();
+        }
+        {
+            std::lock_guard<std::mutex> Lock(EventsMutex);
+            Events.clear();
+            HasPendingEvents = false;
+        }
+
 #ifdef THREAD_SAFE
         v8::Locker Locker(Isolate);
 #endif
-        Server.stop_listening();
         for (auto Iter = V8InspectorChannels.begin(); Iter != V8InspectorChannels.end(); ++Iter)
         {
             delete Iter->second;
         }
         V8InspectorChannels.clear();
+        IsAlive = false;
+        IsPaused = false;
+    }
 
+    if (ContextRegistered)
+    {
+#ifdef THREAD_SAFE
+        v8::Locker Locker(Isolate);
+#endif
         v8::Isolate::Scope IsolateScope(Isolate);
         v8::HandleScope HandleScope(Isolate);
         V8Inspector->contextDestroyed(Context.Get(Isolate));
-        IsAlive = false;
-        IsPaused = false;
+        ContextRegistered = false;
+    }
+}
+
+void V8InspectorClientImpl::PushEvent(EEventType Type, wspp_connection_hdl Handle, std::string Payload)
+{
+    {
+        std::lock_guard<std::mutex> Lock(EventsMutex);
+        Events.push_back(FEvent{Type, Handle, Handle.lock().get(), std::move(Payload)});
+        HasPendingEvents.store(true, std::memory_order_release);
     }
+    EventsCondition.notify_one();
+}
+
+bool V8InspectorClientImpl::PopEvent(FEvent& OutEvent)
+{
+    // one event at a time: dispatching a message can pause in runMessageLoopOnPause, which keeps draining this queue
+    std::lock_guard<std::mutex> Lock(EventsMutex);
+    if (Events.empty())
+    {
+        HasPendingEvents.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    OutEvent = std::move(Events.front());
+    Events.pop_front();
+    return true;
+}
+
+void V8InspectorClientImpl::WaitForEvents(int Milliseconds)
+{
+    std::unique_lock<std::mutex> Lock(EventsMutex);
+    EventsCondition.wait_for(Lock, std::chrono::milliseconds(Milliseconds), [this]() { return !Events.empty(); });
 }
 
 bool V8InspectorClientImpl::Tick(float /* DeltaTime */)
 {
+    if (!IsAlive || !HasPendingEvents.load(std::memory_order_acquire))
+    {
+        return true;
+    }
+
     try
     {
-        if (IsAlive)
-        {
 #ifdef THREAD_SAFE
-            v8::Locker Locker(Isolate);
+        v8::Locker Locker(Isolate);
 #endif
-
+        bool DispatchedMessage = false;
+        FEvent Event;
+        while (PopEvent(Event))
+        {
+            void* HandlePtr = Event.Key;
+            switch (Event.Type)
             {
-                // v8::Locker lock(Isolate);
-                Server.poll();
+                case EEventType::Open:
+                {
+                    V8InspectorChannelImpl* channel = static_cast<V8InspectorChannelImpl*>(CreateV8InspectorChannel());
+                    V8InspectorChannels[HandlePtr] = channel;
+                    channel->OnMessage(std::bind(&V8InspectorClientImpl::OnSendMessage, this, Event.Handle, std::placeholders::_1));
+                    break;
+                }
+                case EEventType::Message:
+                {
+                    auto Iter = V8InspectorChannels.find(HandlePtr);
+                    if (Iter != V8InspectorChannels.end())
+                    {
+                        Iter->second->DispatchProtocolMessage(Event.Payload);
+                        DispatchedMessage = true;
+                    }
+                    break;
+                }
+                case EEventType::Close:
+                {
+                    auto Iter = V8InspectorChannels.find(HandlePtr);
+                    if (Iter != V8InspectorChannels.end())
+                    {
+                        delete Iter->second;
+                        V8InspectorChannels.erase(Iter);
+                    }
+                    break;
+                }
+            }
+            if (!IsAlive)
+            {
+                break;
+            }
+        }
 
-                v8::Isolate::Scope IsolateScope(Isolate);
-                v8::HandleScope HandleScope(Isolate);
-                auto LocalContext = Context.Get(Isolate);
-                v8::Context::Scope ContextScope(LocalContext);
-                v8::TryCatch TryCatch(Isolate);
+        if (DispatchedMessage)
+        {
+            v8::Isolate::Scope IsolateScope(Isolate);
+            v8::HandleScope HandleScope(Isolate);
+            auto LocalContext = Context.Get(Isolate);
+            v8::Context::Scope ContextScope(LocalContext);
+            v8::TryCatch TryCatch(Isolate);
 
-                (void) (MicroTasksRunner.Get(Isolate)->Call(LocalContext, LocalContext->Global(), 0, nullptr));
-            }
+            (void) (MicroTasksRunner.Get(Isolate)->Call(LocalContext, LocalContext->Global(), 0, nullptr));
         }
     }
     catch (const wspp_exception& Exception)
@@ -499,9 +668,7 @@ void V8InspectorClientImpl::OnHTTP(wspp_connection_hdl Handle)
 
 void V8InspectorClientImpl::OnOpen(wspp_connection_hdl Handle)
 {
-    V8InspectorChannelImpl* channel = static_cast<V8InspectorChannelImpl*>(CreateV8InspectorChannel());
-    V8InspectorChannels[Handle.lock().get()] = channel;
-    channel->OnMessage(std::bind(&V8InspectorClientImpl::OnSendMessage, this, Handle, std::placeholders::_1));
+    PushEvent(EEventType::Open, Handle, std::string());
 #if USING_UE
     UE_LOG(LogV8Inspector, Display, TEXT("Inspector: Connect"));
 #else
@@ -516,14 +683,7 @@ void V8InspectorClientImpl::OnReceiveMessage(wspp_connection_hdl Handle, wspp_me
     //#else
     //    puerts::PLog(puerts::Log, "<---: %s", Message->get_payload().c_str());
     //#endif
-    auto channel = V8InspectorChannels[Handle.lock().get()];
-
-    {
-        // v8::Locker Locker(Isolate);
-        v8::Isolate::Scope IsolateScope(Isolate);
-        v8::SealHandleScope scope(Isolate);
-        channel->DispatchProtocolMessage(Message->get_payload());
-    }
+    PushEvent(EEventType::Message, Handle, std::move(Message->get_raw_payload()));
 }
 
 void V8InspectorClientImpl::OnSendMessage(wspp_connection_hdl Handle, const std::string& Message)
@@ -550,9 +710,7 @@ void V8InspectorClientImpl::OnSendMessage(wspp_connection_hdl Handle, const std:
 
 void V8InspectorClientImpl::OnClose(wspp_connection_hdl Handle)
 {
-    void* HandlePtr = Handle.lock().get();
-    delete V8InspectorChannels[HandlePtr];
-    V8InspectorChannels.erase(HandlePtr);
+    PushEvent(EEventType::Close, Handle, std::string());
 #if USING_UE
     UE_LOG(LogV8Inspector, Display, TEXT("Inspector: Disconnect"));
 #endif
@@ -578,10 +736,13 @@ void V8InspectorClientImpl::runMessageLoopOnPause(int /* ContextGroupId */)
 
     IsPaused = true;
 
-    while (IsPaused)
+    while (IsPaused && IsAlive)
     {
+        // the game thread is blocked here anyway, sleep until the front-end sends something
+        WaitForEvents(50);
         Tick();
     }
+    IsPaused = false;
 }
 
 void V8InspectorClientImpl::quitMessageLoopOnPause()
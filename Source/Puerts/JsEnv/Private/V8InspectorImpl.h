@@ -62,6 +62,9 @@ public:
 
     virtual bool Tick() = 0;
 
+    // block until the front-end sends something or Milliseconds passed, lets a waiting caller sleep between ticks
+    virtual void WaitForEvents(int Milliseconds) = 0;
+
     virtual V8InspectorChannel* CreateV8InspectorChannel() = 0;
 
     virtual ~V8Inspector()
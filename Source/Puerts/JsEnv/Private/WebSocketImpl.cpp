@@ -43,7 +43,9 @@ THIRD_PARTY_INCLUDES_END
 #undef UI
 PRAGMA_ENABLE_UNDEFINED_IDENTIFIER_WARNINGS
 
+#include <atomic>
 #include <sstream>
+#include <thread>
 
 namespace PUERTS_NAMESPACE
 {
@@ -75,11 +77,84 @@ public:
 };
 #endif
 
+// intrusive multi-producer single-consumer queue (Vyukov): producers never block each other or the consumer, the
+// consumer owns Tail and the node in front of the first element is always a spent dummy
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue()
+    {
+        Node* Stub = new Node();
+        Head.store(Stub, std::memory_order_relaxed);
+        Tail = Stub;
+    }
+
+    ~MpscQueue()
+    {
+        T Discard;
+        while (Pop(Discard))
+        {
+        }
+        delete Tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // returns the queue depth after the push
+    int Push(T&& Value)
+    {
+        Node* New = new Node();
+        New->Value = std::move(Value);
+        Node* Prev = Head.exchange(New, std::memory_order_acq_rel);
+        Prev->Next.store(New, std::memory_order_release);
+        return Depth.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // consumer thread only
+    bool Pop(T& Out)
+    {
+        Node* Next = Tail->Next.load(std::memory_order_acquire);
+        if (!Next)
+        {
+            return false;
+        }
+        Out = std::move(Next->Value);
+        delete Tail;
+        Tail = Next;
+        Depth.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    int Num() const
+    {
+        return Depth.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> Next{nullptr};
+        T Value;
+    };
+
+    std::atomic<Node*> Head;
+
+    Node* Tail;
+
+    std::atomic<int> Depth{0};
+};
+
+// The asio event loop of every client runs on its own I/O thread. Handlers there never touch v8, they only queue events,
+// and the game thread drains the queue from poll() with a per call budget.
 class V8WebSocketClientImpl
 {
 public:
     V8WebSocketClientImpl(v8::Isolate* InIsolate, v8::Local<v8::Context> InContext, v8::Local<v8::Object> InSelf);
 
+    ~V8WebSocketClientImpl();
+
 #if defined(WITH_WEBSOCKET_SSL)
     using wspp_client = websocketpp::client<websocketpp::config::asio_tls>;
 #else
@@ -113,9 +188,22 @@ public:
 
     void CloseImmediately(websocketpp::close::status::value const code, std::string const& reason);
 
-    void PollOne();
+    // dispatch up to Budget queued events (all of them if Budget <= 0), returns the number dispatched
+    int Poll(int Budget);
+
+    void Stats(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
 private:
+    struct PendingEvent
+    {
+        HandlerType Type = HANDLE_TYPE_END;
+        wspp_connection_hdl Handle;
+        wspp_message_ptr Message;
+        int Code = 0;
+        std::string Text;
+    };
+
+    // I/O thread
     void OnOpen(wspp_connection_hdl Handle);
 
     void OnMessage(wspp_connection_hdl Handle, wspp_message_ptr Message);
@@ -124,6 +212,15 @@ private:
 
     void OnFail(wspp_connection_hdl Handle);
 
+    void Enqueue(PendingEvent&& Event);
+
+    // game thread
+    void Dispatch(PendingEvent& Event);
+
+    v8::Local<v8::Value> MessageToValue(const wspp_message_ptr& Message);
+
+    void StopIoThread();
+
     void Cleanup();
 
 private:
@@ -135,6 +232,16 @@ private:
 
     wspp_client Client;
 
+    std::thread IoThread;
+
+    MpscQueue<PendingEvent> Queue;
+
+    std::atomic<int> PeakQueueDepth{0};
+
+    std::atomic<uint32_t> ReceivedMessages{0};
+
+    uint32_t DispatchedMessages = 0;
+
     wspp_connection_hdl Handle;
 
     bool Connenting = false;
@@ -156,6 +263,20 @@ V8WebSocketClientImpl::V8WebSocketClientImpl(v8::Isolate* InIsolate, v8::Local<v
     // UE_LOG(LogTemp, Warning, TEXT(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> set weak %p"), this);
 }
 
+V8WebSocketClientImpl::~V8WebSocketClientImpl()
+{
+    StopIoThread();
+}
+
+void V8WebSocketClientImpl::StopIoThread()
+{
+    if (IoThread.joinable())
+    {
+        Client.stop();
+        IoThread.join();
+    }
+}
+
 #if defined(WITH_WEBSOCKET_SSL)
 websocketpp::lib::shared_ptr<puerts_asio::ssl::context> on_tls_init(websocketpp::connection_hdl)
 {
@@ -198,6 +319,9 @@ void V8WebSocketClientImpl::Connect(const v8::FunctionCallbackInfo<v8::Value>& I
     // exchanged until the event loop starts running in the next line.
     Client.connect(con);
     Connenting = true;
+
+    // run() returns by itself once the connection is gone, the destructor stops it earlier if needed
+    IoThread = std::thread([this]() { Client.run(); });
 }
 
 void V8WebSocketClientImpl::Send(const v8::FunctionCallbackInfo<v8::Value>& Info)
@@ -335,93 +459,181 @@ void V8WebSocketClientImpl::CloseImmediately(websocketpp::close::status::value c
     Cleanup();
 }
 
-void V8WebSocketClientImpl::PollOne()
+void V8WebSocketClientImpl::OnOpen(wspp_connection_hdl InHandle)
+{
+    PendingEvent Event;
+    Event.Type = ON_OPEN;
+    Event.Handle = InHandle;
+    Enqueue(std::move(Event));
+}
+
+void V8WebSocketClientImpl::OnMessage(wspp_connection_hdl InHandle, wspp_message_ptr InMessage)
+{
+    ReceivedMessages.fetch_add(1, std::memory_order_relaxed);
+    PendingEvent Event;
+    Event.Type = ON_MESSAGE;
+    Event.Message = std::move(InMessage);
+    Enqueue(std::move(Event));
+}
+
+void V8WebSocketClientImpl::OnClose(wspp_connection_hdl InHandle)
+{
+    PendingEvent Event;
+    Event.Type = ON_CLOSE;
+    wspp_client::connection_ptr con = Client.get_con_from_hdl(InHandle);
+    Event.Code = con->get_remote_close_code();
+    Event.Text = con->get_remote_close_reason();
+    Enqueue(std::move(Event));
+}
+
+void V8WebSocketClientImpl::OnFail(wspp_connection_hdl InHandle)
+{
+    PendingEvent Event;
+    Event.Type = ON_FAIL;
+    wspp_client::connection_ptr con = Client.get_con_from_hdl(InHandle);
+    std::stringstream ss;
+    ss << "on fail: " << con->get_ec().message() << "[" << con->get_ec().value() << "]" << std::endl;
+    Event.Text = ss.str();
+    Enqueue(std::move(Event));
+}
+
+void V8WebSocketClientImpl::Enqueue(PendingEvent&& Event)
 {
-    if (Connenting || !Handle.expired())
+    const int Depth = Queue.Push(std::move(Event));
+    int Peak = PeakQueueDepth.load(std::memory_order_relaxed);
+    while (Depth > Peak && !PeakQueueDepth.compare_exchange_weak(Peak, Depth, std::memory_order_relaxed))
     {
-        Client.poll_one();
     }
 }
 
-void V8WebSocketClientImpl::OnOpen(wspp_connection_hdl InHandle)
+int V8WebSocketClientImpl::Poll(int Budget)
 {
-    Handle = InHandle;
-    Connenting = false;
+    if (!Isolate || Queue.Num() == 0)
+    {
+        return 0;
+    }
 
+    // one scope for the whole batch
     v8::Isolate::Scope IsolateScope(Isolate);
     v8::HandleScope HandleScope(Isolate);
-    if (!Handles[ON_OPEN].IsEmpty())
+
+    int Count = 0;
+    PendingEvent Event;
+    // a close or fail event cleans up and resets Isolate
+    while (Isolate && (Budget <= 0 || Count < Budget) && Queue.Pop(Event))
     {
-        v8::Local<v8::Value> args[1];
-        // must not raise exception in js, recommend just push a pending msg and process later.
-        Handles[ON_OPEN].Get(Isolate)->Call(GContext.Get(Isolate), v8::Undefined(Isolate), 0, args);
+        ++Count;
+        Dispatch(Event);
+        Event = PendingEvent();
     }
+    return Count;
 }
 
-void V8WebSocketClientImpl::OnMessage(wspp_connection_hdl InHandle, wspp_message_ptr InMessage)
+void V8WebSocketClientImpl::Dispatch(PendingEvent& Event)
 {
-    v8::Isolate::Scope IsolateScope(Isolate);
-    v8::HandleScope HandleScope(Isolate);
-
-    if (!Handles[ON_MESSAGE].IsEmpty())
+    switch (Event.Type)
     {
-        v8::Local<v8::Value> args[1];
-        if (InMessage->get_opcode() == websocketpp::frame::opcode::TEXT)
+        case ON_OPEN:
         {
-            args[0] = v8::String::NewFromUtf8(
-                Isolate, InMessage->get_payload().c_str(), v8::NewStringType::kNormal, InMessage->get_payload().size())
-                          .ToLocalChecked();
+            Handle = Event.Handle;
+            Connenting = false;
+            if (!Handles[ON_OPEN].IsEmpty())
+            {
+                v8::Local<v8::Value> args[1];
+                // must not raise exception in js, recommend just push a pending msg and process later.
+                Handles[ON_OPEN].Get(Isolate)->Call(GContext.Get(Isolate), v8::Undefined(Isolate), 0, args);
+            }
+            break;
         }
-        else if (InMessage->get_opcode() == websocketpp::frame::opcode::BINARY)
+        case ON_MESSAGE:
         {
-            v8::Local<v8::ArrayBuffer> Ab = v8::ArrayBuffer::New(Isolate, InMessage->get_payload().size());
-            void* Buff = DataTransfer::GetArrayBufferData(Ab);
-            ::memcpy(Buff, InMessage->get_payload().data(), InMessage->get_payload().size());
-            args[0] = Ab;
+            ++DispatchedMessages;
+            if (!Handles[ON_MESSAGE].IsEmpty())
+            {
+                v8::Local<v8::Value> args[1] = {MessageToValue(Event.Message)};
+                // must not raise exception in js, recommend just push a pending msg and process later.
+                Handles[ON_MESSAGE].Get(Isolate)->Call(GContext.Get(Isolate), v8::Undefined(Isolate), 1, args);
+            }
+            break;
         }
-        else
+        case ON_CLOSE:
         {
-            args[0] = v8::Undefined(Isolate);
+            if (!Handles[ON_CLOSE].IsEmpty())
+            {
+                v8::Local<v8::Value> args[2] = {v8::Integer::New(Isolate, Event.Code),
+                    v8::String::NewFromUtf8(Isolate, Event.Text.c_str(), v8::NewStringType::kNormal, Event.Text.size())
+                        .ToLocalChecked()};
+                // must not raise exception in js, recommend just push a pending msg and process later.
+                Handles[ON_CLOSE].Get(Isolate)->Call(GContext.Get(Isolate), v8::Undefined(Isolate), 2, args);
+            }
+            Cleanup();
+            break;
         }
-        // must not raise exception in js, recommend just push a pending msg and process later.
-        Handles[ON_MESSAGE].Get(Isolate)->Call(GContext.Get(Isolate), v8::Undefined(Isolate), 1, args);
+        case ON_FAIL:
+        {
+            if (!Handles[ON_FAIL].IsEmpty())
+            {
+                v8::Local<v8::Value> args[1] = {
+                    v8::String::NewFromUtf8(Isolate, Event.Text.c_str(), v8::NewStringType::kNormal, Event.Text.size())
+                        .ToLocalChecked()};
+                // must not raise exception in js, recommend just push a pending msg and process later.
+                Handles[ON_FAIL].Get(Isolate)->Call(GContext.Get(Isolate), v8::Undefined(Isolate), 1, args);
+            }
+            CloseImmediately(websocketpp::close::status::abnormal_close, "");
+            break;
+        }
+        default:
+            break;
     }
 }
 
-void V8WebSocketClientImpl::OnClose(wspp_connection_hdl InHandle)
+v8::Local<v8::Value> V8WebSocketClientImpl::MessageToValue(const wspp_message_ptr& Message)
 {
-    v8::Isolate::Scope IsolateScope(Isolate);
-    v8::HandleScope HandleScope(Isolate);
-
-    if (!Handles[ON_CLOSE].IsEmpty())
+    if (Message->get_opcode() == websocketpp::frame::opcode::TEXT)
     {
-        wspp_client::connection_ptr con = Client.get_con_from_hdl(InHandle);
-        v8::Local<v8::Value> args[2] = {v8::Integer::New(Isolate, con->get_remote_close_code()),
-            v8::String::NewFromUtf8(
-                Isolate, con->get_remote_close_reason().c_str(), v8::NewStringType::kNormal, con->get_remote_close_reason().size())
-                .ToLocalChecked()};
-        // must not raise exception in js, recommend just push a pending msg and process later.
-        Handles[ON_CLOSE].Get(Isolate)->Call(GContext.Get(Isolate), v8::Undefined(Isolate), 2, args);
+        const std::string& Payload = Message->get_payload();
+        return v8::String::NewFromUtf8(Isolate, Payload.c_str(), v8::NewStringType::kNormal, Payload.size()).ToLocalChecked();
     }
-    Cleanup();
+    else if (Message->get_opcode() == websocketpp::frame::opcode::BINARY)
+    {
+        std::string& Payload = Message->get_raw_payload();
+#if defined(HAS_ARRAYBUFFER_NEW_WITHOUT_STL) || defined(WITH_BACKING_STORE_AUTO_FREE) || !defined(USING_IN_UNREAL_ENGINE)
+        // the ArrayBuffer borrows the payload and keeps the message alive, the deleter may run on a v8 worker thread
+        auto Holder = new wspp_message_ptr(Message);
+        auto Deleter = [](void* Data, size_t Length, void* DeleterData) { delete static_cast<wspp_message_ptr*>(DeleterData); };
+#if defined(HAS_ARRAYBUFFER_NEW_WITHOUT_STL)
+        return v8::ArrayBuffer_New_Without_Stl(Isolate, &Payload[0], Payload.size(), Deleter, Holder);
+#else
+        auto Backing = v8::ArrayBuffer::NewBackingStore(&Payload[0], Payload.size(), Deleter, Holder);
+        return v8::ArrayBuffer::New(Isolate, std::move(Backing));
+#endif
+#else
+        v8::Local<v8::ArrayBuffer> Ab = v8::ArrayBuffer::New(Isolate, Payload.size());
+        void* Buff = DataTransfer::GetArrayBufferData(Ab);
+        ::memcpy(Buff, Payload.data(), Payload.size());
+        return Ab;
+#endif
+    }
+    return v8::Undefined(Isolate);
 }
 
-void V8WebSocketClientImpl::OnFail(wspp_connection_hdl InHandle)
+void V8WebSocketClientImpl::Stats(const v8::FunctionCallbackInfo<v8::Value>& Info)
 {
-    v8::Isolate::Scope IsolateScope(Isolate);
-    v8::HandleScope HandleScope(Isolate);
-
-    if (!Handles[ON_FAIL].IsEmpty())
-    {
-        wspp_client::connection_ptr con = Client.get_con_from_hdl(InHandle);
-        std::stringstream ss;
-        ss << "on fail: " << con->get_ec().message() << "[" << con->get_ec().value() << "]" << std::endl;
-        v8::Local<v8::Value> args[1] = {
-            v8::String::NewFromUtf8(Isolate, ss.str().c_str(), v8::NewStringType::kNormal, ss.str().size()).ToLocalChecked()};
-        // must not raise exception in js, recommend just push a pending msg and process later.
-        Handles[ON_FAIL].Get(Isolate)->Call(GContext.Get(Isolate), v8::Undefined(Isolate), 1, args);
-    }
-    CloseImmediately(websocketpp::close::status::abnormal_close, "");
+    auto isolate = Info.GetIsolate();
+    auto context = isolate->GetCurrentContext();
+    auto res = v8::Object::New(isolate);
+    res->Set(context, v8::String::NewFromUtf8(isolate, "queued").ToLocalChecked(), v8::Integer::New(isolate, Queue.Num()))
+        .Check();
+    res->Set(context, v8::String::NewFromUtf8(isolate, "peakQueued").ToLocalChecked(),
+           v8::Integer::New(isolate, PeakQueueDepth.load(std::memory_order_relaxed)))
+        .Check();
+    res->Set(context, v8::String::NewFromUtf8(isolate, "received").ToLocalChecked(),
+           v8::Integer::NewFromUnsigned(isolate, ReceivedMessages.load(std::memory_order_relaxed)))
+        .Check();
+    res->Set(context, v8::String::NewFromUtf8(isolate, "dispatched").ToLocalChecked(),
+           v8::Integer::NewFromUnsigned(isolate, DispatchedMessages))
+        .Check();
+    Info.GetReturnValue().Set(res);
 }
 
 }    // namespace PUERTS_NAMESPACE
@@ -473,8 +685,17 @@ void InitWebsocketPPWrap(v8::Local<v8::Context> Context)
             [](const v8::FunctionCallbackInfo<v8::Value>& Info)
             {
                 v8::TryCatch TryCatch(Info.GetIsolate());
+                int Budget = Info[0]->IsInt32() ? Info[0]->Int32Value(Info.GetIsolate()->GetCurrentContext()).FromJust() : 0;
+                Info.GetReturnValue().Set(
+                    static_cast<PUERTS_NAMESPACE::V8WebSocketClientImpl*>(Info.Holder()->GetAlignedPointerFromInternalField(0))
+                        ->Poll(Budget));
+            }));
+
+    WSTemplate->PrototypeTemplate()->Set(v8::String::NewFromUtf8(Isolate, "stats").ToLocalChecked(),
+        v8::FunctionTemplate::New(Isolate,
+            [](const v8::FunctionCallbackInfo<v8::Value>& Info) {
                 static_cast<PUERTS_NAMESPACE::V8WebSocketClientImpl*>(Info.Holder()->GetAlignedPointerFromInternalField(0))
-                    ->PollOne();
+                    ->Stats(Info);
             }));
 
     Context->Global()->Set(Context, v8::String::NewFromUtf8(Isolate, "WebSocketPP").ToLocalChecked(),
@@ -330,6 +330,17 @@ public:
     static v8::Local<v8::Value> FindOrAddStruct(
         v8::Isolate* Isolate, v8::Local<v8::Context> Context, UScriptStruct* ScriptStruct, void* Ptr, bool PassByPointer);
 
+    // initialized instance whose ownership can be passed to FindOrAddStruct with PassByPointer == false
+    static void* NewStruct(UScriptStruct* ScriptStruct);
+
+    template <typename T>
+    static T* NewStruct(const T& Value)
+    {
+        T* Ptr = static_cast<T*>(NewStruct(TScriptStructTraits<T>::Get()));
+        *Ptr = Value;
+        return Ptr;
+    }
+
     template <typename T>
     static bool IsInstanceOf(v8::Isolate* Isolate, v8::Local<v8::Value> JsObject)
     {
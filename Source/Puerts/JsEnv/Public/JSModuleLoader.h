@@ -14,6 +14,17 @@
 
 namespace PUERTS_NAMESPACE
 {
+// file content borrowed from a loader that keeps it resident, see IJSModuleLoader::LoadView
+struct FModuleContentView
+{
+    const uint8* Data = nullptr;
+    int32 Size = 0;
+    // 7-bit ASCII, can back a v8 external one-byte string without conversion
+    bool OneByte = false;
+    const uint8* CodeCache = nullptr;
+    int32 CodeCacheSize = 0;
+};
+
 class IJSModuleLoader
 {
 public:
@@ -21,8 +32,19 @@ public:
 
     virtual bool Load(const FString& Path, TArray<uint8>& Content) = 0;
 
+    // zero-copy variant of Load, the view must stay valid as long as the JsEnv using this loader
+    virtual bool LoadView(const FString& Path, FModuleContentView& View)
+    {
+        return false;
+    }
+
     virtual FString& GetScriptRoot() = 0;
 
+    // forget resolved module paths, called before scripts are reloaded
+    virtual void InvalidateSearchCache()
+    {
+    }
+
     virtual ~IJSModuleLoader()
     {
     }
@@ -31,14 +53,17 @@ public:
 class JSENV_API DefaultJSModuleLoader : public IJSModuleLoader
 {
 public:
-    explicit DefaultJSModuleLoader(const FString& InScriptRoot) : ScriptRoot(InScriptRoot)
-    {
-    }
+    explicit DefaultJSModuleLoader(const FString& InScriptRoot);
+
+    virtual ~DefaultJSModuleLoader() override;
 
     virtual bool Search(const FString& RequiredDir, const FString& RequiredModule, FString& Path, FString& AbsolutePath) override;
 
     virtual bool Load(const FString& Path, TArray<uint8>& Content) override;
 
+    // served from the mounted FScriptArchive
+    virtual bool LoadView(const FString& Path, FModuleContentView& View) override;
+
     virtual FString& GetScriptRoot() override;
 
     virtual bool CheckExists(const FString& PathIn, FString& Path, FString& AbsolutePath);
@@ -47,7 +72,43 @@ public:
 
     virtual bool SearchModuleWithExtInDir(const FString& Dir, const FString& RequiredModule, FString& Path, FString& AbsolutePath);
 
+    // drop all cached Search results, called when files under the script roots are added, removed or renamed and when
+    // the env reloads scripts
+    virtual void InvalidateSearchCache() override;
+
+    // write every Search result seen so far to Content/<ScriptRoot>/ModuleResolveManifest.json, a packaged build that ships
+    // the manifest resolves those requires without touching the file system
+    bool SaveResolveManifest();
+
     FString ScriptRoot;
+
+    bool EnableSearchCache = true;
+
+private:
+    struct FResolvedModule
+    {
+        bool Found;
+        FString Path;
+        FString AbsolutePath;
+    };
+
+    bool SearchWithoutCache(const FString& RequiredDir, const FString& RequiredModule, FString& Path, FString& AbsolutePath);
+
+    void LoadResolveManifest();
+
+    FString GetResolveManifestPath() const;
+
+    TMap<FString, FResolvedModule> SearchCache;
+
+    FCriticalSection SearchCacheCritical;
+
+#if WITH_EDITOR
+    void WatchScriptRoots();
+
+    void UnwatchScriptRoots();
+
+    TMap<FString, FDelegateHandle> WatchedRoots;
+#endif
 };
 
 }    // namespace PUERTS_NAMESPACE
@@ -22,6 +22,27 @@
 
 namespace PUERTS_NAMESPACE
 {
+// snapshot of how busy an env is, used to spread independent script roots over several envs
+struct FJsEnvLoadStats
+{
+    int32 LiveObjectWrappers = 0;
+    int32 LiveStructWrappers = 0;
+    uint64 UsedHeapSize = 0;
+    uint64 TotalHeapSize = 0;
+    // accumulated time spent running js entered from native (start, timers, frame callbacks, delegates, ts/mixin methods)
+    double ScriptSeconds = 0;
+};
+
+// per env heap budget
+struct FJsEnvHeapLimits
+{
+    // above it v8 is told about memory pressure (starts incremental collection) at most once a second, 0 disables
+    uint64 SoftLimitBytes = 0;
+    // near the v8 heap limit a full gc is scheduled at the end of the frame and the limit is raised a little meanwhile, it
+    // is a hard cap only if the env was created with a matching --max-old-space-size flag. 0 disables
+    uint64 HardLimitBytes = 0;
+};
+
 class JSENV_API IJsEnv
 {
 public:
@@ -57,6 +78,14 @@ public:
 
     virtual void ForceReloadJsFile(const FString& ModuleName) = 0;
 
+    virtual void GetLoadStats(FJsEnvLoadStats& OutStats) = 0;
+
+    virtual void SetHeapLimits(const FJsEnvHeapLimits& Limits) = 0;
+
+    virtual bool StartCpuProfiling(int32 SamplingIntervalUs, bool bFrameStats) = 0;
+
+    virtual bool StopCpuProfiling(const FString& OutBasePath) = 0;
+
     virtual ~IJsEnv()
     {
     }
@@ -104,6 +133,21 @@ public:
 
     void ForceReloadJsFile(const FString& ModuleName);
 
+    void GetLoadStats(FJsEnvLoadStats& OutStats);
+
+    void SetHeapLimits(const FJsEnvHeapLimits& Limits);
+
+    // sample js with the v8 cpu profiler, no inspector needed. With frame stats the hottest functions of every frame are
+    // reported to stats / csv / insights. Returns false if already profiling or the backend has no cpu profiler
+    bool StartCpuProfiling(int32 SamplingIntervalUs = 1000, bool bFrameStats = false);
+
+    // writes OutBasePath.cpuprofile (chrome devtools format) and OutBasePath.folded (flame graph input)
+    bool StopCpuProfiling(const FString& OutBasePath);
+
+    // broadcast before an env is created and before the scripts are packed, so whoever still writes files into the script
+    // root (e.g. a background copy) can finish first
+    static FSimpleMulticastDelegate& OnWaitForScriptFiles();
+
 private:
     std::unique_ptr<IJsEnv> GameScript;
 };
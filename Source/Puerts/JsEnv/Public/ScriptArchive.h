@@ -0,0 +1,125 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 Tencent.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#include "PuertsNamespaceDef.h"
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+namespace PUERTS_NAMESPACE
+{
+// Read-only pack of the files under one or more content sub directories (scripts, css, images, spine data...).
+//
+// layout: FHeader | 16 byte aligned blobs | index
+// the index maps a path relative to the project content dir to offset, size, crc and an optional code cache blob. The
+// archive is memory-mapped once, so a lookup never touches the file system and entries can be handed to V8 without a copy.
+// Only runtime scripts and the assets they load are packed, anything else is still read from disk.
+class JSENV_API FScriptArchive
+{
+public:
+    enum EEntryFlags : uint32
+    {
+        // content is 7-bit ASCII, can back a v8 external one-byte string as it is
+        EF_OneByte = 1 << 0,
+    };
+
+    struct FEntry
+    {
+        uint64 Offset = 0;
+        uint64 Size = 0;
+        uint32 Hash = 0;
+        uint32 Flags = 0;
+        uint64 CodeCacheOffset = 0;
+        uint64 CodeCacheSize = 0;
+        // position in VerifyStates, not stored in the archive
+        int32 Index = 0;
+    };
+
+    static FScriptArchive& Get();
+
+    // Content/JavaScript/ScriptArchive.bin, it is staged along with the scripts
+    static FString GetDefaultArchivePath();
+
+    // pack the scripts and script side assets under ProjectContentDir()/<Root> for each root, node_modules is skipped. A
+    // "<file>.codecache" next to a file is stored as its code cache blob instead of as an entry
+    static bool Pack(const TArray<FString>& Roots, const FString& ArchivePath);
+
+    // broadcast by Pack once the script files are settled and before they are collected, lets plugins write files that
+    // are derived from the scripts (e.g. hashes checked at runtime) into a packed root
+    static FSimpleMulticastDelegate& OnPrePack();
+
+    ~FScriptArchive();
+
+    bool Mount(const FString& ArchivePath);
+
+    void Unmount();
+
+    FORCEINLINE bool IsMounted() const
+    {
+        return Base != nullptr;
+    }
+
+    // Path can be relative (as produced by FPaths::ProjectContentDir()) or absolute. The crc of an entry is checked the
+    // first time it is found, an entry that does not match is treated as missing and read from disk instead
+    const FEntry* Find(const FString& Path) const;
+
+    FORCEINLINE const uint8* GetData(const FEntry& Entry) const
+    {
+        return Base + Entry.Offset;
+    }
+
+    FORCEINLINE const uint8* GetCodeCache(const FEntry& Entry) const
+    {
+        return Entry.CodeCacheSize > 0 ? Base + Entry.CodeCacheOffset : nullptr;
+    }
+
+    // the helpers below read the archive first and fall back to the file system for paths it has no entry for
+    bool FileExists(const FString& Path) const;
+
+    bool LoadFileToArray(const FString& Path, TArray<uint8>& OutContent) const;
+
+    bool LoadFileToString(const FString& Path, FString& OutContent) const;
+
+private:
+    FString ToEntryKey(const FString& Path) const;
+
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+
+    // used when the platform file can not map the archive (e.g. it lives inside a compressed pak)
+    TArray<uint8> FallbackBuffer;
+
+    const uint8* Base = nullptr;
+
+    uint64 BaseSize = 0;
+
+    TMap<FString, FEntry> Entries;
+
+    enum EVerifyState : uint8
+    {
+        VS_Unchecked,
+        VS_Valid,
+        VS_Corrupted,
+    };
+
+    // per entry, checking lazily keeps mounting from touching every mapped page at boot
+    mutable TUniquePtr<std::atomic<uint8>[]> VerifyStates;
+
+    FString ContentDir;
+
+    FString FullContentDir;
+};
+}    // namespace PUERTS_NAMESPACE
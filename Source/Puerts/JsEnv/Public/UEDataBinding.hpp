@@ -547,7 +547,7 @@ struct Converter<T, typename std::enable_if<internal::IsUStructHelper<T>::value>
 {
     static v8::Local<v8::Value> toScript(v8::Local<v8::Context> context, const T value)
     {
-        return DataTransfer::FindOrAddStruct<T>(context->GetIsolate(), context, new T(value), false);
+        return DataTransfer::FindOrAddStruct<T>(context->GetIsolate(), context, DataTransfer::NewStruct(value), false);
     }
 
     static T toCpp(v8::Local<v8::Context> context, const v8::Local<v8::Value>& value)
@@ -128,6 +128,11 @@ FString UFileSystemOperation::FileMD5Hash(FString Path)
     return LexToString(Hash);
 }
 
+FString UFileSystemOperation::FileTimeStamp(FString Path)
+{
+    return LexToString(IFileManager::Get().GetTimeStamp(*Path).GetTicks());
+}
+
 void UFileSystemOperation::CopyDirectory(FString Source, FString Dest, bool bOverride)
 {
     IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
@@ -16,6 +16,8 @@
 #include "SourceFileWatcher.h"
 #include "JSLogger.h"
 #include "JSModuleLoader.h"
+#include "ScriptArchive.h"
+#include "GameDelegates.h"
 #include "Binding.hpp"
 #include "UEDataBinding.hpp"
 #include "Object.hpp"
@@ -55,6 +57,8 @@ private:
     std::function<void(const FString&, const FString&)> CmdImpl;
 
     TUniquePtr<FAutoConsoleCommand> ConsoleCommand;
+
+    bool PacksScriptArchiveOnCook = false;
 };
 
 UsingCppType(FPuertsEditorModule);
@@ -104,6 +108,19 @@ void FPuertsEditorModule::StartupModule()
                     UE_LOG(Puerts, Error, TEXT("Puerts command not initialized"));
                 }
             }));
+
+    // pack the scripts when the cooker collects its files, the archive is staged with Content/JavaScript
+    FCookModificationDelegate& CookModificationDelegate = FGameDelegates::Get().GetCookModificationDelegate();
+    if (!CookModificationDelegate.IsBound())
+    {
+        CookModificationDelegate.BindLambda(
+            [](TArray<FString>& ExtraFilesToCook)
+            {
+                PUERTS_NAMESPACE::FScriptArchive::Pack(
+                    TArray<FString>{TEXT("JavaScript")}, PUERTS_NAMESPACE::FScriptArchive::GetDefaultArchivePath());
+            });
+        PacksScriptArchiveOnCook = true;
+    }
     this->OnPostEngineInit();
 }
 
@@ -154,6 +171,11 @@ void FPuertsEditorModule::OnPostEngineInit()
 void FPuertsEditorModule::ShutdownModule()
 {
     CmdImpl = nullptr;
+    if (PacksScriptArchiveOnCook)
+    {
+        FGameDelegates::Get().GetCookModificationDelegate().Unbind();
+        PacksScriptArchiveOnCook = false;
+    }
     if (JsEnv.IsValid())
     {
         JsEnv.Reset();
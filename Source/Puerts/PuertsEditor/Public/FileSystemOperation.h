@@ -50,6 +50,10 @@ class PUERTSEDITOR_API UFileSystemOperation : public UBlueprintFunctionLibrary
     UFUNCTION(BlueprintCallable, Category = "File")
     static FString FileMD5Hash(FString Path);
 
+    // modification time in ticks as a string, cheap enough to poll before deciding whether a file needs rehashing
+    UFUNCTION(BlueprintCallable, Category = "File")
+    static FString FileTimeStamp(FString Path);
+
 	UFUNCTION(BlueprintCallable, Category = "File")
 	static void CopyDirectory(FString Source, FString Dest, bool bOverride = true);
 
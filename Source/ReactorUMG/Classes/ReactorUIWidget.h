@@ -11,15 +11,35 @@ class REACTORUMG_API UReactorUIWidget : public UUserWidget
 public:
 	virtual bool Initialize() override;
 	virtual void BeginDestroy() override;
+
+	// true while the first render of the script attaches to the prerendered widget tree
+	bool IsHydrating() const { return bHydrating; }
+
+	void FinishHydration() { bHydrating = false; }
+
+	// start the launch script now when its start was deferred by the class ScriptStartMode, e.g. behind a loading screen
+	UFUNCTION(BlueprintCallable, Category="ReactorUMG")
+	void Prewarm();
+
+	UFUNCTION(BlueprintCallable, Category="ReactorUMG")
+	bool IsScriptStartPending() const { return bScriptStartPending; }
+
+	virtual void SetVisibility(ESlateVisibility InVisibility) override;
+	virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
+	// stops starting deferred scripts in idle frames, called on module shutdown
+	static void ShutdownIdleScriptStarts();
 	
 protected:
 	void SetNewWidgetTree();
+	virtual TSharedRef<SWidget> RebuildWidget() override;
 #if WITH_EDITOR
 	virtual const FText GetPaletteCategory() override;
 #endif // WITH_EDITOR
 	
 private:
 	void RunScriptToInitWidgetTree();
+	bool IsShownOnScreen() const;
 	void ReleaseJsEnv();
 
 	UPROPERTY()
@@ -34,5 +54,12 @@ private:
 	TSharedPtr<puerts::FJsEnv> JsEnv;
 
 	bool bWidgetTreeInitialized;
+
+	bool bHydrating;
+
+	bool bScriptStartPending;
+
+	// content of a widget taken while its script was still pending, filled in once the script has run
+	TSharedPtr<class SBox> DeferredContent;
 };
 
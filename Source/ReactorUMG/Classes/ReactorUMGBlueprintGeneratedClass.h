@@ -11,6 +11,18 @@
 
 #include "ReactorUMGBlueprintGeneratedClass.generated.h"
 
+// when a ReactorUIWidget runs its launch script
+UENUM(BlueprintType)
+enum class EReactorScriptStartMode : uint8
+{
+	// run the script as soon as the widget is initialized
+	Immediate,
+	// wait until the widget is first shown on screen, or Prewarm is called
+	OnFirstVisible,
+	// like OnFirstVisible, but also start it in a cheap frame while the widget is still hidden
+	Idle,
+};
+
 UCLASS()
 class REACTORUMG_API UReactorUMGBlueprintGeneratedClass : public UWidgetBlueprintGeneratedClass
 {
@@ -33,4 +45,17 @@ public:
 
 	UPROPERTY(BlueprintReadOnly, Category="ReactorUMG")
 	FString WidgetName;
+
+	UPROPERTY(BlueprintReadOnly, Category="ReactorUMG")
+	EReactorScriptStartMode ScriptStartMode = EReactorScriptStartMode::Immediate;
+
+	// md5 of the launch script the widget tree archetype was prerendered with, empty when there is no prerendered tree
+	UPROPERTY()
+	FString PrerenderedScriptHash;
+
+	// the prerendered tree is only reused while the shipped launch script is the one that rendered it
+	bool CanHydrateWidgetTree() const;
+
+private:
+	mutable TOptional<bool> bPrerenderedTreeUpToDate;
 };
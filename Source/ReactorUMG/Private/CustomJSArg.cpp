@@ -1,6 +1,6 @@
 #include "CustomJSArg.h"
 
-UCustomJSArg::UCustomJSArg() : bIsUsingBridgeCaller(false)
+UCustomJSArg::UCustomJSArg() : bIsUsingBridgeCaller(false), bHydrate(false)
 {
 	
 }
\ No newline at end of file
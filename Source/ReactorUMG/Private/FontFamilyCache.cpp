@@ -0,0 +1,212 @@
+#include "FontFamilyCache.h"
+
+#include "LogReactorUMG.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Font.h"
+#include "Engine/StreamableManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+static const TCHAR* FontFamilyDir = TEXT("/ReactorUMG/FontFamily");
+
+static const TCHAR* DefaultEngineFont = TEXT("/Engine/EngineFonts/Roboto.Roboto");
+
+FFontFamilyCache& FFontFamilyCache::Get()
+{
+	static FFontFamilyCache Instance;
+	return Instance;
+}
+
+void FFontFamilyCache::Startup()
+{
+	// 模块在引擎初始化之前加载，这时还不能用 StreamableManager
+	PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda([this]()
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		if (AssetRegistry.IsLoadingAssets())
+		{
+			FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FFontFamilyCache::ScanAssetRegistry);
+		}
+		else
+		{
+			ScanAssetRegistry();
+		}
+
+#if WITH_EDITOR
+		AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FFontFamilyCache::OnAssetChanged);
+		AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FFontFamilyCache::OnAssetChanged);
+		AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FFontFamilyCache::OnAssetRenamed);
+#endif
+	});
+}
+
+void FFontFamilyCache::Shutdown()
+{
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+#if WITH_EDITOR
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+#endif
+	}
+
+	if (PreloadHandle.IsValid())
+	{
+		PreloadHandle->CancelHandle();
+		PreloadHandle.Reset();
+	}
+	Invalidate();
+	FallbackFont = nullptr;
+	bFallbackResolved = false;
+}
+
+void FFontFamilyCache::ScanAssetRegistry()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+	FilesLoadedHandle.Reset();
+
+	FARFilter Filter;
+	Filter.PackagePaths.Add(FName(FontFamilyDir));
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION > 0
+	Filter.ClassPaths.Add(UFont::StaticClass()->GetClassPathName());
+#else
+	Filter.ClassNames.Add(UFont::StaticClass()->GetFName());
+#endif
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	TArray<FSoftObjectPath> FontsToLoad;
+	for (const FAssetData& Asset : Assets)
+	{
+		const FString Name = Asset.AssetName.ToString();
+		if (!FontsByName.Contains(Name))
+		{
+			FontsToLoad.Add(Asset.GetSoftObjectPath());
+		}
+	}
+	UE_LOG(LogReactorUMG, Log, TEXT("Found %d font families under %s"), Assets.Num(), FontFamilyDir);
+
+	if (FontsToLoad.Num() == 0 || !UAssetManager::IsInitialized())
+	{
+		return;
+	}
+
+	PreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(FontsToLoad, FStreamableDelegate::CreateLambda([this, FontsToLoad]()
+	{
+		for (const FSoftObjectPath& Path : FontsToLoad)
+		{
+			if (UFont* Font = Cast<UFont>(Path.ResolveObject()))
+			{
+				FontsByName.FindOrAdd(Font->GetName()) = Font;
+			}
+		}
+		PreloadHandle.Reset();
+	}));
+}
+
+UFont* FFontFamilyCache::FindByName(const FString& Name)
+{
+	if (const TObjectPtr<UFont>* Found = FontsByName.Find(Name))
+	{
+		return *Found;
+	}
+
+	// the registry of a cooked build may not list the font dir, only a failed load proves a font is missing
+	if (MissingNames.Contains(Name))
+	{
+		return nullptr;
+	}
+
+	const FString FontAssetPath = FString(FontFamilyDir) / Name + TEXT(".") + Name;
+	UFont* Font = Cast<UFont>(StaticLoadObject(UFont::StaticClass(), nullptr, *FontAssetPath));
+	if (Font)
+	{
+		FontsByName.Add(Name, Font);
+	}
+	else
+	{
+		MissingNames.Add(Name);
+	}
+	return Font;
+}
+
+UFont* FFontFamilyCache::Resolve(const TArray<FString>& Names)
+{
+	check(IsInGameThread());
+
+	const FString Key = FString::Join(Names, TEXT("|"));
+	if (const TObjectPtr<UFont>* Found = ResolvedLists.Find(Key))
+	{
+		return *Found;
+	}
+
+	UFont* Result = nullptr;
+	for (const FString& Name : Names)
+	{
+		Result = FindByName(Name);
+		if (Result)
+		{
+			break;
+		}
+	}
+
+	if (Result == nullptr)
+	{
+		if (!bFallbackResolved)
+		{
+			FallbackFont = Cast<UFont>(StaticLoadObject(UFont::StaticClass(), nullptr, DefaultEngineFont));
+			bFallbackResolved = true;
+		}
+		Result = FallbackFont;
+	}
+
+	ResolvedLists.Add(Key, Result);
+	return Result;
+}
+
+void FFontFamilyCache::Invalidate()
+{
+	ResolvedLists.Empty();
+	FontsByName.Empty();
+	MissingNames.Empty();
+}
+
+#if WITH_EDITOR
+void FFontFamilyCache::OnAssetChanged(const FAssetData& AssetData)
+{
+	if (AssetData.PackagePath == FName(FontFamilyDir))
+	{
+		Invalidate();
+		ScanAssetRegistry();
+	}
+}
+
+void FFontFamilyCache::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	if (AssetData.PackagePath == FName(FontFamilyDir) || OldObjectPath.StartsWith(FString(FontFamilyDir) + TEXT("/")))
+	{
+		Invalidate();
+		ScanAssetRegistry();
+	}
+}
+#endif
+
+void FFontFamilyCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (auto& Pair : ResolvedLists)
+	{
+		Collector.AddReferencedObject(Pair.Value);
+	}
+	for (auto& Pair : FontsByName)
+	{
+		Collector.AddReferencedObject(Pair.Value);
+	}
+	Collector.AddReferencedObject(FallbackFont);
+}
@@ -0,0 +1,77 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 THL A29 Limited, a Tencent company.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+
+class UFont;
+struct FAssetData;
+struct FStreamableHandle;
+
+/**
+ * 字体族查找缓存：reconciler 为每个设置了 fontFamily 的文本节点调用 FindFontFamily，
+ * 按名字列表缓存解析结果（包括找不到的结果），避免反复走 StaticLoadObject。
+ * 引擎初始化后扫描一次资产注册表，记下 /ReactorUMG/FontFamily 下的字体并异步加载，
+ * 之后不在表里的名字直接判定为不存在。
+ */
+class FFontFamilyCache : public FGCObject
+{
+public:
+	static FFontFamilyCache& Get();
+
+	// 返回第一个可用的字体，都不可用时返回引擎默认字体
+	UFont* Resolve(const TArray<FString>& Names);
+
+	void Startup();
+
+	void Shutdown();
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+	virtual FString GetReferencerName() const override { return TEXT("FFontFamilyCache"); }
+
+private:
+	UFont* FindByName(const FString& Name);
+
+	void ScanAssetRegistry();
+
+	void Invalidate();
+
+#if WITH_EDITOR
+	void OnAssetChanged(const FAssetData& AssetData);
+
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+#endif
+
+	// 名字列表（以 | 连接）到解析结果，值为空表示整个列表连默认字体都没找到
+	TMap<FString, TObjectPtr<UFont>> ResolvedLists;
+
+	TMap<FString, TObjectPtr<UFont>> FontsByName;
+
+	TSet<FString> MissingNames;
+
+	TObjectPtr<UFont> FallbackFont;
+
+	bool bFallbackResolved = false;
+
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	FDelegateHandle PostEngineInitHandle;
+
+	FDelegateHandle FilesLoadedHandle;
+
+#if WITH_EDITOR
+	FDelegateHandle AssetAddedHandle;
+
+	FDelegateHandle AssetRemovedHandle;
+
+	FDelegateHandle AssetRenamedHandle;
+#endif
+};
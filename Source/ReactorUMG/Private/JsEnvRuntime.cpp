@@ -4,8 +4,58 @@
 #include "LogReactorUMG.h"
 #include "ReactorUtils.h"
 #include "PuertsSetting.h"
+#include "ReactorUMGSetting.h"
+#include "WidgetHandleTable.h"
 #include "Misc/Paths.h"
 #include "HAL/PlatformFileManager.h"
+#include "HAL/IConsoleManager.h"
+
+static int32 MaxJsEnvs = 4;
+static FAutoConsoleVariableRef CVarMaxJsEnvs(TEXT("ReactorUMG.MaxJsEnvs"), MaxJsEnvs,
+	TEXT("Max number of javascript envs ui roots are spread over, roots share the least loaded env once it is reached"), ECVF_Default);
+
+static FAutoConsoleCommand DumpJsEnvLoadCommand(TEXT("ReactorUMG.DumpJsEnvLoad"),
+	TEXT("Log load and pinned ui roots of every javascript env"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) { FJsEnvRuntime::GetInstance().DumpJsEnvLoad(Ar); }));
+
+static FAutoConsoleCommand ProfileJSCommand(TEXT("ReactorUMG.ProfileJS"),
+	TEXT("ReactorUMG.ProfileJS start [SamplingIntervalUs=1000] [frames] | stop. Sample javascript with the v8 cpu profiler, ")
+	TEXT("stop writes .cpuprofile and .folded files to Saved/Profiling/ReactorUMG, frames also reports per frame hot functions to stats/csv/insights"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+		{
+			if (Args.Num() > 0 && Args[0] == TEXT("start"))
+			{
+				int32 IntervalUs = 1000;
+				bool bFrameStats = false;
+				for (int32 i = 1; i < Args.Num(); i++)
+				{
+					if (Args[i] == TEXT("frames"))
+					{
+						bFrameStats = true;
+					}
+					else if (Args[i].IsNumeric())
+					{
+						IntervalUs = FCString::Atoi(*Args[i]);
+					}
+				}
+				FJsEnvRuntime::GetInstance().StartJsProfiling(IntervalUs, bFrameStats, Ar);
+			}
+			else if (Args.Num() > 0 && Args[0] == TEXT("stop"))
+			{
+				FJsEnvRuntime::GetInstance().StopJsProfiling(Ar);
+			}
+			else
+			{
+				Ar.Log(TEXT("Usage: ReactorUMG.ProfileJS start [SamplingIntervalUs] [frames] | stop"));
+			}
+		}));
+
+// cost weights, in units of one live wrapper
+static constexpr double HeapMBCost = 20.0;
+static constexpr double ScriptMsPerSecondCost = 50.0;
+static constexpr double PinnedRootCost = 200.0;
 
 void FReactorUMGJSLogger::Log(const FString& Message) const
 {
@@ -37,37 +87,192 @@ void FReactorUMGJSLogger::Info(const FString& Message) const
 
 FJsEnvRuntime::FJsEnvRuntime(int32 EnvPoolSize)
 {
-	int32 DebugPort = GetDefault<UPuertsSetting>()->DebugPort;
 	ReactorUmgLogger = std::make_shared<FReactorUMGJSLogger>();
 	this->EnvPoolSize = EnvPoolSize;
 	for (int32 i = 0; i < EnvPoolSize; i++)
 	{
-		TSharedPtr<puerts::FJsEnv> JsEnv = MakeShared<puerts::FJsEnv>(
-		std::make_unique<puerts::DefaultJSModuleLoader>(TEXT("JavaScript")),
-		ReactorUmgLogger, DebugPort + i + 3);
-		JsRuntimeEnvPool.Add(JsEnv, 0);
+		AddJsEnvSlot();
 	}
 }
 
 FJsEnvRuntime::~FJsEnvRuntime()
 {
-	JsRuntimeEnvPool.Empty();
+	RootAffinity.Empty();
+	EnvSlots.Empty();
+}
+
+int32 FJsEnvRuntime::AddJsEnvSlot()
+{
+	const int32 Index = EnvSlots.AddDefaulted();
+	FJsEnvSlot& Slot = EnvSlots[Index];
+	Slot.DebugPort = GetDefault<UPuertsSetting>()->DebugPort + Index + 3;
+
+	const UReactorUMGSetting* Settings = GetDefault<UReactorUMGSetting>();
+	FString Flags;
+	if (Settings->JsHeapHardLimitMB > 0)
+	{
+		Flags = FString::Printf(TEXT("--max-old-space-size=%d"), Settings->JsHeapHardLimitMB);
+	}
+	Slot.Env = MakeShared<puerts::FJsEnv>(
+		std::make_unique<puerts::DefaultJSModuleLoader>(TEXT("JavaScript")),
+		ReactorUmgLogger, Slot.DebugPort, nullptr, Flags);
+
+	puerts::FJsEnvHeapLimits HeapLimits;
+	HeapLimits.SoftLimitBytes = static_cast<uint64>(FMath::Max(Settings->JsHeapSoftLimitMB, 0)) * 1024 * 1024;
+	HeapLimits.HardLimitBytes = static_cast<uint64>(FMath::Max(Settings->JsHeapHardLimitMB, 0)) * 1024 * 1024;
+	Slot.Env->SetHeapLimits(HeapLimits);
+	if (bJsProfiling)
+	{
+		Slot.Env->StartCpuProfiling(JsProfilingIntervalUs, bJsProfilingFrameStats);
+	}
+	return Index;
 }
 
 TSharedPtr<puerts::FJsEnv> FJsEnvRuntime::GetFreeJsEnv()
 {
-	TSharedPtr<puerts::FJsEnv> JsEnv = nullptr;
-	for (auto& Pair : JsRuntimeEnvPool)
+	for (FJsEnvSlot& Slot : EnvSlots)
 	{
-		if (Pair.Value == 0)
+		if (!Slot.bBusy && Slot.RootUsers == 0)
 		{
-			JsEnv = Pair.Key;
-			Pair.Value = 1;
-			break;
+			Slot.bBusy = true;
+			return Slot.Env;
+		}
+	}
+
+	return nullptr;
+}
+
+TSharedPtr<puerts::FJsEnv> FJsEnvRuntime::AcquireJsEnvForRoot(const FString& RootKey)
+{
+	FRootPin* Pin = RootAffinity.Find(RootKey);
+	if (!Pin)
+	{
+		const int32 SlotIndex = SelectSlotForNewRoot();
+		if (SlotIndex == INDEX_NONE)
+		{
+			return nullptr;
+		}
+		Pin = &RootAffinity.Add(RootKey, FRootPin{SlotIndex, 0});
+		EnvSlots[SlotIndex].PinnedRoots++;
+		UE_LOG(LogReactorUMG, Log, TEXT("Pin ui root %s to javascript env %d"), *RootKey, SlotIndex);
+	}
+
+	// every widget of a pinned root, and every root pinned to the slot, shares its env
+	FJsEnvSlot& Slot = EnvSlots[Pin->SlotIndex];
+	Pin->Users++;
+	Slot.RootUsers++;
+	return Slot.Env;
+}
+
+int32 FJsEnvRuntime::SelectSlotForNewRoot()
+{
+	// an env without roots is as cheap as it gets, and keeps the new root isolated from the others
+	for (int32 i = 0; i < EnvSlots.Num(); i++)
+	{
+		if (EnvSlots[i].PinnedRoots == 0 && !EnvSlots[i].bBusy)
+		{
+			return i;
+		}
+	}
+
+	if (EnvSlots.Num() < FMath::Max(MaxJsEnvs, EnvPoolSize))
+	{
+		return AddJsEnvSlot();
+	}
+
+	int32 BestIndex = INDEX_NONE;
+	double BestCost = 0;
+	for (int32 i = 0; i < EnvSlots.Num(); i++)
+	{
+		puerts::FJsEnvLoadStats Stats;
+		const double Cost = SampleEnvCost(EnvSlots[i], Stats);
+		if (BestIndex == INDEX_NONE || Cost < BestCost)
+		{
+			BestIndex = i;
+			BestCost = Cost;
+		}
+	}
+	return BestIndex;
+}
+
+double FJsEnvRuntime::SampleEnvCost(FJsEnvSlot& Slot, puerts::FJsEnvLoadStats& OutStats)
+{
+	Slot.Env->GetLoadStats(OutStats);
+
+	const double Now = FPlatformTime::Seconds();
+	if (Slot.LastSampleTime > 0 && Now > Slot.LastSampleTime)
+	{
+		const double Load = (OutStats.ScriptSeconds - Slot.LastScriptSeconds) / (Now - Slot.LastSampleTime);
+		Slot.ScriptLoad = FMath::Lerp(Slot.ScriptLoad, Load, 0.5);
+	}
+	Slot.LastScriptSeconds = OutStats.ScriptSeconds;
+	Slot.LastSampleTime = Now;
+
+	return OutStats.LiveObjectWrappers + OutStats.LiveStructWrappers
+		+ OutStats.UsedHeapSize / (1024.0 * 1024.0) * HeapMBCost
+		+ Slot.ScriptLoad * 1000.0 * ScriptMsPerSecondCost
+		+ Slot.PinnedRoots * PinnedRootCost;
+}
+
+void FJsEnvRuntime::DumpJsEnvLoad(FOutputDevice& Ar)
+{
+	for (int32 i = 0; i < EnvSlots.Num(); i++)
+	{
+		FJsEnvSlot& Slot = EnvSlots[i];
+		puerts::FJsEnvLoadStats Stats;
+		const double Cost = SampleEnvCost(Slot, Stats);
+		Ar.Logf(TEXT("env %d (debug port %d)%s: cost %.1f, objects %d, structs %d, heap %.2f/%.2f MB, script %.3f s total, %.2f ms/s recent"),
+			i, Slot.DebugPort, Slot.bBusy ? TEXT(" busy") : TEXT(""), Cost, Stats.LiveObjectWrappers, Stats.LiveStructWrappers,
+			Stats.UsedHeapSize / (1024.0 * 1024.0), Stats.TotalHeapSize / (1024.0 * 1024.0), Stats.ScriptSeconds, Slot.ScriptLoad * 1000.0);
+		for (const auto& Pair : RootAffinity)
+		{
+			if (Pair.Value.SlotIndex == i)
+			{
+				Ar.Logf(TEXT("    %s (%d users)"), *Pair.Key, Pair.Value.Users);
+			}
 		}
 	}
+}
 
-	return JsEnv;
+void FJsEnvRuntime::StartJsProfiling(int32 SamplingIntervalUs, bool bFrameStats, FOutputDevice& Ar)
+{
+	if (bJsProfiling)
+	{
+		Ar.Log(TEXT("javascript profiling is already running"));
+		return;
+	}
+
+	bJsProfiling = true;
+	JsProfilingIntervalUs = SamplingIntervalUs;
+	bJsProfilingFrameStats = bFrameStats;
+	int32 Started = 0;
+	for (FJsEnvSlot& Slot : EnvSlots)
+	{
+		Started += Slot.Env->StartCpuProfiling(SamplingIntervalUs, bFrameStats) ? 1 : 0;
+	}
+	Ar.Logf(TEXT("javascript profiling started on %d env(s), sampling every %d us%s"), Started, SamplingIntervalUs,
+		bFrameStats ? TEXT(", with per frame stats") : TEXT(""));
+}
+
+void FJsEnvRuntime::StopJsProfiling(FOutputDevice& Ar)
+{
+	if (!bJsProfiling)
+	{
+		Ar.Log(TEXT("javascript profiling is not running"));
+		return;
+	}
+
+	bJsProfiling = false;
+	const FString BaseDir = FPaths::Combine(FPaths::ProfilingDir(), TEXT("ReactorUMG"));
+	const FString Timestamp = FDateTime::Now().ToString();
+	for (int32 i = 0; i < EnvSlots.Num(); i++)
+	{
+		const FString BasePath = FPaths::Combine(BaseDir, FString::Printf(TEXT("js-env%d-%s"), i, *Timestamp));
+		if (EnvSlots[i].Env->StopCpuProfiling(BasePath))
+		{
+			Ar.Logf(TEXT("env %d: %s.cpuprofile"), i, *FPaths::ConvertRelativePathToFull(BasePath));
+		}
+	}
 }
 
 bool FJsEnvRuntime::StartJavaScript(const TSharedPtr<puerts::FJsEnv>& JsEnv, const FString& Script, const TArray<TPair<FString, UObject*>>& Arguments) const
@@ -97,36 +302,74 @@ bool FJsEnvRuntime::CheckScriptLegal(const FString& Script) const
 
 void FJsEnvRuntime::ReleaseJsEnv(TSharedPtr<puerts::FJsEnv> JsEnv)
 {
-	for (auto& Pair : JsRuntimeEnvPool)
+	for (FJsEnvSlot& Slot : EnvSlots)
 	{
-		auto Key = Pair.Key;
-		if (Key.Get() == JsEnv.Get())
+		if (Slot.Env.Get() == JsEnv.Get())
 		{
 			JsEnv->Release();
-			Pair.Value = 0;
+			Slot.bBusy = false;
 			break;
 		}
 	}
 }
 
+void FJsEnvRuntime::ReleaseJsEnvForRoot(const FString& RootKey, TSharedPtr<puerts::FJsEnv> JsEnv)
+{
+	FRootPin* Pin = RootAffinity.Find(RootKey);
+	if (!Pin || !EnvSlots.IsValidIndex(Pin->SlotIndex) || EnvSlots[Pin->SlotIndex].Env.Get() != JsEnv.Get())
+	{
+		// the pool was rebuilt meanwhile
+		return;
+	}
+
+	FJsEnvSlot& Slot = EnvSlots[Pin->SlotIndex];
+	Slot.RootUsers = FMath::Max(Slot.RootUsers - 1, 0);
+	if (--Pin->Users <= 0)
+	{
+		Slot.PinnedRoots = FMath::Max(Slot.PinnedRoots - 1, 0);
+		UE_LOG(LogReactorUMG, Log, TEXT("Unpin ui root %s from javascript env %d"), *RootKey, Pin->SlotIndex);
+		RootAffinity.Remove(RootKey);
+	}
+
+	// the other roots of the slot still run in the env
+	if (Slot.RootUsers == 0)
+	{
+		JsEnv->Release();
+	}
+}
+
+bool FJsEnvRuntime::StartJavaScriptForRoot(const TSharedPtr<puerts::FJsEnv>& JsEnv, const FString& Script,
+	const TArray<TPair<FString, UObject*>>& Arguments) const
+{
+	if (!JsEnv)
+	{
+		return false;
+	}
+
+	// several roots start their launch scripts in a shared env, clear the started guard left by the previous one
+	JsEnv->Release();
+	JsEnv->Start(Script, Arguments);
+	return true;
+}
+
 void FJsEnvRuntime::RebuildRuntimePool()
 {
-	for (auto& Pair : JsRuntimeEnvPool)
+	// the profiles of the old envs would be lost, new envs start profiling again
+	if (bJsProfiling)
 	{
-		auto Key = Pair.Key;
-		Key.Reset();
+		StopJsProfiling(*GLog);
+		bJsProfiling = true;
 	}
 
-	JsRuntimeEnvPool.Empty();
+	RootAffinity.Empty();
+	EnvSlots.Empty();
+	// the scripts that created the handles are gone with their envs
+	FWidgetHandleTable::Get().ReleaseAll();
 
-	int32 DebugPort = GetDefault<UPuertsSetting>()->DebugPort;
 	ReactorUmgLogger = std::make_shared<FReactorUMGJSLogger>();
 	for (int32 i = 0; i < EnvPoolSize; i++)
 	{
-		TSharedPtr<puerts::FJsEnv> JsEnv = MakeShared<puerts::FJsEnv>(
-		std::make_unique<puerts::DefaultJSModuleLoader>(TEXT("JavaScript")),
-		ReactorUmgLogger, DebugPort + i + 3);
-		JsRuntimeEnvPool.Add(JsEnv, 0);
+		AddJsEnvSlot();
 	}
 }
 
@@ -172,18 +415,24 @@ void FJsEnvRuntime::RestartJsScripts(
 		FString FileContent;
 		if (FReactorUtils::ReadFileContent(ModulePair.Value, FileContent))
 		{
-			for (auto& Pair : JsRuntimeEnvPool)
+			for (FJsEnvSlot& Slot : EnvSlots)
 			{
-				auto Env = Pair.Key;
+				auto Env = Slot.Env;
 				Env->ReloadModule(FName(*ModulePair.Key), FileContent);
 				Env->ForceReloadJsFile(ModulePair.Value);
 			}
 		}
 	}
 	
-	for (auto& Pair : JsRuntimeEnvPool)
+	// a pinned root only lives in its own env, roots started without affinity run everywhere as before
+	const FRootPin* Pinned = RootAffinity.Find(MainJsScript);
+	for (int32 i = 0; i < EnvSlots.Num(); i++)
 	{
-		auto Env = Pair.Key;
+		if (Pinned && Pinned->SlotIndex != i)
+		{
+			continue;
+		}
+		auto Env = EnvSlots[i].Env;
 		Env->Release();
 		Env->ForceReloadJsFile(MainJsScript);
 		Env->Start(MainJsScript, Arguments);
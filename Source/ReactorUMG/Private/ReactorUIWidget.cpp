@@ -5,10 +5,48 @@
 #include "ReactorUMGBlueprintGeneratedClass.h"
 #include "ReactorUtils.h"
 #include "Blueprint/WidgetTree.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Widgets/Layout/SBox.h"
+
+static float IdleScriptStartMaxFrameMs = 20.0f;
+static FAutoConsoleVariableRef CVarIdleScriptStartMaxFrameMs(TEXT("ReactorUMG.IdleScriptStartMaxFrameMs"), IdleScriptStartMaxFrameMs,
+	TEXT("Deferred widget scripts in Idle start mode are started one per frame, only in frames shorter than this"), ECVF_Default);
+
+static TArray<TWeakObjectPtr<UReactorUIWidget>> IdleScriptStartQueue;
+static FTSTicker::FDelegateHandle IdleScriptStartTicker;
+
+static bool TickIdleScriptStarts(float DeltaTime)
+{
+	if (FApp::GetDeltaTime() * 1000.0 > IdleScriptStartMaxFrameMs)
+	{
+		return true;
+	}
+
+	while (IdleScriptStartQueue.Num() > 0)
+	{
+		UReactorUIWidget* Widget = IdleScriptStartQueue[0].Get();
+		IdleScriptStartQueue.RemoveAt(0);
+		if (IsValid(Widget) && Widget->IsScriptStartPending())
+		{
+			Widget->Prewarm();
+			break;
+		}
+	}
+
+	if (IdleScriptStartQueue.Num() == 0)
+	{
+		IdleScriptStartTicker.Reset();
+		return false;
+	}
+	return true;
+}
 
 UReactorUIWidget::UReactorUIWidget(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer), CustomJSArg(nullptr), LaunchScriptPath(TEXT("")),
-		JsEnv(nullptr), bWidgetTreeInitialized(false)
+		JsEnv(nullptr), bWidgetTreeInitialized(false), bHydrating(false),
+		bScriptStartPending(false)
 {
 }
 
@@ -29,6 +67,8 @@ bool UReactorUIWidget::Initialize()
 
 void UReactorUIWidget::BeginDestroy()
 {
+	// the root stays pinned to its env as long as one of its widgets is alive
+	ReleaseJsEnv();
 	Super::BeginDestroy();
 }
 
@@ -36,7 +76,10 @@ void UReactorUIWidget::SetNewWidgetTree()
 {
 	if (!bWidgetTreeInitialized && !HasAnyFlags(RF_ClassDefaultObject))
 	{
-		if (WidgetTree != nullptr)
+		UReactorUMGBlueprintGeneratedClass* ReactorBPGC = Cast<UReactorUMGBlueprintGeneratedClass>(GetClass());
+		// the tree instantiated from a prerendered archetype is kept and hydrated by the script
+		bHydrating = ReactorBPGC && WidgetTree && WidgetTree->RootWidget && ReactorBPGC->CanHydrateWidgetTree();
+		if (WidgetTree != nullptr && !bHydrating)
 		{
 			UWidgetTree* OldWidgetTree = WidgetTree;
 			WidgetTree = NewObject<UWidgetTree>(this, NAME_None, RF_Transient);
@@ -44,7 +87,6 @@ void UReactorUIWidget::SetNewWidgetTree()
 			OldWidgetTree = nullptr;
 		}
 		
-		UReactorUMGBlueprintGeneratedClass* ReactorBPGC = Cast<UReactorUMGBlueprintGeneratedClass>(GetClass());
 		if (ReactorBPGC)
 		{
 			TsProjectDir = ReactorBPGC->TsProjectDir;
@@ -52,7 +94,22 @@ void UReactorUIWidget::SetNewWidgetTree()
 			LaunchScriptPath = ReactorBPGC->MainScriptPath;
 			if (!LaunchScriptPath.IsEmpty())
 			{
-				RunScriptToInitWidgetTree();
+				if (ReactorBPGC->ScriptStartMode == EReactorScriptStartMode::Immediate)
+				{
+					RunScriptToInitWidgetTree();
+				}
+				else
+				{
+					bScriptStartPending = true;
+					if (ReactorBPGC->ScriptStartMode == EReactorScriptStartMode::Idle)
+					{
+						IdleScriptStartQueue.Add(this);
+						if (!IdleScriptStartTicker.IsValid())
+						{
+							IdleScriptStartTicker = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickIdleScriptStarts));
+						}
+					}
+				}
 			}
 		}
 
@@ -63,6 +120,67 @@ void UReactorUIWidget::SetNewWidgetTree()
 }
 
 
+void UReactorUIWidget::Prewarm()
+{
+	if (!bScriptStartPending)
+	{
+		return;
+	}
+
+	bScriptStartPending = false;
+	RunScriptToInitWidgetTree();
+	if (DeferredContent.IsValid() && WidgetTree && WidgetTree->RootWidget)
+	{
+		DeferredContent->SetContent(WidgetTree->RootWidget->TakeWidget());
+	}
+}
+
+bool UReactorUIWidget::IsShownOnScreen() const
+{
+	const ESlateVisibility CurrentVisibility = GetVisibility();
+	return CurrentVisibility != ESlateVisibility::Collapsed && CurrentVisibility != ESlateVisibility::Hidden;
+}
+
+TSharedRef<SWidget> UReactorUIWidget::RebuildWidget()
+{
+	if (bScriptStartPending && IsShownOnScreen())
+	{
+		Prewarm();
+	}
+
+	// a hidden widget without a prerendered tree gets an empty box until its script runs
+	if (bScriptStartPending && !(WidgetTree && WidgetTree->RootWidget))
+	{
+		return SAssignNew(DeferredContent, SBox);
+	}
+	return Super::RebuildWidget();
+}
+
+void UReactorUIWidget::SetVisibility(ESlateVisibility InVisibility)
+{
+	Super::SetVisibility(InVisibility);
+	if (bScriptStartPending && IsShownOnScreen() && GetCachedWidget().IsValid())
+	{
+		Prewarm();
+	}
+}
+
+void UReactorUIWidget::ReleaseSlateResources(bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+	DeferredContent.Reset();
+}
+
+void UReactorUIWidget::ShutdownIdleScriptStarts()
+{
+	if (IdleScriptStartTicker.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(IdleScriptStartTicker);
+		IdleScriptStartTicker.Reset();
+	}
+	IdleScriptStartQueue.Empty();
+}
+
 #if WITH_EDITOR
 const FText UReactorUIWidget::GetPaletteCategory()
 {
@@ -72,6 +190,11 @@ const FText UReactorUIWidget::GetPaletteCategory()
 
 void UReactorUIWidget::RunScriptToInitWidgetTree()
 {
+	if (!LaunchScriptPath.IsEmpty() && !JsEnv)
+	{
+		JsEnv = FJsEnvRuntime::GetInstance().AcquireJsEnvForRoot(LaunchScriptPath);
+	}
+
 	if (!LaunchScriptPath.IsEmpty() && (!UJsBridgeCaller::IsExistBridgeCaller(LaunchScriptPath) || FReactorUtils::IsAnyPIERunning()))
 	{
 		TArray<TPair<FString, UObject*>> Arguments;
@@ -84,14 +207,14 @@ void UReactorUIWidget::RunScriptToInitWidgetTree()
 			CustomJSArg = NewObject<UCustomJSArg>(this, FName("ReactorUIWidget_CustomArgs"), RF_Transient);
 		}
 		CustomJSArg->bIsUsingBridgeCaller = true;
+		CustomJSArg->bHydrate = bHydrating;
 		Arguments.Add(TPair<FString, UObject*>(TEXT("CustomArgs"), CustomJSArg));
 		
-		JsEnv = FJsEnvRuntime::GetInstance().GetFreeJsEnv();
 		if (JsEnv)
 		{
 			if (!FReactorUtils::IsAnyPIERunning())
 			{
-				const bool Result = FJsEnvRuntime::GetInstance().StartJavaScript(JsEnv, LaunchScriptPath, Arguments);
+				const bool Result = FJsEnvRuntime::GetInstance().StartJavaScriptForRoot(JsEnv, LaunchScriptPath, Arguments);
 				if (!Result)
 				{
 					UJsBridgeCaller::RemoveBridgeCaller(LaunchScriptPath);
@@ -110,7 +233,6 @@ void UReactorUIWidget::RunScriptToInitWidgetTree()
 			UE_LOG(LogReactorUMG, Error, TEXT("Can not obtain any valid javascript runtime environment"))
 			return;
 		}
-		ReleaseJsEnv();
 	}
 	
 	const bool DelegateRunResult = UJsBridgeCaller::ExecuteMainCaller(LaunchScriptPath, this->WidgetTree);
@@ -126,8 +248,8 @@ void UReactorUIWidget::ReleaseJsEnv()
 {
 	if (JsEnv)
 	{
-		UE_LOG(LogReactorUMG, Display, TEXT("Release javascript env in order to excuting other script"))
-		FJsEnvRuntime::GetInstance().ReleaseJsEnv(JsEnv);
+		UE_LOG(LogReactorUMG, Verbose, TEXT("Release javascript env of ui root %s"), *LaunchScriptPath)
+		FJsEnvRuntime::GetInstance().ReleaseJsEnvForRoot(LaunchScriptPath, JsEnv);
 		JsEnv = nullptr;
 	}
 }
\ No newline at end of file
@@ -1,17 +1,40 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ReactorUMG.h"
+#include "FontFamilyCache.h"
+#include "JsEnv.h"
+#include "ReactorUtils.h"
+#include "ScriptArchive.h"
+#include "ReactorUIWidget.h"
+#include "WidgetHandleTable.h"
+#include "WidgetPool.h"
 
 #define LOCTEXT_NAMESPACE "FReactorUMGModule"
 
 void FReactorUMGModule::StartupModule()
 {
 	// todo@Caleb196x: 生成types文件
+	FFontFamilyCache::Get().Startup();
+	FWidgetPool::Get().Startup();
+	FWidgetHandleTable::Get().Startup();
+	// every js env (puerts editor, pie, reactor roots) and the cook time packer read Content/JavaScript,
+	// which may still be written by a background sync
+	WaitForScriptFilesHandle = puerts::FJsEnv::OnWaitForScriptFiles().AddStatic(&FReactorUtils::WaitForPendingSyncs);
+#if WITH_EDITOR
+	PrePackHandle = puerts::FScriptArchive::OnPrePack().AddStatic(&FReactorUtils::RefreshLaunchScriptHashManifest);
+#endif
 }
 
 void FReactorUMGModule::ShutdownModule()
 {
-	
+	puerts::FJsEnv::OnWaitForScriptFiles().Remove(WaitForScriptFilesHandle);
+#if WITH_EDITOR
+	puerts::FScriptArchive::OnPrePack().Remove(PrePackHandle);
+#endif
+	FWidgetHandleTable::Get().Shutdown();
+	FWidgetPool::Get().Shutdown();
+	FFontFamilyCache::Get().Shutdown();
+	UReactorUIWidget::ShutdownIdleScriptStarts();
 }
 
 #undef LOCTEXT_NAMESPACE
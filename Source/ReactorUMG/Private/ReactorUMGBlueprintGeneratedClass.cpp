@@ -1,10 +1,31 @@
 #include "ReactorUMGBlueprintGeneratedClass.h"
 #include "UObject/UnrealType.h"
+#include "ReactorUtils.h"
 UReactorUMGBlueprintGeneratedClass::UReactorUMGBlueprintGeneratedClass(const FObjectInitializer& ObjectInitializer)
 {
 	
 }
 
+bool UReactorUMGBlueprintGeneratedClass::CanHydrateWidgetTree() const
+{
+	if (PrerenderedScriptHash.IsEmpty() || MainScriptPath.IsEmpty())
+	{
+		return false;
+	}
+
+#if WITH_EDITOR
+	// scripts are recompiled without touching the blueprint while editing, always check
+	return FReactorUtils::GetLaunchScriptHash(MainScriptPath) == PrerenderedScriptHash;
+#else
+	if (!bPrerenderedTreeUpToDate.IsSet())
+	{
+		// hashed when the scripts were packed, walking the module closure here would stall the game thread
+		bPrerenderedTreeUpToDate = FReactorUtils::GetPackedLaunchScriptHash(MainScriptPath) == PrerenderedScriptHash;
+	}
+	return bPrerenderedTreeUpToDate.GetValue();
+#endif
+}
+
 void UReactorUMGBlueprintGeneratedClass::PostLoad()
 {
 	Super::PostLoad();
@@ -1,6 +1,6 @@
 ﻿#include "ReactorUMGSetting.h"
 
 UReactorUMGSetting::UReactorUMGSetting()
-: TsScriptProjectDir(TEXT("TypeScript")), bAutoGenerateTSProject(true)
+: TsScriptProjectDir(TEXT("TypeScript")), bAutoGenerateTSProject(true), bGenerateCustomWidgetDeclaration(false), bPrerenderWidgetTree(false), JsHeapSoftLimitMB(64), JsHeapHardLimitMB(0)
 {
 }
\ No newline at end of file
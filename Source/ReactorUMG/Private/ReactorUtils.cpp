@@ -13,6 +13,14 @@
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/Paths.h"
 #include "PuertsSetting.h"
+#include "JSModuleLoader.h"
+#include "ScriptArchive.h"
+#include "HAL/FileManager.h"
+#include "Internationalization/Regex.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/JsonWriter.h"
 
 bool FReactorUtils::CopyDirectoryRecursive(const FString& SrcDir, const FString& DestDir, const TArray<FString>& SkipExistFiles)
 {
@@ -75,6 +83,270 @@ void FReactorUtils::CopyFile(const FString& SrcFile, const FString& DestFile)
 	}
 }
 
+namespace
+{
+	constexpr int32 SyncManifestVersion = 1;
+
+	struct FSyncEntry
+	{
+		int64 SrcSize = -1;
+		int64 SrcTime = 0;
+		int64 DestSize = -1;
+		int64 DestTime = 0;
+		FString Hash;
+		// the destination was not written by us, leave it alone as long as it exists
+		bool bKept = false;
+	};
+
+	FCriticalSection SyncLock;
+
+	FCriticalSection PendingSyncsLock;
+
+	TArray<TFuture<bool>> PendingSyncs;
+
+	FString GetSyncManifestPath(const FString& DestDir)
+	{
+		FString Key = FPaths::ConvertRelativePathToFull(DestDir);
+		FPaths::NormalizeDirectoryName(Key);
+		return FPaths::Combine(FPaths::ProjectIntermediateDir(), TEXT("ReactorUMG"), TEXT("Sync"),
+			FMD5::HashAnsiString(*Key.ToLower()) + TEXT(".json"));
+	}
+
+	void LoadSyncManifest(const FString& ManifestPath, TMap<FString, FSyncEntry>& OutEntries)
+	{
+		FString FileBuffer;
+		if (!FFileHelper::LoadFileToString(FileBuffer, *ManifestPath))
+		{
+			return;
+		}
+
+		TSharedPtr<FJsonObject> JsonObject;
+		TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(FileBuffer);
+		if (!FJsonSerializer::Deserialize(JsonReader, JsonObject) || !JsonObject.IsValid() ||
+			JsonObject->GetIntegerField(TEXT("version")) != SyncManifestVersion)
+		{
+			return;
+		}
+
+		const TSharedPtr<FJsonObject>* FilesObject;
+		if (!JsonObject->TryGetObjectField(TEXT("files"), FilesObject))
+		{
+			return;
+		}
+		
+		for (const auto& Pair : (*FilesObject)->Values)
+		{
+			const TSharedPtr<FJsonObject> EntryObject = Pair.Value->AsObject();
+			if (!EntryObject.IsValid())
+			{
+				continue;
+			}
+			
+			// ticks do not fit in a double, they are stored as strings
+			FSyncEntry& Entry = OutEntries.Add(Pair.Key);
+			LexFromString(Entry.SrcSize, *EntryObject->GetStringField(TEXT("srcSize")));
+			LexFromString(Entry.SrcTime, *EntryObject->GetStringField(TEXT("srcTime")));
+			LexFromString(Entry.DestSize, *EntryObject->GetStringField(TEXT("destSize")));
+			LexFromString(Entry.DestTime, *EntryObject->GetStringField(TEXT("destTime")));
+			Entry.Hash = EntryObject->GetStringField(TEXT("hash"));
+			Entry.bKept = EntryObject->GetBoolField(TEXT("kept"));
+		}
+	}
+
+	void SaveSyncManifest(const FString& ManifestPath, const TMap<FString, FSyncEntry>& Entries)
+	{
+		TSharedRef<FJsonObject> FilesObject = MakeShared<FJsonObject>();
+		for (const auto& Pair : Entries)
+		{
+			TSharedRef<FJsonObject> EntryObject = MakeShared<FJsonObject>();
+			EntryObject->SetStringField(TEXT("srcSize"), LexToString(Pair.Value.SrcSize));
+			EntryObject->SetStringField(TEXT("srcTime"), LexToString(Pair.Value.SrcTime));
+			EntryObject->SetStringField(TEXT("destSize"), LexToString(Pair.Value.DestSize));
+			EntryObject->SetStringField(TEXT("destTime"), LexToString(Pair.Value.DestTime));
+			EntryObject->SetStringField(TEXT("hash"), Pair.Value.Hash);
+			EntryObject->SetBoolField(TEXT("kept"), Pair.Value.bKept);
+			FilesObject->SetObjectField(Pair.Key, EntryObject);
+		}
+
+		TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+		JsonObject->SetNumberField(TEXT("version"), SyncManifestVersion);
+		JsonObject->SetObjectField(TEXT("files"), FilesObject);
+
+		FString FileBuffer;
+		TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&FileBuffer);
+		if (!FJsonSerializer::Serialize(JsonObject, JsonWriter) || !FFileHelper::SaveStringToFile(FileBuffer, *ManifestPath))
+		{
+			UE_LOG(LogReactorUMG, Warning, TEXT("Failed to save sync manifest: %s"), *ManifestPath);
+		}
+	}
+
+	FString HashFile(const FString& FilePath)
+	{
+		return LexToString(FMD5Hash::HashFile(*FilePath));
+	}
+}
+
+bool FReactorUtils::SyncDirectory(const FString& SrcDir, const FString& DestDir, bool Overrided,
+	TFunction<bool(const FString&)> Filter)
+{
+	// syncs of the same destination must not interleave, the manifest is read and written as a whole
+	FScopeLock Lock(&SyncLock);
+	const double StartTime = FPlatformTime::Seconds();
+	
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.DirectoryExists(*SrcDir))
+	{
+		UE_LOG(LogReactorUMG, Warning, TEXT("Sync source directory does not exist: %s"), *SrcDir);
+		return false;
+	}
+	
+	if (!PlatformFile.CreateDirectoryTree(*DestDir))
+	{
+		UE_LOG(LogReactorUMG, Error, TEXT("Failed to create destination directory: %s"), *DestDir);
+		return false;
+	}
+
+	const FString ManifestPath = GetSyncManifestPath(DestDir);
+	TMap<FString, FSyncEntry> OldEntries;
+	LoadSyncManifest(ManifestPath, OldEntries);
+
+	TArray<TPair<FString, FFileStatData>> SrcFiles;
+	PlatformFile.IterateDirectoryStatRecursively(*SrcDir, [&SrcFiles](const TCHAR* Path, const FFileStatData& StatData)
+	{
+		if (!StatData.bIsDirectory)
+		{
+			SrcFiles.Emplace(Path, StatData);
+		}
+		return true;
+	});
+
+	TMap<FString, FSyncEntry> NewEntries;
+	NewEntries.Reserve(SrcFiles.Num());
+	int32 CopiedNum = 0;
+	bool bSuccess = true;
+	bool bManifestDirty = false;
+	
+	for (const TPair<FString, FFileStatData>& SrcFile : SrcFiles)
+	{
+		const FString& SourcePath = SrcFile.Key;
+		const FFileStatData& SrcStat = SrcFile.Value;
+		FString RelativePath = SourcePath;
+		FPaths::MakePathRelativeTo(RelativePath, *(SrcDir / TEXT("")));
+		if (Filter && !Filter(RelativePath))
+		{
+			continue;
+		}
+		
+		const FString DestPath = FPaths::Combine(*DestDir, *RelativePath);
+		const FFileStatData DestStat = PlatformFile.GetStatData(*DestPath);
+		const FSyncEntry* OldEntry = OldEntries.Find(RelativePath);
+
+		FSyncEntry Entry;
+		Entry.SrcSize = SrcStat.FileSize;
+		Entry.SrcTime = SrcStat.ModificationTime.GetTicks();
+
+		if (OldEntry && OldEntry->bKept && DestStat.bIsValid)
+		{
+			NewEntries.Add(RelativePath, *OldEntry);
+			continue;
+		}
+		
+		const bool bDestUntouched = OldEntry && DestStat.bIsValid && OldEntry->DestSize == DestStat.FileSize &&
+			OldEntry->DestTime == DestStat.ModificationTime.GetTicks();
+		if (bDestUntouched && OldEntry->SrcSize == Entry.SrcSize && OldEntry->SrcTime == Entry.SrcTime)
+		{
+			NewEntries.Add(RelativePath, *OldEntry);
+			continue;
+		}
+
+		bManifestDirty = true;
+		Entry.Hash = HashFile(SourcePath);
+		if (DestStat.bIsValid)
+		{
+			Entry.DestSize = DestStat.FileSize;
+			Entry.DestTime = DestStat.ModificationTime.GetTicks();
+			// only the timestamp of the source changed, or the destination already holds the same content
+			if ((bDestUntouched && OldEntry->Hash == Entry.Hash) ||
+				(!bDestUntouched && DestStat.FileSize == SrcStat.FileSize && HashFile(DestPath) == Entry.Hash))
+			{
+				NewEntries.Add(RelativePath, Entry);
+				continue;
+			}
+			
+			if (!bDestUntouched && !Overrided)
+			{
+				Entry.bKept = true;
+				NewEntries.Add(RelativePath, Entry);
+				continue;
+			}
+			PlatformFile.DeleteFile(*DestPath);
+		}
+
+		const FString DestSubDir = FPaths::GetPath(DestPath);
+		if (!PlatformFile.DirectoryExists(*DestSubDir))
+		{
+			PlatformFile.CreateDirectoryTree(*DestSubDir);
+		}
+
+		if (PlatformFile.CopyFile(*DestPath, *SourcePath))
+		{
+			++CopiedNum;
+		}
+		else
+		{
+			UE_LOG(LogReactorUMG, Warning, TEXT("Failed to copy file: %s"), *SourcePath);
+			bSuccess = false;
+			continue;
+		}
+
+		const FFileStatData WrittenStat = PlatformFile.GetStatData(*DestPath);
+		Entry.DestSize = WrittenStat.FileSize;
+		Entry.DestTime = WrittenStat.ModificationTime.GetTicks();
+		NewEntries.Add(RelativePath, Entry);
+	}
+
+	// files removed from the source are forgotten, their copies stay where they are
+	if (bManifestDirty || NewEntries.Num() != OldEntries.Num())
+	{
+		SaveSyncManifest(ManifestPath, NewEntries);
+	}
+
+	UE_LOG(LogReactorUMG, Log, TEXT("Synced %s to %s: %d files checked, %d copied in %.2f ms"), *SrcDir, *DestDir,
+		NewEntries.Num(), CopiedNum, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return bSuccess;
+}
+
+void FReactorUtils::SyncDirectoryAsync(const FString& SrcDir, const FString& DestDir, bool Overrided)
+{
+	if (!FPaths::FileExists(GetSyncManifestPath(DestDir)))
+	{
+		SyncDirectory(SrcDir, DestDir, Overrided);
+		return;
+	}
+
+	TFuture<bool> Future = Async(EAsyncExecution::ThreadPool, [SrcDir, DestDir, Overrided]()
+	{
+		return SyncDirectory(SrcDir, DestDir, Overrided);
+	});
+	
+	FScopeLock Lock(&PendingSyncsLock);
+	PendingSyncs.Add(MoveTemp(Future));
+}
+
+void FReactorUtils::WaitForPendingSyncs()
+{
+	TArray<TFuture<bool>> Syncs;
+	{
+		FScopeLock Lock(&PendingSyncsLock);
+		Syncs = MoveTemp(PendingSyncs);
+	}
+
+	for (TFuture<bool>& Sync : Syncs)
+	{
+		Sync.Wait();
+	}
+}
+
 void FReactorUtils::DeleteFile(const FString& FilePath)
 {
 	if (FPaths::FileExists(FilePath))
@@ -158,6 +430,228 @@ FString FReactorUtils::GetGamePlayStartPoint()
 	return FPaths::Combine(FPaths::ProjectContentDir(), DestDir, TEXT("src"), ProjectName, TEXT("start_game.js"));
 }
 
+// static requires and imports of a compiled module, dynamic ones with computed specifiers can not be followed
+static void FindModuleSpecifiers(const FString& Source, TArray<FString>& OutSpecifiers)
+{
+	static const FRegexPattern Pattern(TEXT("(?:\\brequire\\s*\\(|\\bimport\\s*\\(|\\bfrom|\\bimport)\\s*[\"']([^\"'\\r\\n]+)[\"']"));
+	FRegexMatcher Matcher(Pattern, Source);
+	while (Matcher.FindNext())
+	{
+		OutSpecifiers.Add(Matcher.GetCaptureGroup(1));
+	}
+}
+
+#if WITH_EDITOR
+struct FScriptClosureHash
+{
+	FString Hash;
+	TArray<TPair<FString, FDateTime>> Files;
+};
+
+// scripts are rebuilt while the editor runs, the closure is only walked again once one of its files changed
+static TMap<FString, FScriptClosureHash> ScriptClosureHashes;
+#endif
+
+FString FReactorUtils::GetLaunchScriptHash(const FString& MainScriptPath)
+{
+	const FString RootDir = GetDefault<UPuertsSetting>()->RootPath;
+	const FString ScriptPath = FPaths::Combine(FPaths::ProjectContentDir(), RootDir, MainScriptPath + TEXT(".js"));
+
+#if WITH_EDITOR
+	if (const FScriptClosureHash* Cached = ScriptClosureHashes.Find(ScriptPath))
+	{
+		bool bUpToDate = true;
+		for (const auto& File : Cached->Files)
+		{
+			if (IFileManager::Get().GetTimeStamp(*File.Key) != File.Value)
+			{
+				bUpToDate = false;
+				break;
+			}
+		}
+		if (bUpToDate)
+		{
+			return Cached->Hash;
+		}
+	}
+	FScriptClosureHash Closure;
+#endif
+
+	// the prerendered tree is only valid for the exact code it was rendered with, so every module the launch script
+	// requires, directly or not, is part of the hash. modules are resolved and read like the env does, which also covers
+	// packaged builds reading from the mounted script archive
+	puerts::DefaultJSModuleLoader Loader(RootDir);
+	Loader.EnableSearchCache = false;
+
+	FMD5 Md5;
+	TSet<FString> Visited;
+	TArray<FString> Pending;
+	Pending.Add(ScriptPath);
+	TArray<uint8> Content;
+	TArray<FString> Specifiers;
+	while (Pending.Num() > 0)
+	{
+		const FString Path = Pending.Pop(false);
+		if (Visited.Contains(Path))
+		{
+			continue;
+		}
+		Visited.Add(Path);
+
+		if (!Loader.Load(Path, Content))
+		{
+			if (Path == ScriptPath)
+			{
+				return FString();
+			}
+			continue;
+		}
+		Md5.Update(Content.GetData(), Content.Num());
+#if WITH_EDITOR
+		Closure.Files.Emplace(Path, IFileManager::Get().GetTimeStamp(*Path));
+#endif
+
+		const FString Extension = FPaths::GetExtension(Path);
+		if (Extension != TEXT("js") && Extension != TEXT("mjs") && Extension != TEXT("cjs"))
+		{
+			continue;
+		}
+
+		Specifiers.Reset();
+		FindModuleSpecifiers(FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Content.GetData()), Content.Num())), Specifiers);
+		const FString RequiredDir = FPaths::GetPath(Path);
+		// pushed in reverse so modules are hashed in the order they are required
+		for (int32 i = Specifiers.Num() - 1; i >= 0; --i)
+		{
+			FString DependencyPath;
+			FString DebugPath;
+			// builtin modules such as ue and puerts are not files
+			if (Loader.Search(RequiredDir, Specifiers[i], DependencyPath, DebugPath) && !Visited.Contains(DependencyPath))
+			{
+				Pending.Add(DependencyPath);
+			}
+		}
+	}
+
+	FMD5Hash Hash;
+	Hash.Set(Md5);
+	const FString Result = LexToString(Hash);
+#if WITH_EDITOR
+	Closure.Hash = Result;
+	ScriptClosureHashes.Add(ScriptPath, MoveTemp(Closure));
+#endif
+	return Result;
+}
+
+namespace
+{
+	constexpr int32 LaunchScriptHashManifestVersion = 1;
+
+	// lives in the script root so it is packed and staged with the scripts it describes
+	FString GetLaunchScriptHashManifestPath()
+	{
+		return FPaths::Combine(FPaths::ProjectContentDir(), GetDefault<UPuertsSetting>()->RootPath, TEXT("ReactorUMG"),
+			TEXT("LaunchScriptHashes.json"));
+	}
+
+	void LoadLaunchScriptHashManifest(TMap<FString, FString>& OutHashes)
+	{
+		FString FileBuffer;
+		if (!puerts::FScriptArchive::Get().LoadFileToString(GetLaunchScriptHashManifestPath(), FileBuffer))
+		{
+			return;
+		}
+
+		TSharedPtr<FJsonObject> JsonObject;
+		TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(FileBuffer);
+		if (!FJsonSerializer::Deserialize(JsonReader, JsonObject) || !JsonObject.IsValid() ||
+			JsonObject->GetIntegerField(TEXT("version")) != LaunchScriptHashManifestVersion)
+		{
+			return;
+		}
+
+		const TSharedPtr<FJsonObject>* ScriptsObject;
+		if (!JsonObject->TryGetObjectField(TEXT("scripts"), ScriptsObject))
+		{
+			return;
+		}
+
+		for (const auto& Pair : (*ScriptsObject)->Values)
+		{
+			OutHashes.Add(Pair.Key, Pair.Value->AsString());
+		}
+	}
+
+#if WITH_EDITOR
+	void SaveLaunchScriptHashManifest(const TMap<FString, FString>& Hashes)
+	{
+		TSharedRef<FJsonObject> ScriptsObject = MakeShared<FJsonObject>();
+		for (const auto& Pair : Hashes)
+		{
+			ScriptsObject->SetStringField(Pair.Key, Pair.Value);
+		}
+
+		TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+		JsonObject->SetNumberField(TEXT("version"), LaunchScriptHashManifestVersion);
+		JsonObject->SetObjectField(TEXT("scripts"), ScriptsObject);
+
+		FString FileBuffer;
+		TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&FileBuffer);
+		FJsonSerializer::Serialize(JsonObject, JsonWriter);
+		if (!FFileHelper::SaveStringToFile(FileBuffer, *GetLaunchScriptHashManifestPath()))
+		{
+			UE_LOG(LogReactorUMG, Warning, TEXT("Failed to write launch script hash manifest %s"), *GetLaunchScriptHashManifestPath());
+		}
+	}
+#endif
+}
+
+FString FReactorUtils::GetPackedLaunchScriptHash(const FString& MainScriptPath)
+{
+	check(IsInGameThread());
+	// the manifest only changes when the scripts are packed again, read it once
+	static TOptional<TMap<FString, FString>> PackedHashes;
+	if (!PackedHashes.IsSet())
+	{
+		LoadLaunchScriptHashManifest(PackedHashes.Emplace());
+	}
+
+	const FString* Hash = PackedHashes->Find(MainScriptPath);
+	return Hash ? *Hash : FString();
+}
+
+#if WITH_EDITOR
+void FReactorUtils::AddLaunchScriptToHashManifest(const FString& MainScriptPath)
+{
+	TMap<FString, FString> Hashes;
+	LoadLaunchScriptHashManifest(Hashes);
+	if (Hashes.Contains(MainScriptPath))
+	{
+		return;
+	}
+
+	// hashed at pack time only, a build whose scripts were not packed has nothing to trust and never hydrates
+	Hashes.Add(MainScriptPath, FString());
+	SaveLaunchScriptHashManifest(Hashes);
+}
+
+void FReactorUtils::RefreshLaunchScriptHashManifest()
+{
+	TMap<FString, FString> Hashes;
+	LoadLaunchScriptHashManifest(Hashes);
+	if (Hashes.Num() == 0)
+	{
+		return;
+	}
+
+	for (auto& Pair : Hashes)
+	{
+		Pair.Value = GetLaunchScriptHash(Pair.Key);
+	}
+	SaveLaunchScriptHashManifest(Hashes);
+}
+#endif
+
 bool FReactorUtils::CheckNameExistInArray(const TArray<FString>& SkipExistFiles, const FString& CheckName)
 {
 	for (const FString& FileName : SkipExistFiles)
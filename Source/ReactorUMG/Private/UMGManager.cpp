@@ -2,6 +2,7 @@
 
 #include "HttpModule.h"
 #include "Components/PanelSlot.h"
+#include "FontFamilyCache.h"
 #include "LogReactorUMG.h"
 #include "ReactorUtils.h"
 #include "Engine/Engine.h"
@@ -14,15 +15,29 @@
 #include "Blueprint/WidgetTree.h"
 #include "Blueprint/WidgetLayoutLibrary.h"
 #include "Components/Widget.h"
+#include "Components/PanelWidget.h"
 #include "Runtime/Launch/Resources/Version.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "ScriptArchive.h"
 
 #ifdef RIVE_SUPPORT
 #include "IRiveRendererModule.h"
 #include "Rive/RiveFile.h"
 #endif 
 
+// packaged builds serve script side assets from the mounted script archive
+static UTexture2D* ImportTextureFromAssetFile(UObject* Outer, const FString& FilePath)
+{
+    const puerts::FScriptArchive& Archive = puerts::FScriptArchive::Get();
+    if (const puerts::FScriptArchive::FEntry* Entry = Archive.Find(FilePath))
+    {
+        TArray<uint8> Buffer(Archive.GetData(*Entry), (int32) Entry->Size);
+        return UKismetRenderingLibrary::ImportBufferAsTexture2D(Outer, Buffer);
+    }
+    return UKismetRenderingLibrary::ImportFileAsTexture2D(Outer, FilePath);
+}
+
 UReactorUIWidget* UUMGManager::CreateReactWidget(UWorld* World)
 {
     return ::CreateWidget<UReactorUIWidget>(World);
@@ -53,7 +68,7 @@ USpineAtlasAsset* UUMGManager::LoadSpineAtlas(UObject* Context, const FString& A
 {
     FString RawData;
     const FString AssetFilePath = ProcessAssetFilePath(AtlasPath, DirName);
-    if (!FFileHelper::LoadFileToString(RawData, *AssetFilePath))
+    if (!puerts::FScriptArchive::Get().LoadFileToString(AssetFilePath, RawData))
     {
         UE_LOG(LogReactorUMG, Error, TEXT("Spine atlas asset file( %s ) not exists."), *AssetFilePath);
         return nullptr;
@@ -76,7 +91,7 @@ USpineAtlasAsset* UUMGManager::LoadSpineAtlas(UObject* Context, const FString& A
     {
         spine::AtlasPage *P = Pages[i];
         const FString SourceTextureFilename = FPaths::Combine(*BaseFilePath, UTF8_TO_TCHAR(P->name.buffer()));
-        UTexture2D *texture = UKismetRenderingLibrary::ImportFileAsTexture2D(SpineAtlasAsset, SourceTextureFilename);
+        UTexture2D *texture = ImportTextureFromAssetFile(SpineAtlasAsset, SourceTextureFilename);
         SpineAtlasAsset->atlasPages.Add(texture); 
     }
     
@@ -87,7 +102,7 @@ USpineSkeletonDataAsset* UUMGManager::LoadSpineSkeleton(UObject* Context, const
 {
     TArray<uint8> RawData;
     const FString AssetFilePath = ProcessAssetFilePath(SkeletonPath, DirName);
-    if (!FFileHelper::LoadFileToArray(RawData, *AssetFilePath, 0))
+    if (!puerts::FScriptArchive::Get().LoadFileToArray(AssetFilePath, RawData))
     {
         UE_LOG(LogReactorUMG, Error, TEXT("Spine skeleton asset file( %s ) not exists."), *AssetFilePath);
         return nullptr;
@@ -117,7 +132,7 @@ URiveFile* UUMGManager::LoadRiveFile(UObject* Context, const FString& RivePath,
     }
 
     const FString RiveAssetFilePath = ProcessAssetFilePath(RivePath, DirName);
-    if (!FPaths::FileExists(RiveAssetFilePath))
+    if (!puerts::FScriptArchive::Get().FileExists(RiveAssetFilePath))
     {
         UE_LOG(
             LogReactorUMG,
@@ -140,7 +155,7 @@ URiveFile* UUMGManager::LoadRiveFile(UObject* Context, const FString& RivePath,
     }
 
     TArray<uint8> FileBuffer;
-    if (!FFileHelper::LoadFileToArray(FileBuffer, *RiveAssetFilePath)) // load entire DNA file into the array
+    if (!puerts::FScriptArchive::Get().LoadFileToArray(RiveAssetFilePath, FileBuffer)) // load entire DNA file into the array
     {
         UE_LOG(
             LogReactorUMG,
@@ -184,23 +199,7 @@ UWorld* UUMGManager::GetCurrentWorld()
 
 UObject* UUMGManager::FindFontFamily(const TArray<FString>& Names, UObject* InOuter)
 {
-    const FString FontDir = TEXT("/ReactorUMG/FontFamily");
-    for (const FString& Name : Names)
-    {
-        const FString FontAssetPath = FontDir / Name + TEXT(".") + Name;
-        if (UFont* Font = Cast<UFont>(StaticLoadObject(UFont::StaticClass(), InOuter, *FontAssetPath)))
-        {
-            return Font;
-        }
-    }
-
-    const FString DefaultEngineFont = TEXT("/Engine/EngineFonts/Roboto.Roboto");
-    if (UFont* DefaultFont = Cast<UFont>(StaticLoadObject(UFont::StaticClass(), InOuter, *DefaultEngineFont)))
-    {
-        return DefaultFont;
-    }
-    
-    return nullptr;
+    return FFontFamilyCache::Get().Resolve(Names);
 }
 
 FVector2D UUMGManager::GetWidgetGeometrySize(UWidget* Widget)
@@ -236,7 +235,7 @@ void UUMGManager::LoadBrushImageObject(const FString& ImagePath, FAssetLoadedDel
     }
 
     const FString AbsPath = ProcessAssetFilePath(ImagePath, DirName);
-    if (!FPaths::FileExists(*AbsPath))
+    if (!puerts::FScriptArchive::Get().FileExists(AbsPath))
     {
         UE_LOG(LogReactorUMG, Error, TEXT("Image file( %s ) not exists."), *AbsPath);
         return; 
@@ -264,10 +263,11 @@ FString UUMGManager::GetAbsoluteJSContentPath(const FString& RelativePath, const
 
 FString UUMGManager::ProcessAssetFilePath(const FString& RelativePath, const FString& DirName)
 {
-    if (!FPaths::FileExists(*RelativePath))
+    const puerts::FScriptArchive& Archive = puerts::FScriptArchive::Get();
+    if (!Archive.FileExists(RelativePath))
     {
         FString AbsPath = GetAbsoluteJSContentPath(RelativePath, DirName);
-        if (!FPaths::FileExists(*AbsPath))
+        if (!Archive.FileExists(AbsPath))
         {
             AbsPath = FReactorUtils::ConvertRelativePathToFullUsingTSConfig(RelativePath, DirName);
         }
@@ -316,7 +316,7 @@ void UUMGManager::LoadImageTextureFromLocalFile(const FString& FilePath, UObject
 {
     if (bIsSyncLoad)
     {
-        UTexture2D* Texture = UKismetRenderingLibrary::ImportFileAsTexture2D(nullptr, FilePath);
+        UTexture2D* Texture = ImportTextureFromAssetFile(nullptr, FilePath);
         if (Texture)
         {
             Texture->AddToCluster(Context);
@@ -329,7 +329,7 @@ void UUMGManager::LoadImageTextureFromLocalFile(const FString& FilePath, UObject
     {
         AsyncTask(ENamedThreads::GameThread, [FilePath, Context, OnLoaded, OnFailed]()
         {
-            UTexture2D *Texture = UKismetRenderingLibrary::ImportFileAsTexture2D(nullptr, FilePath);
+            UTexture2D *Texture = ImportTextureFromAssetFile(nullptr, FilePath);
             if (Texture)
             {
                 Texture->AddToCluster(Context);
@@ -388,6 +388,13 @@ void UUMGManager::AddRootWidgetToWidgetTree(UWidgetTree* Container, UWidget* Roo
         return;
     }
 
+    // a reconciler that hydrates adopts the prerendered root instead of adding one, a new root replaces the prerendered
+    // tree so the widget must stop reporting that it is hydrating
+    if (Container->RootWidget != RootWidget && IsHydratingWidgetTree(Container))
+    {
+        FinishHydration(Container);
+    }
+
     RootWidget->RemoveFromParent();
 
     EObjectFlags NewObjectFlags = RF_Transactional;
@@ -470,3 +477,44 @@ FVector2D UUMGManager::GetCanvasSizeDIP(UObject* WorldContextObject)
     const float Scale = UWidgetLayoutLibrary::GetViewportScale(WorldContextObject);
     return ViewportSizePx / FMath::Max(Scale, 0.0001f);
 }
+
+bool UUMGManager::IsHydratingWidgetTree(UWidgetTree* Container)
+{
+    const UReactorUIWidget* Owner = Container ? Cast<UReactorUIWidget>(Container->GetOuter()) : nullptr;
+    return Owner && Owner->WidgetTree == Container && Owner->IsHydrating();
+}
+
+static void CollectWidgetsPreOrder(UWidget* Widget, TArray<UWidget*>& OutWidgets)
+{
+    if (Widget == nullptr)
+    {
+        return;
+    }
+
+    OutWidgets.Add(Widget);
+    if (const UPanelWidget* Panel = Cast<UPanelWidget>(Widget))
+    {
+        for (int32 Index = 0; Index < Panel->GetChildrenCount(); ++Index)
+        {
+            CollectWidgetsPreOrder(Panel->GetChildAt(Index), OutWidgets);
+        }
+    }
+}
+
+TArray<UWidget*> UUMGManager::GetPrerenderedWidgets(UWidgetTree* Container)
+{
+    TArray<UWidget*> Widgets;
+    if (Container)
+    {
+        CollectWidgetsPreOrder(Container->RootWidget, Widgets);
+    }
+    return Widgets;
+}
+
+void UUMGManager::FinishHydration(UWidgetTree* Container)
+{
+    if (UReactorUIWidget* Owner = Container ? Cast<UReactorUIWidget>(Container->GetOuter()) : nullptr)
+    {
+        Owner->FinishHydration();
+    }
+}
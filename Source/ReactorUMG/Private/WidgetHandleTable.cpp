@@ -0,0 +1,530 @@
+#include "WidgetHandleTable.h"
+
+#include "LogReactorUMG.h"
+#include "UMGManager.h"
+#include "WidgetPool.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/PanelSlot.h"
+#include "Components/PanelWidget.h"
+#include "Components/Widget.h"
+#include "Engine/World.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+FWidgetHandleTable& FWidgetHandleTable::Get()
+{
+	static FWidgetHandleTable Instance;
+	return Instance;
+}
+
+void FWidgetHandleTable::Startup()
+{
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddRaw(this, &FWidgetHandleTable::OnWorldCleanup);
+}
+
+void FWidgetHandleTable::Shutdown()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	ReleaseAll();
+}
+
+void FWidgetHandleTable::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	// 创建后没挂上去、或者被移出的控件由句柄表强引用，不释放会让切换前的关卡一直存活
+	for (int32 Index = 0; Index < Slots.Num(); ++Index)
+	{
+		const FSlot& Slot = Slots[Index];
+		if (!Slot.bUsed)
+		{
+			continue;
+		}
+		const UObject* Object = Slot.Object.Get();
+		if (Object == nullptr || Object->IsIn(World) || Object->GetWorld() == World)
+		{
+			Release(MakeHandle(Index, Slot.Generation));
+		}
+	}
+}
+
+void FWidgetHandleTable::ReleaseAll()
+{
+	for (int32 Index = 0; Index < Slots.Num(); ++Index)
+	{
+		if (Slots[Index].bUsed)
+		{
+			Release(MakeHandle(Index, Slots[Index].Generation));
+		}
+	}
+	PinnedObjects.Empty();
+	ObjectToHandle.Empty();
+}
+
+const FWidgetHandleTable::FSlot* FWidgetHandleTable::FindSlot(int32 Handle) const
+{
+	if (Handle <= 0)
+	{
+		return nullptr;
+	}
+
+	const uint32 Index = (uint32) Handle & IndexMask;
+	const uint32 Generation = (uint32) Handle >> IndexBits;
+	if (!Slots.IsValidIndex(Index))
+	{
+		return nullptr;
+	}
+
+	const FSlot& Slot = Slots[Index];
+	return Slot.bUsed && Slot.Generation == Generation ? &Slot : nullptr;
+}
+
+int32 FWidgetHandleTable::Register(UObject* Object, bool bPin)
+{
+	check(IsInGameThread());
+	if (!IsValid(Object))
+	{
+		return 0;
+	}
+
+	if (const int32* Existing = ObjectToHandle.Find(Object))
+	{
+		const FSlot* Slot = FindSlot(*Existing);
+		if (Slot && Slot->Object.Get() == Object)
+		{
+			if (bPin)
+			{
+				PinnedObjects.Add(Object);
+			}
+			return *Existing;
+		}
+		// 旧对象已被回收，地址被新对象复用
+		ObjectToHandle.Remove(Object);
+	}
+
+	uint32 Index;
+	if (FreeSlots.Num() > 0)
+	{
+		Index = FreeSlots.Pop(false);
+	}
+	else
+	{
+		if ((uint32) Slots.Num() > IndexMask)
+		{
+			UE_LOG(LogReactorUMG, Error, TEXT("Widget handle table is full, %d handles alive"), LiveHandles);
+			return 0;
+		}
+		Index = Slots.AddDefaulted();
+	}
+
+	FSlot& Slot = Slots[Index];
+	Slot.Object = Object;
+	Slot.bUsed = true;
+	++LiveHandles;
+
+	const int32 Handle = MakeHandle(Index, Slot.Generation);
+	ObjectToHandle.Add(Object, Handle);
+	if (bPin)
+	{
+		PinnedObjects.Add(Object);
+	}
+	return Handle;
+}
+
+UObject* FWidgetHandleTable::Resolve(int32 Handle) const
+{
+	const FSlot* Slot = FindSlot(Handle);
+	return Slot ? Slot->Object.Get() : nullptr;
+}
+
+void FWidgetHandleTable::Release(int32 Handle)
+{
+	check(IsInGameThread());
+	if (!FindSlot(Handle))
+	{
+		return;
+	}
+
+	const uint32 Index = (uint32) Handle & IndexMask;
+	FSlot& Slot = Slots[Index];
+	if (UObject* Object = Slot.Object.Get())
+	{
+		PinnedObjects.Remove(Object);
+		const int32* Mapped = ObjectToHandle.Find(Object);
+		if (Mapped && *Mapped == Handle)
+		{
+			ObjectToHandle.Remove(Object);
+		}
+	}
+
+	Slot.Object.Reset();
+	Slot.bUsed = false;
+	Slot.Generation = (Slot.Generation % GenerationMask) + 1;
+	FreeSlots.Add(Index);
+	--LiveHandles;
+}
+
+void FWidgetHandleTable::ReleaseObject(const UObject* Object)
+{
+	if (const int32* Handle = ObjectToHandle.Find(Object))
+	{
+		Release(*Handle);
+	}
+}
+
+void FWidgetHandleTable::Pin(int32 Handle, bool bPin)
+{
+	UObject* Object = Resolve(Handle);
+	if (Object == nullptr)
+	{
+		return;
+	}
+
+	if (bPin)
+	{
+		PinnedObjects.Add(Object);
+	}
+	else
+	{
+		PinnedObjects.Remove(Object);
+	}
+}
+
+int32 FWidgetHandleTable::ResolvePropertyId(int32 Handle, const FString& PropertyName)
+{
+	UObject* Object = Resolve(Handle);
+	if (Object == nullptr)
+	{
+		return 0;
+	}
+
+	UClass* Class = Object->GetClass();
+	const TPair<const UStruct*, FName> Key(Class, FName(*PropertyName));
+	if (const int32* Id = PropertyIds.Find(Key))
+	{
+		const FPropertyEntry& Entry = Properties[*Id - 1];
+		if (Entry.Owner.Get() == Class)
+		{
+			return *Id;
+		}
+	}
+
+	FProperty* Property = FindFProperty<FProperty>(Class, Key.Value);
+	if (Property == nullptr)
+	{
+		UE_LOG(LogReactorUMG, Warning, TEXT("Can not find property %s in %s"), *PropertyName, *Class->GetName());
+		return 0;
+	}
+
+	FPropertyEntry Entry;
+	Entry.Owner = Class;
+	Entry.Property = Property;
+	const int32 Id = Properties.Add(Entry) + 1;
+	PropertyIds.Add(Key, Id);
+	return Id;
+}
+
+FProperty* FWidgetHandleTable::ResolveProperty(int32 Handle, int32 PropertyId, UObject*& OutObject, void*& OutValuePtr) const
+{
+	OutObject = Resolve(Handle);
+	if (OutObject == nullptr || !Properties.IsValidIndex(PropertyId - 1))
+	{
+		return nullptr;
+	}
+
+	const FPropertyEntry& Entry = Properties[PropertyId - 1];
+	const UStruct* Owner = Entry.Owner.Get();
+	if (Owner == nullptr || !OutObject->GetClass()->IsChildOf(Owner))
+	{
+		return nullptr;
+	}
+
+	OutValuePtr = Entry.Property->ContainerPtrToValuePtr<void>(OutObject);
+	return Entry.Property;
+}
+
+void FWidgetHandleTable::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(PinnedObjects);
+}
+
+int32 UWidgetHandleLibrary::CreateWidget(UWidgetTree* Outer, UClass* Class)
+{
+	if (Outer == nullptr || Class == nullptr || !Class->IsChildOf(UWidget::StaticClass()))
+	{
+		return 0;
+	}
+
+	UWidget* Widget = FWidgetPool::Get().Acquire(Outer, Class);
+	return FWidgetHandleTable::Get().Register(Widget, true);
+}
+
+bool UWidgetHandleLibrary::ReleaseWidget(int32 Handle)
+{
+	UWidget* Widget = Cast<UWidget>(FWidgetHandleTable::Get().Resolve(Handle));
+	if (Widget == nullptr)
+	{
+		return false;
+	}
+
+	// 子控件的句柄由控件池逐个释放
+	FWidgetHandleTable::Get().Release(Handle);
+	return FWidgetPool::Get().Release(Widget);
+}
+
+int32 UWidgetHandleLibrary::GetHandle(UObject* Object)
+{
+	if (Object == nullptr || !Object->IsA(UVisual::StaticClass()))
+	{
+		return 0;
+	}
+	return FWidgetHandleTable::Get().Register(Object, false);
+}
+
+UObject* UWidgetHandleLibrary::GetObject(int32 Handle)
+{
+	return FWidgetHandleTable::Get().Resolve(Handle);
+}
+
+bool UWidgetHandleLibrary::IsValidHandle(int32 Handle)
+{
+	return FWidgetHandleTable::Get().Resolve(Handle) != nullptr;
+}
+
+void UWidgetHandleLibrary::ReleaseHandle(int32 Handle)
+{
+	FWidgetHandleTable::Get().Release(Handle);
+}
+
+int32 UWidgetHandleLibrary::AddChild(int32 Parent, int32 Child)
+{
+	FWidgetHandleTable& Table = FWidgetHandleTable::Get();
+	UPanelWidget* Panel = Cast<UPanelWidget>(Table.Resolve(Parent));
+	UWidget* Content = Cast<UWidget>(Table.Resolve(Child));
+	if (Panel == nullptr || Content == nullptr)
+	{
+		return 0;
+	}
+
+	UPanelSlot* PanelSlot = Panel->AddChild(Content);
+	if (PanelSlot == nullptr)
+	{
+		return 0;
+	}
+	Table.Pin(Child, false);
+	return Table.Register(PanelSlot, false);
+}
+
+int32 UWidgetHandleLibrary::InsertChildAt(int32 Parent, int32 Index, int32 Child)
+{
+	FWidgetHandleTable& Table = FWidgetHandleTable::Get();
+	UPanelWidget* Panel = Cast<UPanelWidget>(Table.Resolve(Parent));
+	UWidget* Content = Cast<UWidget>(Table.Resolve(Child));
+	if (Panel == nullptr || Content == nullptr)
+	{
+		return 0;
+	}
+
+	UPanelSlot* PanelSlot = Panel->InsertChildAt(Index, Content);
+	if (PanelSlot == nullptr)
+	{
+		return 0;
+	}
+	Table.Pin(Child, false);
+	return Table.Register(PanelSlot, false);
+}
+
+bool UWidgetHandleLibrary::RemoveChild(int32 Parent, int32 Child)
+{
+	FWidgetHandleTable& Table = FWidgetHandleTable::Get();
+	UPanelWidget* Panel = Cast<UPanelWidget>(Table.Resolve(Parent));
+	UWidget* Content = Cast<UWidget>(Table.Resolve(Child));
+	if (Panel == nullptr || Content == nullptr)
+	{
+		return false;
+	}
+
+	// 先钉住再移除，移出的控件可能马上被插回别的位置
+	Table.Pin(Child, true);
+	UPanelSlot* PanelSlot = Content->Slot;
+	if (!Panel->RemoveChild(Content))
+	{
+		return false;
+	}
+
+	if (PanelSlot)
+	{
+		Table.Release(Table.Register(PanelSlot, false));
+	}
+	return true;
+}
+
+int32 UWidgetHandleLibrary::GetSlot(int32 Widget)
+{
+	FWidgetHandleTable& Table = FWidgetHandleTable::Get();
+	UWidget* Content = Cast<UWidget>(Table.Resolve(Widget));
+	if (Content == nullptr || Content->Slot == nullptr)
+	{
+		return 0;
+	}
+	return Table.Register(Content->Slot, false);
+}
+
+void UWidgetHandleLibrary::SetRootWidget(UWidgetTree* Container, int32 Root)
+{
+	FWidgetHandleTable& Table = FWidgetHandleTable::Get();
+	UWidget* RootWidget = Cast<UWidget>(Table.Resolve(Root));
+	if (Container == nullptr || RootWidget == nullptr)
+	{
+		return;
+	}
+
+	UUMGManager::AddRootWidgetToWidgetTree(Container, RootWidget);
+	Table.Pin(Root, false);
+}
+
+void UWidgetHandleLibrary::RemoveRootWidget(UWidgetTree* Container, int32 Root)
+{
+	FWidgetHandleTable& Table = FWidgetHandleTable::Get();
+	UWidget* RootWidget = Cast<UWidget>(Table.Resolve(Root));
+	if (Container == nullptr || RootWidget == nullptr)
+	{
+		return;
+	}
+
+	Table.Pin(Root, true);
+	UUMGManager::RemoveRootWidgetFromWidgetTree(Container, RootWidget);
+}
+
+int32 UWidgetHandleLibrary::GetPropertyId(int32 Handle, const FString& PropertyName)
+{
+	return FWidgetHandleTable::Get().ResolvePropertyId(Handle, PropertyName);
+}
+
+bool UWidgetHandleLibrary::SetBoolProperty(int32 Handle, int32 PropertyId, bool Value)
+{
+	UObject* Object;
+	void* ValuePtr;
+	FBoolProperty* BoolProperty = CastField<FBoolProperty>(FWidgetHandleTable::Get().ResolveProperty(Handle, PropertyId, Object, ValuePtr));
+	if (BoolProperty == nullptr)
+	{
+		return false;
+	}
+
+	BoolProperty->SetPropertyValue(ValuePtr, Value);
+	return true;
+}
+
+bool UWidgetHandleLibrary::SetNumberProperty(int32 Handle, int32 PropertyId, double Value)
+{
+	UObject* Object;
+	void* ValuePtr;
+	FProperty* Property = FWidgetHandleTable::Get().ResolveProperty(Handle, PropertyId, Object, ValuePtr);
+
+	FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property);
+	if (FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+	{
+		NumericProperty = EnumProperty->GetUnderlyingProperty();
+	}
+	if (NumericProperty == nullptr)
+	{
+		return false;
+	}
+
+	if (NumericProperty->IsFloatingPoint())
+	{
+		NumericProperty->SetFloatingPointPropertyValue(ValuePtr, Value);
+	}
+	else
+	{
+		// 超出 int64 范围或 NaN 的 double 直接转换是未定义行为
+		int64 IntValue = 0;
+		if (Value >= 9223372036854775807.0)
+		{
+			IntValue = MAX_int64;
+		}
+		else if (Value <= -9223372036854775808.0)
+		{
+			IntValue = MIN_int64;
+		}
+		else if (!FMath::IsNaN(Value))
+		{
+			IntValue = (int64) Value;
+		}
+		NumericProperty->SetIntPropertyValue(ValuePtr, IntValue);
+	}
+	return true;
+}
+
+bool UWidgetHandleLibrary::SetStringProperty(int32 Handle, int32 PropertyId, const FString& Value)
+{
+	UObject* Object;
+	void* ValuePtr;
+	FProperty* Property = FWidgetHandleTable::Get().ResolveProperty(Handle, PropertyId, Object, ValuePtr);
+
+	if (FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+	{
+		StrProperty->SetPropertyValue(ValuePtr, Value);
+	}
+	else if (FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+	{
+		NameProperty->SetPropertyValue(ValuePtr, FName(*Value));
+	}
+	else if (FTextProperty* TextProperty = CastField<FTextProperty>(Property))
+	{
+		TextProperty->SetPropertyValue(ValuePtr, FText::FromString(Value));
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+bool UWidgetHandleLibrary::SetObjectProperty(int32 Handle, int32 PropertyId, UObject* Value)
+{
+	UObject* Object;
+	void* ValuePtr;
+	FObjectPropertyBase* ObjectProperty =
+		CastField<FObjectPropertyBase>(FWidgetHandleTable::Get().ResolveProperty(Handle, PropertyId, Object, ValuePtr));
+	if (ObjectProperty == nullptr || (Value && !Value->IsA(ObjectProperty->PropertyClass)))
+	{
+		return false;
+	}
+
+	ObjectProperty->SetObjectPropertyValue(ValuePtr, Value);
+	return true;
+}
+
+bool UWidgetHandleLibrary::SetPropertyFromText(int32 Handle, int32 PropertyId, const FString& Value)
+{
+	UObject* Object;
+	void* ValuePtr;
+	FProperty* Property = FWidgetHandleTable::Get().ResolveProperty(Handle, PropertyId, Object, ValuePtr);
+	if (Property == nullptr)
+	{
+		return false;
+	}
+
+#if ENGINE_MINOR_VERSION > 0 && ENGINE_MAJOR_VERSION > 4
+	return Property->ImportText_Direct(*Value, ValuePtr, Object, PPF_None) != nullptr;
+#else
+	return Property->ImportText(*Value, ValuePtr, PPF_None, Object) != nullptr;
+#endif
+}
+
+void UWidgetHandleLibrary::SynchronizeProperties(int32 Handle)
+{
+	UObject* Object = FWidgetHandleTable::Get().Resolve(Handle);
+	if (UWidget* Widget = Cast<UWidget>(Object))
+	{
+		UUMGManager::SynchronizeWidgetProperties(Widget);
+	}
+	else if (UPanelSlot* PanelSlot = Cast<UPanelSlot>(Object))
+	{
+		UUMGManager::SynchronizeSlotProperties(PanelSlot);
+	}
+}
+
+int32 UWidgetHandleLibrary::GetLiveHandleNum()
+{
+	return FWidgetHandleTable::Get().GetLiveHandleNum();
+}
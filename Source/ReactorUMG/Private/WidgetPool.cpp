@@ -0,0 +1,360 @@
+#include "WidgetPool.h"
+
+#include "LogReactorUMG.h"
+#include "UMGManager.h"
+#include "WidgetHandleTable.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/PanelWidget.h"
+#include "Components/Widget.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+static int32 WidgetPoolCapacity = 32;
+static FAutoConsoleVariableRef CVarWidgetPoolCapacity(TEXT("ReactorUMG.WidgetPoolCapacity"), WidgetPoolCapacity,
+	TEXT("Max number of released widgets kept per class for reuse, 0 disables widget pooling"), ECVF_Default);
+
+static float WidgetPoolSlateReleaseDelay = 10.0f;
+static FAutoConsoleVariableRef CVarWidgetPoolSlateReleaseDelay(TEXT("ReactorUMG.WidgetPoolSlateReleaseDelay"), WidgetPoolSlateReleaseDelay,
+	TEXT("Seconds a pooled widget keeps its slate widget before ReleaseSlateResources is called on it"), ECVF_Default);
+
+static FAutoConsoleCommand DumpWidgetPoolCommand(TEXT("ReactorUMG.DumpWidgetPool"),
+	TEXT("Log hits, misses and pooled widgets of the widget pool"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+		{
+			const FWidgetPoolStats Stats = FWidgetPool::Get().GetTotalStats();
+			Ar.Logf(TEXT("Widget pool: %d hits, %d misses, %d released, %d discarded, %d pooled"), Stats.Hits, Stats.Misses,
+				Stats.Released, Stats.Discarded, Stats.Pooled);
+		}));
+
+FWidgetPool& FWidgetPool::Get()
+{
+	static FWidgetPool Instance;
+	return Instance;
+}
+
+void FWidgetPool::Startup()
+{
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddRaw(this, &FWidgetPool::OnWorldCleanup);
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FWidgetPool::PurgeStaleClasses);
+}
+
+void FWidgetPool::Shutdown()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	Pools.Empty();
+}
+
+void FWidgetPool::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	// 还没移到临时包的控件仍挂在原来的控件树下，会让切换前的关卡（包括结束的 PIE）一直存活
+	int32 Purged = 0;
+	for (auto& Pair : Pools)
+	{
+		Purged += Pair.Value.Free.RemoveAll([World](const FPooledWidget& Pooled)
+		{
+			if (!IsValid(Pooled.Widget))
+			{
+				return true;
+			}
+			if (!Pooled.Widget->IsIn(World) && Pooled.Widget->GetWorld() != World)
+			{
+				return false;
+			}
+			if (!Pooled.bSlateReleased)
+			{
+				Pooled.Widget->ReleaseSlateResources(true);
+			}
+			return true;
+		});
+	}
+	if (Purged > 0)
+	{
+		UE_LOG(LogReactorUMG, Verbose, TEXT("Widget pool dropped %d widgets of world %s"), Purged, *World->GetName());
+	}
+	PurgeStaleClasses();
+}
+
+void FWidgetPool::PurgeStaleClasses()
+{
+	// 蓝图重编译后旧类变成 REINST_ 类，它们的池不会再被取用
+	for (auto It = Pools.CreateIterator(); It; ++It)
+	{
+		const UClass* Class = It.Key().Get();
+		if (Class == nullptr || Class->HasAnyClassFlags(CLASS_NewerVersionExists))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool FWidgetPool::IsPoolable(UClass* Class) const
+{
+	return Class && Class->IsChildOf(UWidget::StaticClass()) && !Class->IsChildOf(UUserWidget::StaticClass()) &&
+		!Class->HasAnyClassFlags(CLASS_Abstract | CLASS_NewerVersionExists);
+}
+
+int32 FWidgetPool::GetCapacity(const FClassPool& Pool) const
+{
+	return Pool.Capacity >= 0 ? Pool.Capacity : WidgetPoolCapacity;
+}
+
+UWidget* FWidgetPool::Acquire(UWidgetTree* Outer, UClass* Class)
+{
+	check(IsInGameThread());
+	if (Outer == nullptr || Class == nullptr || !Class->IsChildOf(UWidget::StaticClass()))
+	{
+		return nullptr;
+	}
+
+	if (!IsPoolable(Class))
+	{
+		return Class->IsChildOf(UUserWidget::StaticClass())
+			? UUMGManager::CreateWidget(Outer, Class)
+			: Outer->ConstructWidget<UWidget>(Class);
+	}
+
+	FClassPool& Pool = Pools.FindOrAdd(Class);
+	while (Pool.Free.Num() > 0)
+	{
+		FPooledWidget Pooled = Pool.Free.Pop();
+		UWidget* Widget = Pooled.Widget;
+		if (!IsValid(Widget))
+		{
+			continue;
+		}
+
+		++Pool.Stats.Hits;
+		if (Widget->GetOuter() != Outer)
+		{
+			// 控件名只需要在 outer 内唯一，换 outer 时重新生成
+			Widget->Rename(nullptr, Outer, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+		}
+		// 保留下来的 Slate 控件还是上一次的状态，先同步成默认属性
+		if (Widget->GetCachedWidget().IsValid())
+		{
+			Widget->SynchronizeProperties();
+		}
+		return Widget;
+	}
+
+	++Pool.Stats.Misses;
+	return Outer->ConstructWidget<UWidget>(Class);
+}
+
+bool FWidgetPool::Release(UWidget* Widget)
+{
+	check(IsInGameThread());
+	if (!IsValid(Widget))
+	{
+		return false;
+	}
+
+	// 整棵子树一起卸载，子控件先回收，留在面板里的会在下次复用时又显示出来
+	if (UPanelWidget* Panel = Cast<UPanelWidget>(Widget))
+	{
+		for (int32 Index = Panel->GetChildrenCount() - 1; Index >= 0; --Index)
+		{
+			UWidget* Child = Panel->GetChildAt(Index);
+			if (IsValid(Child))
+			{
+				Release(Child);
+			}
+			else
+			{
+				Panel->RemoveChildAt(Index);
+			}
+		}
+	}
+
+	Widget->RemoveFromParent();
+	// 旧句柄不能指向复用后的控件
+	FWidgetHandleTable::Get().ReleaseObject(Widget);
+
+	UClass* Class = Widget->GetClass();
+	if (!IsPoolable(Class))
+	{
+		return false;
+	}
+
+	FClassPool& Pool = Pools.FindOrAdd(Class);
+	if (Pool.Free.Num() >= GetCapacity(Pool))
+	{
+		++Pool.Stats.Discarded;
+		return false;
+	}
+
+	ResetToDefaults(Widget);
+
+	FPooledWidget& Pooled = Pool.Free.AddDefaulted_GetRef();
+	Pooled.Widget = Widget;
+	Pooled.ReleaseTime = FPlatformTime::Seconds();
+	++Pool.Stats.Released;
+
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FWidgetPool::Tick), 1.0f);
+	}
+	return true;
+}
+
+void FWidgetPool::ResetToDefaults(UWidget* Widget)
+{
+	const UObject* Defaults = Widget->GetClass()->GetDefaultObject();
+	for (TFieldIterator<FProperty> It(Widget->GetClass()); It; ++It)
+	{
+		FProperty* Property = *It;
+		// 事件和属性绑定也要清掉，否则会回调到已经卸载的组件
+		const bool bDelegate = Property->IsA<FDelegateProperty>() || Property->IsA<FMulticastInlineDelegateProperty>();
+		if (!bDelegate && !Property->HasAnyPropertyFlags(CPF_Edit | CPF_BlueprintVisible))
+		{
+			continue;
+		}
+		// Slot 等实例化子对象不能和 CDO 共享
+		if (Property->HasAnyPropertyFlags(CPF_Transient | CPF_InstancedReference | CPF_ContainsInstancedReference))
+		{
+			continue;
+		}
+		if (!Property->Identical_InContainer(Widget, Defaults))
+		{
+			Property->CopyCompleteValue_InContainer(Widget, Defaults);
+		}
+	}
+}
+
+bool FWidgetPool::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	bool bAnyPending = false;
+	for (auto& Pair : Pools)
+	{
+		for (FPooledWidget& Pooled : Pair.Value.Free)
+		{
+			if (Pooled.bSlateReleased || !IsValid(Pooled.Widget))
+			{
+				continue;
+			}
+			if (Now - Pooled.ReleaseTime < WidgetPoolSlateReleaseDelay)
+			{
+				bAnyPending = true;
+				continue;
+			}
+
+			Pooled.Widget->ReleaseSlateResources(true);
+			// 闲置的控件不再让原来的控件树保持存活
+			if (Pooled.Widget->GetOuter() != GetTransientPackage())
+			{
+				Pooled.Widget->Rename(nullptr, GetTransientPackage(), REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+			}
+			Pooled.bSlateReleased = true;
+		}
+	}
+
+	if (!bAnyPending)
+	{
+		TickerHandle.Reset();
+	}
+	return bAnyPending;
+}
+
+void FWidgetPool::SetCapacity(UClass* Class, int32 Capacity)
+{
+	if (!IsPoolable(Class))
+	{
+		return;
+	}
+
+	FClassPool& Pool = Pools.FindOrAdd(Class);
+	Pool.Capacity = Capacity < 0 ? INDEX_NONE : Capacity;
+	const int32 MaxNum = GetCapacity(Pool);
+	if (Pool.Free.Num() > MaxNum)
+	{
+		Pool.Stats.Discarded += Pool.Free.Num() - MaxNum;
+		Pool.Free.SetNum(MaxNum);
+	}
+}
+
+FWidgetPoolStats FWidgetPool::GetStats(UClass* Class) const
+{
+	FWidgetPoolStats Stats;
+	if (const FClassPool* Pool = Pools.Find(Class))
+	{
+		Stats = Pool->Stats;
+		Stats.Pooled = Pool->Free.Num();
+	}
+	return Stats;
+}
+
+FWidgetPoolStats FWidgetPool::GetTotalStats() const
+{
+	FWidgetPoolStats Total;
+	for (const auto& Pair : Pools)
+	{
+		Total.Hits += Pair.Value.Stats.Hits;
+		Total.Misses += Pair.Value.Stats.Misses;
+		Total.Released += Pair.Value.Stats.Released;
+		Total.Discarded += Pair.Value.Stats.Discarded;
+		Total.Pooled += Pair.Value.Free.Num();
+	}
+	return Total;
+}
+
+void FWidgetPool::Empty()
+{
+	for (auto& Pair : Pools)
+	{
+		for (FPooledWidget& Pooled : Pair.Value.Free)
+		{
+			if (IsValid(Pooled.Widget) && !Pooled.bSlateReleased)
+			{
+				Pooled.Widget->ReleaseSlateResources(true);
+			}
+		}
+		Pair.Value.Free.Empty();
+	}
+}
+
+void FWidgetPool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (auto& Pair : Pools)
+	{
+		for (FPooledWidget& Pooled : Pair.Value.Free)
+		{
+			Collector.AddReferencedObject(Pooled.Widget);
+		}
+	}
+}
+
+UWidget* UWidgetPoolLibrary::AcquireWidget(UWidgetTree* Outer, UClass* Class)
+{
+	return FWidgetPool::Get().Acquire(Outer, Class);
+}
+
+bool UWidgetPoolLibrary::ReleaseWidget(UWidget* Widget)
+{
+	return FWidgetPool::Get().Release(Widget);
+}
+
+void UWidgetPoolLibrary::SetPoolCapacity(UClass* Class, int32 Capacity)
+{
+	FWidgetPool::Get().SetCapacity(Class, Capacity);
+}
+
+FWidgetPoolStats UWidgetPoolLibrary::GetPoolStats(UClass* Class)
+{
+	return Class ? FWidgetPool::Get().GetStats(Class) : FWidgetPool::Get().GetTotalStats();
+}
+
+void UWidgetPoolLibrary::EmptyPool()
+{
+	FWidgetPool::Get().Empty();
+}
@@ -11,4 +11,8 @@ public:
 	
 	UPROPERTY(BlueprintType)
 	bool bIsUsingBridgeCaller;
+
+	// the widget tree already holds the prerendered widgets, attach to them instead of creating new ones
+	UPROPERTY(BlueprintType)
+	bool bHydrate;
 };
@@ -31,13 +31,30 @@ public:
 	~FJsEnvRuntime();
 
 	REACTORUMG_API TSharedPtr<PUERTS_NAMESPACE::FJsEnv> GetFreeJsEnv();
+
+	/**
+	 * get the env hosting the ui root identified by RootKey (usually its launch script),
+	 * a root seen for the first time is pinned to an idle or newly created env, or to the least loaded one
+	 * once ReactorUMG.MaxJsEnvs envs exist, so independent roots (hud, inventory, chat...) run in separate isolates.
+	 * the env is shared by all widgets of the root and by the other roots pinned to it, release it with ReleaseJsEnvForRoot
+	 */
+	REACTORUMG_API TSharedPtr<PUERTS_NAMESPACE::FJsEnv> AcquireJsEnvForRoot(const FString& RootKey);
 		
 	REACTORUMG_API bool StartJavaScript(const TSharedPtr<PUERTS_NAMESPACE::FJsEnv>& JsEnv, const FString& Script, const TArray<TPair<FString, UObject*>>& Arguments) const;
 
+	/** start the launch script of a root in the env got from AcquireJsEnvForRoot, other roots may have started there already */
+	REACTORUMG_API bool StartJavaScriptForRoot(const TSharedPtr<PUERTS_NAMESPACE::FJsEnv>& JsEnv, const FString& Script, const TArray<TPair<FString, UObject*>>& Arguments) const;
+
 	REACTORUMG_API bool CheckScriptLegal(const FString& Script) const;
 
 	REACTORUMG_API void ReleaseJsEnv(TSharedPtr<PUERTS_NAMESPACE::FJsEnv> JsEnv);
 
+	/**
+	 * release an env got from AcquireJsEnvForRoot, call it when the widget goes away.
+	 * the root is unpinned once its last widget is gone, the env is released once no root uses it anymore
+	 */
+	REACTORUMG_API void ReleaseJsEnvForRoot(const FString& RootKey, TSharedPtr<PUERTS_NAMESPACE::FJsEnv> JsEnv);
+
 	REACTORUMG_API void RebuildRuntimePool();
 
 	/**
@@ -46,9 +63,50 @@ public:
 	 */
 	REACTORUMG_API void RestartJsScripts(const FString& JSContentDir, const FString& ScriptHomeDir, const FString& MainJsScript, const TArray<TPair<FString, UObject*>>& Arguments);
 
+	/** log load and pinned roots of every env */
+	REACTORUMG_API void DumpJsEnvLoad(FOutputDevice& Ar);
+
+	/**
+	 * sample every env (and envs created meanwhile) with the v8 cpu profiler, works in packaged builds without the inspector
+	 * @param bFrameStats also report the hottest js functions of every frame to stats, csv and insights
+	 */
+	REACTORUMG_API void StartJsProfiling(int32 SamplingIntervalUs, bool bFrameStats, FOutputDevice& Ar);
+
+	/** write a .cpuprofile and a .folded stack summary per env to Saved/Profiling/ReactorUMG */
+	REACTORUMG_API void StopJsProfiling(FOutputDevice& Ar);
+
 private:
+	struct FJsEnvSlot
+	{
+		TSharedPtr<PUERTS_NAMESPACE::FJsEnv> Env;
+		// taken exclusively through GetFreeJsEnv
+		bool bBusy = false;
+		int32 PinnedRoots = 0;
+		// widgets of pinned roots currently holding the env
+		int32 RootUsers = 0;
+		int32 DebugPort = 0;
+		// script seconds spent per wall second, smoothed between samples
+		double ScriptLoad = 0;
+		double LastScriptSeconds = 0;
+		double LastSampleTime = 0;
+	};
+
+	struct FRootPin
+	{
+		int32 SlotIndex = INDEX_NONE;
+		int32 Users = 0;
+	};
+
 	FJsEnvRuntime(int32 EnvPoolSize = 1);
-	TMap<TSharedPtr<PUERTS_NAMESPACE::FJsEnv>, int32> JsRuntimeEnvPool;
+	int32 AddJsEnvSlot();
+	int32 SelectSlotForNewRoot();
+	double SampleEnvCost(FJsEnvSlot& Slot, PUERTS_NAMESPACE::FJsEnvLoadStats& OutStats);
+	TArray<FJsEnvSlot> EnvSlots;
+	// root key -> slot in EnvSlots and widgets holding it
+	TMap<FString, FRootPin> RootAffinity;
+	bool bJsProfiling = false;
+	int32 JsProfilingIntervalUs = 1000;
+	bool bJsProfilingFrameStats = false;
 	std::shared_ptr<FReactorUMGJSLogger> ReactorUmgLogger;
 	int32 EnvPoolSize;
 };
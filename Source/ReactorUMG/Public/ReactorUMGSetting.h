@@ -23,6 +23,34 @@ public:
 			"If the option is set, the system will automatically generate a TypeScript project. If not, you need to manually create a TS project, manually generate a type file, and set TsScriptProjectDir to a custom path."))
 	bool bAutoGenerateTSProject;
 
+	UPROPERTY(EditAnywhere, config,
+		Category = "ReactorUMG",
+		DisplayName = "Generate custom widget declarations",
+		meta = (ToolTip =
+			"If the option is set, ReactorUMG.GenDTS also writes the props of user defined widgets into reactorUMG/index.d.ts and components.js. Only the widgets changed since the last generation are regenerated and unchanged files are not rewritten."))
+	bool bGenerateCustomWidgetDeclaration;
+
+	UPROPERTY(EditAnywhere, config,
+		Category = "ReactorUMG",
+		DisplayName = "Prerender widget tree at compile time",
+		meta = (ToolTip =
+			"If the option is set, the widget tree rendered while compiling a ReactorUMG blueprint is kept in the class. At runtime the script can hydrate that tree instead of creating every widget again, as long as the launch script hashed when the scripts were packed is the one that rendered it. Requires a reconciler that hydrates; the bundled one still renders a new root that replaces the prerendered tree."))
+	bool bPrerenderWidgetTree;
+
+	UPROPERTY(EditAnywhere, config,
+		Category = "JavaScript Runtime",
+		DisplayName = "JS Heap Soft Limit (MB)",
+		meta = (ClampMin = "0", ToolTip =
+			"When the heap of a javascript env grows above this size, v8 is asked to collect incrementally. 0 disables it."))
+	int32 JsHeapSoftLimitMB;
+
+	UPROPERTY(EditAnywhere, config,
+		Category = "JavaScript Runtime",
+		DisplayName = "JS Heap Hard Limit (MB)",
+		meta = (ClampMin = "0", ToolTip =
+			"Max old generation size of each javascript env. Near it a full gc is run at the end of the frame. 0 keeps the v8 default. Takes effect for envs created afterwards."))
+	int32 JsHeapHardLimitMB;
+
 	virtual FName GetCategoryName() const override
 	{
 		return FName(TEXT("ReactorUMG"));
@@ -19,6 +19,29 @@ public:
 
 	static void CopyFile(const FString& SrcFile, const FString& DestFile);
 
+	/**
+	 * Incrementally mirror the files under SrcDir into DestDir. A manifest in Intermediate/ReactorUMG/Sync remembers
+	 * size, modification time and md5 of every synced file, so unchanged files only cost two stat calls
+	 * @param SrcDir Sync source directory
+	 * @param DestDir destination directory
+	 * @param Overrided If false, destination files that existed before the first sync or were modified after the last
+	 *					sync are kept, files written by a previous sync are still updated
+	 * @param Filter Return false to skip a file, receives the path relative to SrcDir
+	 * @return 
+	 */
+	static bool SyncDirectory(const FString& SrcDir, const FString& DestDir, bool Overrided,
+		TFunction<bool(const FString&)> Filter = nullptr);
+
+	/**
+	 * SyncDirectory on the thread pool. The first sync of a destination still runs inline because nothing is there yet
+	 */
+	static void SyncDirectoryAsync(const FString& SrcDir, const FString& DestDir, bool Overrided);
+
+	/**
+	 * Block until background syncs finished, call before reading the synced files
+	 */
+	static void WaitForPendingSyncs();
+
 	static void DeleteFile(const FString& FilePath);
 
 	static FString GetPluginContentDir();
@@ -49,5 +72,26 @@ public:
 
 	static FString GetGamePlayStartPoint();
 
+	/**
+	 * md5 of the compiled launch script under Content/JavaScript and of every module it requires, directly or not,
+	 * empty if the launch script does not exist
+	 * @param MainScriptPath Script path relative to the javascript root, without the .js suffix
+	 */
+	static FString GetLaunchScriptHash(const FString& MainScriptPath);
+
+	/**
+	 * launch script hash recorded in the manifest written when the scripts are packed, empty if the script is not listed.
+	 * packaged builds compare it instead of walking the module closure on the game thread
+	 */
+	static FString GetPackedLaunchScriptHash(const FString& MainScriptPath);
+
+#if WITH_EDITOR
+	/** list a launch script in the manifest, its hash is only filled in by RefreshLaunchScriptHashManifest */
+	static void AddLaunchScriptToHashManifest(const FString& MainScriptPath);
+
+	/** hash every launch script listed in the manifest, bound to FScriptArchive::OnPrePack */
+	static void RefreshLaunchScriptHashManifest();
+#endif
+
 	static bool IsAnyPIERunning();
 };
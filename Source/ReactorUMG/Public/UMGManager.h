@@ -83,6 +83,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Widget|ReactorUMG")
 	static void RemoveRootWidgetFromWidgetTree(UWidgetTree* Container, UWidget* Content);
 
+	/**
+	 * 控件树是否来自编译时预渲染的结果，是的话首次渲染应复用已有控件而不是新建
+	 * @param Container ReactorUIWidget 的控件树
+	 */
+	UFUNCTION(BlueprintCallable, Category="Widget|ReactorUMG")
+	static bool IsHydratingWidgetTree(UWidgetTree* Container);
+
+	/**
+	 * 按先序（父节点在前，子节点按插槽顺序）返回预渲染控件树中的全部控件，供 hydrate 时一次取出逐个对应
+	 */
+	UFUNCTION(BlueprintCallable, Category="Widget|ReactorUMG")
+	static TArray<UWidget*> GetPrerenderedWidgets(UWidgetTree* Container);
+
+	/**
+	 * hydrate 结束后调用，之后的渲染按正常流程创建控件
+	 */
+	UFUNCTION(BlueprintCallable, Category="Widget|ReactorUMG")
+	static void FinishHydration(UWidgetTree* Container);
+
 	UFUNCTION(BlueprintCallable, Category="Widget|ReactorUMG")
 	static FVector2D GetWidgetScreenPixelSize(UWidget* Widget, bool bReturnInLogicalViewportUnits = false);
 
@@ -0,0 +1,210 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 THL A29 Limited, a Tencent company.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "WidgetHandleTable.generated.h"
+
+class UWidget;
+class UWidgetTree;
+class UWorld;
+
+/**
+ * 控件句柄表：reconciler 持有的是 int32 句柄而不是 UObject 的 js 包装对象，
+ * 句柄 = 槽位下标(低 20 位) | 代数(高 11 位)，槽位释放后代数加一，过期句柄会被拒绝。
+ * 新建或被移出父节点的控件由句柄表强引用，挂到控件树上之后只保留弱引用，生命周期交给控件树。
+ */
+class REACTORUMG_API FWidgetHandleTable : public FGCObject
+{
+public:
+	static FWidgetHandleTable& Get();
+
+	int32 Register(UObject* Object, bool bPin);
+
+	UObject* Resolve(int32 Handle) const;
+
+	void Release(int32 Handle);
+
+	// 释放对象当前的句柄（如果有），控件回收进池时调用
+	void ReleaseObject(const UObject* Object);
+
+	void Pin(int32 Handle, bool bPin);
+
+	int32 ResolvePropertyId(int32 Handle, const FString& PropertyName);
+
+	// 校验属性 id 属于句柄所指对象的类，返回属性及其在对象里的地址
+	FProperty* ResolveProperty(int32 Handle, int32 PropertyId, UObject*& OutObject, void*& OutValuePtr) const;
+
+	int32 GetLiveHandleNum() const { return LiveHandles; }
+
+	// 释放全部句柄，脚本环境销毁时调用，句柄都是由这些环境创建的
+	void ReleaseAll();
+
+	// 模块加载时调用，关卡清理时释放属于该关卡的句柄
+	void Startup();
+
+	void Shutdown();
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+	virtual FString GetReferencerName() const override { return TEXT("FWidgetHandleTable"); }
+
+private:
+	struct FSlot
+	{
+		TWeakObjectPtr<UObject> Object;
+		uint32 Generation = 1;
+		bool bUsed = false;
+	};
+
+	struct FPropertyEntry
+	{
+		TWeakObjectPtr<UStruct> Owner;
+		FProperty* Property = nullptr;
+	};
+
+	static constexpr uint32 IndexBits = 20;
+
+	static constexpr uint32 IndexMask = (1u << IndexBits) - 1;
+
+	static constexpr uint32 GenerationMask = (1u << (31 - IndexBits)) - 1;
+
+	static int32 MakeHandle(uint32 Index, uint32 Generation)
+	{
+		return (int32) ((Generation << IndexBits) | Index);
+	}
+
+	const FSlot* FindSlot(int32 Handle) const;
+
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	TArray<FSlot> Slots;
+
+	TArray<uint32> FreeSlots;
+
+	// 同一个对象重复注册时返回同一个句柄，取出时要校验弱引用仍指向该对象
+	TMap<const UObject*, int32> ObjectToHandle;
+
+	TSet<UObject*> PinnedObjects;
+
+	TArray<FPropertyEntry> Properties;
+
+	TMap<TPair<const UStruct*, FName>, int32> PropertyIds;
+
+	int32 LiveHandles = 0;
+
+	FDelegateHandle WorldCleanupHandle;
+};
+
+/**
+ * 以句柄操作控件的接口，供 reconciler 管理成千上万个宿主节点时使用，避免为每个控件和插槽创建 js 包装对象。
+ * 需要真正的 UObject 时再调用 GetObject 取出。
+ */
+UCLASS()
+class REACTORUMG_API UWidgetHandleLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+public:
+	/**
+	 * 创建控件并返回句柄，优先复用控件池中的控件，控件在挂到父节点之前由句柄表保持存活
+	 * @param Outer 控件树
+	 * @param Class 控件类，UUserWidget 子类走 CreateWidget
+	 * @return 句柄，失败返回 0
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static int32 CreateWidget(UWidgetTree* Outer, UClass* Class);
+
+	UFUNCTION(BlueprintCallable, Category = "Widget|ReactorUMG|Handle")
+	static int32 GetHandle(UObject* Object);
+
+	UFUNCTION(BlueprintCallable, Category = "Widget|ReactorUMG|Handle")
+	static UObject* GetObject(int32 Handle);
+
+	UFUNCTION(BlueprintCallable, Category = "Widget|ReactorUMG|Handle")
+	static bool IsValidHandle(int32 Handle);
+
+	/**
+	 * 释放句柄，之后用这个句柄的调用都会失败；控件本身仍由控件树决定是否存活
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Widget|ReactorUMG|Handle")
+	static void ReleaseHandle(int32 Handle);
+
+	/**
+	 * 卸载控件：释放句柄并把控件连同子控件还回控件池，见 UWidgetPoolLibrary
+	 * @return 控件是否进池
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static bool ReleaseWidget(int32 Handle);
+
+	/**
+	 * @return 子控件插槽的句柄，失败返回 0
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static int32 AddChild(int32 Parent, int32 Child);
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static int32 InsertChildAt(int32 Parent, int32 Index, int32 Child);
+
+	/**
+	 * 移出后的子控件重新由句柄表持有，直到再次挂载或释放句柄；原插槽的句柄随之释放
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static bool RemoveChild(int32 Parent, int32 Child);
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static int32 GetSlot(int32 Widget);
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static void SetRootWidget(UWidgetTree* Container, int32 Root);
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static void RemoveRootWidget(UWidgetTree* Container, int32 Root);
+
+	/**
+	 * 按句柄所指对象的类解析属性，返回的 id 可以缓存下来给同类对象反复使用
+	 * @return 属性 id，找不到返回 0
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Widget|ReactorUMG|Handle")
+	static int32 GetPropertyId(int32 Handle, const FString& PropertyName);
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static bool SetBoolProperty(int32 Handle, int32 PropertyId, bool Value);
+
+	/**
+	 * 整数、浮点、枚举属性都用这个接口
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static bool SetNumberProperty(int32 Handle, int32 PropertyId, double Value);
+
+	/**
+	 * FString、FName、FText 属性
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static bool SetStringProperty(int32 Handle, int32 PropertyId, const FString& Value);
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static bool SetObjectProperty(int32 Handle, int32 PropertyId, UObject* Value);
+
+	/**
+	 * 结构体等其他属性用 UE 的导出文本格式设置，例如 "(R=1,G=0,B=0,A=1)"
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static bool SetPropertyFromText(int32 Handle, int32 PropertyId, const FString& Value);
+
+	/**
+	 * 控件或插槽的属性批量设置完之后调用一次，把属性同步到 Slate
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Handle")
+	static void SynchronizeProperties(int32 Handle);
+
+	UFUNCTION(BlueprintCallable, Category = "Widget|ReactorUMG|Handle")
+	static int32 GetLiveHandleNum();
+};
@@ -0,0 +1,157 @@
+/*
+ * Tencent is pleased to support the open source community by making Puerts available.
+ * Copyright (C) 2020 THL A29 Limited, a Tencent company.  All rights reserved.
+ * Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may
+ * be subject to their corresponding license terms. This file is subject to the terms and conditions defined in file 'LICENSE',
+ * which is part of this source code package.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/GCObject.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "WidgetPool.generated.h"
+
+class UWidget;
+class UWidgetTree;
+class UWorld;
+
+USTRUCT(BlueprintType)
+struct REACTORUMG_API FWidgetPoolStats
+{
+	GENERATED_BODY()
+
+	// 从池中取到控件的次数
+	UPROPERTY(BlueprintReadOnly, Category = "Widget|ReactorUMG|Pool")
+	int32 Hits = 0;
+
+	// 池为空、新建控件的次数
+	UPROPERTY(BlueprintReadOnly, Category = "Widget|ReactorUMG|Pool")
+	int32 Misses = 0;
+
+	// 回收进池的次数
+	UPROPERTY(BlueprintReadOnly, Category = "Widget|ReactorUMG|Pool")
+	int32 Released = 0;
+
+	// 池已满、交给 GC 的次数
+	UPROPERTY(BlueprintReadOnly, Category = "Widget|ReactorUMG|Pool")
+	int32 Discarded = 0;
+
+	// 当前池中的控件数
+	UPROPERTY(BlueprintReadOnly, Category = "Widget|ReactorUMG|Pool")
+	int32 Pooled = 0;
+};
+
+/**
+ * 按类缓存卸载下来的控件：虚拟列表滚动时 React 会反复挂载、卸载同样的宿主组件，
+ * 复用控件可以省掉 UObject 和 Slate 控件的创建与 GC。
+ * 回收时控件从父节点移除，属性恢复为 CDO 默认值，Slate 控件先保留，闲置一段时间后才释放。
+ * UUserWidget 自带控件树和脚本状态，不进池。
+ */
+class REACTORUMG_API FWidgetPool : public FGCObject
+{
+public:
+	static FWidgetPool& Get();
+
+	UWidget* Acquire(UWidgetTree* Outer, UClass* Class);
+
+	// 子控件一并回收，返回 false 表示控件没有进池，已经脱离父节点交给 GC
+	bool Release(UWidget* Widget);
+
+	// 小于 0 表示使用 ReactorUMG.WidgetPoolCapacity，0 表示不缓存这个类
+	void SetCapacity(UClass* Class, int32 Capacity);
+
+	FWidgetPoolStats GetStats(UClass* Class) const;
+
+	FWidgetPoolStats GetTotalStats() const;
+
+	void Empty();
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+	virtual FString GetReferencerName() const override { return TEXT("FWidgetPool"); }
+
+	// 模块加载时调用，关卡清理时丢掉属于该关卡的控件，GC 前丢掉蓝图重编译后过期的类
+	void Startup();
+
+	// 模块卸载时调用，停掉延迟释放 Slate 资源的 ticker
+	void Shutdown();
+
+private:
+	struct FPooledWidget
+	{
+		TObjectPtr<UWidget> Widget;
+		double ReleaseTime = 0.0;
+		bool bSlateReleased = false;
+	};
+
+	struct FClassPool
+	{
+		TArray<FPooledWidget> Free;
+		int32 Capacity = INDEX_NONE;
+		FWidgetPoolStats Stats;
+	};
+
+	bool IsPoolable(UClass* Class) const;
+
+	int32 GetCapacity(const FClassPool& Pool) const;
+
+	bool Tick(float DeltaTime);
+
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	void PurgeStaleClasses();
+
+	static void ResetToDefaults(UWidget* Widget);
+
+	TMap<TWeakObjectPtr<UClass>, FClassPool> Pools;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	FDelegateHandle WorldCleanupHandle;
+
+	FDelegateHandle PreGarbageCollectHandle;
+};
+
+/**
+ * 控件池接口，reconciler 的 createInstance 用 AcquireWidget 代替直接创建控件，
+ * 卸载宿主节点时用 ReleaseWidget 把控件还回池中
+ */
+UCLASS()
+class REACTORUMG_API UWidgetPoolLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+public:
+	/**
+	 * 从池中取一个控件，池为空时新建
+	 * @param Outer 控件树
+	 * @param Class 控件类，UUserWidget 子类总是新建
+	 * @return 控件，调用方需要重新设置全部属性
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Pool")
+	static UWidget* AcquireWidget(UWidgetTree* Outer, UClass* Class);
+
+	/**
+	 * 把卸载的控件还回池中，控件及其子控件都会从父节点移除，之后不能再使用
+	 * @return 是否进池
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Widget|ReactorUMG|Pool")
+	static bool ReleaseWidget(UWidget* Widget);
+
+	/**
+	 * @param Capacity 池中最多保留的控件数，小于 0 恢复为 ReactorUMG.WidgetPoolCapacity，0 关闭这个类的缓存
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Widget|ReactorUMG|Pool")
+	static void SetPoolCapacity(UClass* Class, int32 Capacity);
+
+	/**
+	 * @param Class 为空时返回所有类的合计
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Widget|ReactorUMG|Pool")
+	static FWidgetPoolStats GetPoolStats(UClass* Class);
+
+	UFUNCTION(BlueprintCallable, Category = "Widget|ReactorUMG|Pool")
+	static void EmptyPool();
+};
@@ -38,6 +38,7 @@ public class ReactorUMG : ModuleRules
 				"CoreUObject",
 				"UMG",
 				"Engine",
+				"AssetRegistry",
 				"Slate",
 				"SlateCore",
 				"InputCore",
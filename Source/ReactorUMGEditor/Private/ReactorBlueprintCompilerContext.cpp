@@ -3,6 +3,8 @@
 #include "ReactorUMGWidgetBlueprint.h"
 #include "ReactorUMGBlueprintGeneratedClass.h"
 #include "ReactorUMGUtilityWidgetBlueprint.h"
+#include "ReactorUMGSetting.h"
+#include "ReactorUtils.h"
 #include "Blueprint/WidgetTree.h"
 #include "Kismet2/KismetReinstanceUtilities.h"
 
@@ -80,6 +82,18 @@ void FReactorUMGBlueprintCompilerContext::FinishCompilingClass(UClass *Class)
 			BPGClass->TsScriptHomeFullDir = WidgetBlueprint->GetTsScriptHomeFullDir();
 			BPGClass->TsScriptHomeRelativeDir = WidgetBlueprint->GetTsScriptHomeRelativeDir();
 			BPGClass->WidgetName = WidgetBlueprint->GetWidgetName();
+			BPGClass->ScriptStartMode = WidgetBlueprint->ScriptStartMode;
+			// 编译时脚本已经把控件树渲染到 WidgetTree，父类会把它拷进类的 archetype，
+			// 记下脚本的 hash，运行时脚本未变化才直接复用这棵树
+			const bool bPrerender = GetDefault<UReactorUMGSetting>()->bPrerenderWidgetTree &&
+				WidgetBlueprint->WidgetTree && WidgetBlueprint->WidgetTree->RootWidget;
+			BPGClass->PrerenderedScriptHash = bPrerender ? FReactorUtils::GetLaunchScriptHash(BPGClass->MainScriptPath) : FString();
+			if (bPrerender)
+			{
+				// 打包时才计算清单里的 hash，运行时只比较字符串
+				FReactorUtils::AddLaunchScriptToHashManifest(BPGClass->MainScriptPath);
+				MessageLog.Warning(TEXT("Prerender widget tree is enabled, but the bundled reconciler does not hydrate yet: it renders a new root that replaces the prerendered tree on the first render."));
+			}
 		}
 	}
 
@@ -111,6 +125,8 @@ void FReactorUMGBlueprintCompilerContext::FinishCompilingClass(UClass *Class)
 			BPGClass->TsScriptHomeFullDir = UtilityWidgetBlueprint->GetTsScriptHomeFullDir();
 			BPGClass->TsScriptHomeRelativeDir = UtilityWidgetBlueprint->GetTsScriptHomeRelativeDir();
 			BPGClass->WidgetName = UtilityWidgetBlueprint->GetWidgetName();
+			BPGClass->PrerenderedScriptHash.Reset();
+			BPGClass->ScriptStartMode = EReactorScriptStartMode::Immediate;
 		}
 	}
 
@@ -238,6 +238,20 @@ void UReactorUMGCommonBP::ReportToMessageLog(const FString& Message)
 	TSCompileErrorMessageBuffer.Append(Message + TEXT("\n"));
 }
 
+void UReactorUMGCommonBP::ReportNoteToMessageLog(const FString& Message)
+{
+	UE_LOG(LogReactorUMG, Log, TEXT("%s"), *Message)
+	TSCompileNoteMessageBuffer.Append(Message + TEXT("\n"));
+}
+
+TArray<FString> UReactorUMGCommonBP::ConsumeChangedTsFiles()
+{
+	TArray<FString> Result = ChangedTsFiles.Array();
+	ChangedTsFiles.Empty();
+	bTsChangeListComplete = TsProjectMonitor.IsWatching();
+	return Result;
+}
+
 void UReactorUMGCommonBP::SetupTsScripts(const FReactorUMGCompilerLog& CompilerResultsLogger, bool bForceCompile, bool bForceReload)
 {
 	FScopedSlowTask SlowTask(2);
@@ -253,21 +267,18 @@ void UReactorUMGCommonBP::SetupTsScripts(const FReactorUMGCompilerLog& CompilerR
 		}
 	}
 
-	
-	// Initial sync: copy all non-ts/tsx files under TsScriptHomeFullDir to destination
+	if (!CompileErrorReporter->CompileNoteDelegate.IsBound())
 	{
-		TArray<FString> AllFiles;
-		IFileManager::Get().FindFilesRecursive(AllFiles, *TsScriptHomeFullDir, TEXT("*"), true, false, false);
-		for (const FString& SrcPath : AllFiles)
-		{
-			if (SrcPath.EndsWith(TEXT(".ts")) || SrcPath.EndsWith(TEXT(".tsx")))
-			{
-				continue;
-			}
-			const FString DestPath = GetDestFilePath(SrcPath);
-			FReactorUtils::CopyFile(SrcPath, DestPath);
-		}
+		CompileErrorReporter->CompileNoteDelegate.BindDynamic(this, &UReactorUMGCommonBP::ReportNoteToMessageLog);
 	}
+
+	
+	// Initial sync: copy non-ts/tsx files under TsScriptHomeFullDir that changed since the last compile
+	FReactorUtils::SyncDirectory(TsScriptHomeFullDir, FPaths::Combine(JSScriptContentDir, TsScriptHomeRelativeDir), true,
+		[](const FString& RelativePath)
+		{
+			return !RelativePath.EndsWith(TEXT(".ts")) && !RelativePath.EndsWith(TEXT(".tsx"));
+		});
 	
 	if (CheckLaunchJsScriptExist())
 	{
@@ -299,6 +310,12 @@ void UReactorUMGCommonBP::SetupTsScripts(const FReactorUMGCompilerLog& CompilerR
 		CompilerResultsLogger.Error(FText::FromString(TSCompileErrorMessageBuffer));
 		TSCompileErrorMessageBuffer.Empty();
 	}
+
+	if (!TSCompileNoteMessageBuffer.IsEmpty())
+	{
+		CompilerResultsLogger.Note(FText::FromString(TSCompileNoteMessageBuffer));
+		TSCompileNoteMessageBuffer.Empty();
+	}
 }
 
 
@@ -425,6 +442,8 @@ void UReactorUMGCommonBP::StartTsScriptsMonitor(TFunction<void()>&& Callback)
 		return SourceFilePath;
 	};
 
+	// 监听开始之前的改动没有记录，下次编译仍要全量检查时间戳
+	bTsChangeListComplete = false;
 	TsProjectMonitor.Watch(TsScriptHomeFullDir);
 	TsMonitorDelegateHandle = TsProjectMonitor.OnDirectoryChanged().AddLambda([this, GetDestFilePath, CallbackTemp = MoveTemp(Callback)](
 			const TArray<FString>& Added, const TArray<FString>& Modified, const TArray<FString>& Removed
@@ -437,6 +456,20 @@ void UReactorUMGCommonBP::StartTsScriptsMonitor(TFunction<void()>&& Callback)
 
 			CallbackTemp();
 
+			auto RecordTsChanges = [this](const TArray<FString>& Files)
+			{
+				for (const auto& File : Files)
+				{
+					if (File.EndsWith(TEXT(".ts")) || File.EndsWith(TEXT(".tsx")))
+					{
+						ChangedTsFiles.Add(File);
+					}
+				}
+			};
+			RecordTsChanges(Added);
+			RecordTsChanges(Modified);
+			RecordTsChanges(Removed);
+
 			for (const auto& AddFile : Added)
 			{
 				if (!(AddFile.EndsWith(TEXT(".ts")) ||
@@ -29,6 +29,8 @@ public:
 
 	void Watch(const FString& InDirectory);
 	void UnWatch();
+
+	bool IsWatching() const { return bIsWatching; }
 	
 private:
 	FDelegateHandle DelegateHandle;
@@ -47,6 +49,10 @@ class UCompileErrorReport : public UObject
 public:
 	UPROPERTY(BlueprintType)
 	FCompileReportDelegate CompileReportDelegate;
+
+	// 编译耗时等提示信息，输出到编译日志但不算作错误
+	UPROPERTY(BlueprintType)
+	FCompileReportDelegate CompileNoteDelegate;
 };
 
 /**
@@ -69,6 +75,21 @@ public:
 
 	UFUNCTION(Blueprintable, Category="ReactorUMGEditor|WidgetBlueprint")
 	void ReportToMessageLog(const FString& Message);
+
+	UFUNCTION(Blueprintable, Category="ReactorUMGEditor|WidgetBlueprint")
+	void ReportNoteToMessageLog(const FString& Message);
+
+	/**
+	 * 取出目录监听记录的 ts/tsx 变更文件并清空，供增量编译服务只重新检查这些文件
+	 */
+	UFUNCTION(BlueprintCallable, Category="ReactorUMGEditor|WidgetBlueprint")
+	TArray<FString> ConsumeChangedTsFiles();
+
+	/**
+	 * 上次取出变更后目录监听是否一直在运行，不是的话变更列表不完整，编译服务需要按时间戳检查所有文件
+	 */
+	UFUNCTION(BlueprintCallable, Category="ReactorUMGEditor|WidgetBlueprint")
+	bool IsTsChangeListComplete() const { return bTsChangeListComplete; }
 	
 	FORCEINLINE FString GetWidgetName() { return WidgetName; }
 
@@ -108,6 +129,7 @@ public:
 	{
 		TsProjectMonitor.UnWatch();
 		TsProjectMonitor.OnDirectoryChanged().Remove(TsMonitorDelegateHandle);
+		bTsChangeListComplete = false;
 	}
 	
 	UPROPERTY(BlueprintType, VisibleAnywhere, Category="ReactorUMGEditor|WidgetBlueprint")
@@ -134,5 +156,8 @@ private:
 	TSharedPtr<puerts::FJsEnv> JsEnv;
 	FDelegateHandle TsMonitorDelegateHandle;
 	FString TSCompileErrorMessageBuffer;
+	FString TSCompileNoteMessageBuffer;
+	TSet<FString> ChangedTsFiles;
+	bool bTsChangeListComplete = false;
 	bool bTsScriptsChanged;
 };
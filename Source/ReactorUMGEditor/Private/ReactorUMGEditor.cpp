@@ -15,6 +15,7 @@
 #include "AssetDefinition_ReactorUMGUtilityBlueprint.h"
 #include "ReactorUMGSetting.h"
 #include "ReactorUMGUtilityWidgetBlueprint.h"
+#include "WidgetDeclarationGenerator.h"
 
 #define LOCTEXT_NAMESPACE "FReactorUMGEditorModule"
 
@@ -31,35 +32,6 @@ void ShowGeneratedDialog(const FString& OutDir)
 }
 
 
-TArray<UObject*> GetSortedClasses(bool GenStruct = false, bool GenEnum = false)
-{
-	TArray<UObject*> SortedClasses;
-	for (TObjectIterator<UClass> It; It; ++It)
-	{
-		SortedClasses.Add(*It);
-	}
-
-	if (GenStruct)
-	{
-		for (TObjectIterator<UScriptStruct> It; It; ++It)
-		{
-			SortedClasses.Add(*It);
-		}
-	}
-
-	if (GenEnum)
-	{
-		for (TObjectIterator<UEnum> It; It; ++It)
-		{
-			SortedClasses.Add(*It);
-		}
-	}
-
-	SortedClasses.Sort([&](const UObject& ClassA, const UObject& ClassB) -> bool { return ClassA.GetName() < ClassB.GetName(); });
-
-	return SortedClasses;
-}
-
 void GenerateUEDeclaration(const FName& SearchPath, bool GenFull)
 {
 	const FString TypesHomeDir = FPaths::Combine(FReactorUtils::GetTypeScriptHomeDir(), TEXT("src"), TEXT("types"));
@@ -67,19 +39,25 @@ void GenerateUEDeclaration(const FName& SearchPath, bool GenFull)
 	
 	FTypeScriptDeclarationGenerator Generator;
 	Generator.OutDir = TypesHomeDir;
+	Generator.UseFragmentCache = !GenFull;
 	Generator.RestoreBlueprintTypeDeclInfos(GenFull);
 	Generator.LoadAllWidgetBlueprint(SearchPath, GenFull);
 	Generator.GenTypeScriptDeclaration(true, true);
 
-	TArray<UObject*> SortedClasses(GetSortedClasses());
-	for (int i = 0; i < SortedClasses.Num(); ++i)
+	// only a handful of classes are code generators, filter before sorting by name
+	TArray<UClass*> CodeGenerators;
+	for (TObjectIterator<UClass> It; It; ++It)
 	{
-		UClass* Class = Cast<UClass>(SortedClasses[i]);
-		if (Class && Class->ImplementsInterface(UCodeGenerator::StaticClass()))
+		if (It->ImplementsInterface(UCodeGenerator::StaticClass()))
 		{
-			ICodeGenerator::Execute_Gen(Class->GetDefaultObject(), TypesHomeDir);
+			CodeGenerators.Add(*It);
 		}
 	}
+	CodeGenerators.Sort([](const UClass& ClassA, const UClass& ClassB) -> bool { return ClassA.GetName() < ClassB.GetName(); });
+	for (UClass* Class : CodeGenerators)
+	{
+		ICodeGenerator::Execute_Gen(Class->GetDefaultObject(), TypesHomeDir);
+	}
 }
 
 TUniquePtr<FAutoConsoleCommand> RegisterConsoleCommand()
@@ -128,8 +106,8 @@ void CopyPredefinedTSProject()
 		const FString TSProjectDir = FReactorUtils::GetTypeScriptHomeDir();
 		if (!FPaths::DirectoryExists(TSProjectDir))
 		{
-			FReactorUtils::CreateDirectoryRecursive(TSProjectDir);
-			FReactorUtils::CopyDirectoryTree(PredefineDir, TSProjectDir, false);
+			// the project is edited by the user, never link it to the plugin template
+			FReactorUtils::SyncDirectory(PredefineDir, TSProjectDir, false);
 		} else
 		{
 			// only copy reactor umg lib
@@ -150,9 +128,10 @@ void CopyPredefinedSystemJSFiles()
 	if (FPaths::DirectoryExists(SysJSFileDir))
 	{
 		const FString DestDir = FPaths::Combine(FPaths::ProjectContentDir(), TEXT("JavaScript"));
-		FReactorUtils::CreateDirectoryRecursive(DestDir);
-
-		FReactorUtils::CopyDirectoryTree(SysJSFileDir, DestDir, false);
+		// only changed files are copied, in the background unless this is the first sync;
+		// js envs wait for it before loading anything from Content/JavaScript.
+		// no hard links, a link would let edits in Content/JavaScript write through into the plugin
+		FReactorUtils::SyncDirectoryAsync(SysJSFileDir, DestDir, false);
 	}
 }
 
@@ -250,7 +229,8 @@ void FReactorUMGEditorModule::StartupModule()
 
 void FReactorUMGEditorModule::ShutdownModule()
 {
-    
+	FReactWidgetDeclarationIndex::Shutdown();
+	FReactorUtils::WaitForPendingSyncs();
 }
 
 #undef LOCTEXT_NAMESPACE
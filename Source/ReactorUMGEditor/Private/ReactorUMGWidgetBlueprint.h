@@ -2,6 +2,7 @@
 #include "CoreMinimal.h"
 #include "WidgetBlueprint.h"
 #include "ReactorUMGCommonBP.h"
+#include "ReactorUMGBlueprintGeneratedClass.h"
 #include "ReactorUMGWidgetBlueprint.generated.h"
 
 UCLASS(BlueprintType, meta = (ShowWorldContextPin), config = Editor)
@@ -16,6 +17,13 @@ public:
 	void SetupMonitorForTsScripts();
 	void SetupTsScripts(const FReactorUMGCompilerLog& CompilerResultsLogger, bool bForceCompile = false, bool bForceReload = false);
 
+	/**
+	 * 脚本的启动时机：常驻但默认隐藏的界面（暂停菜单、背包、地图）可以延迟到首次显示再运行脚本，
+	 * 避免在关卡加载时付出全部脚本开销
+	 */
+	UPROPERTY(EditAnywhere, AssetRegistrySearchable, Category="ReactorUMG")
+	EReactorScriptStartMode ScriptStartMode = EReactorScriptStartMode::Immediate;
+
 	UFUNCTION(BlueprintCallable, Category="ReactorUMGEditor|UMGBlueprint")
 	void ForceDeleteAssets(const TArray<UObject*>& InAssetsToDelete);
 
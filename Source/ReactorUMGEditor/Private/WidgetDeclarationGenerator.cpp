@@ -6,6 +6,11 @@
 #include "Components/ContentWidget.h"
 #include "Components/PanelWidget.h"
 #include "Components/Widget.h"
+#include "ReactorUMGSetting.h"
+#include "Editor.h"
+#include "Engine/Blueprint.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "UObject/UObjectHash.h"
 
 static FString SafeName(const FString& Name, bool firstCharLower = false)
 {
@@ -81,7 +86,8 @@ static bool IsPanelWidget(UWidget* CheckWidget)
 	return PanelWidget == nullptr;
 }
 
-static void InsertTextAtSecondLastLine(const FString& SourcePath, const FString& OutPath, const FString& TextToInsert)
+// returns false when the output already has the same content, rewriting it would wake up the tsc watcher and webpack for nothing
+static bool InsertTextAtSecondLastLine(const FString& SourcePath, const FString& OutPath, const FString& TextToInsert)
 {
 	TArray<FString> Lines;
 	if (FFileHelper::LoadFileToStringArray(Lines, *SourcePath))
@@ -97,22 +103,66 @@ static void InsertTextAtSecondLastLine(const FString& SourcePath, const FString&
 		{
 			Lines.Insert(TextToInsert, LastNonEmptyIndex - 1);
 
+			FString Content;
+			for (const FString& Line : Lines)
+			{
+				Content += Line;
+				Content += LINE_TERMINATOR;
+			}
+
+			FString OldContent;
+			if (FFileHelper::LoadFileToString(OldContent, *OutPath) && OldContent.Equals(Content, ESearchCase::CaseSensitive))
+			{
+				return false;
+			}
+
 			const FString BaseOutDir = FPaths::GetPath(OutPath);
 			if (!FPaths::DirectoryExists(*BaseOutDir))
 			{
 				FReactorUtils::CreateDirectoryRecursive(BaseOutDir);
 			}
 			
-			FFileHelper::SaveStringArrayToFile(Lines, *OutPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+			return FFileHelper::SaveStringToFile(Content, *OutPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
 		}
 	}
+	return false;
+}
+
+/* The following widgets are skipped when generating custom widget declarations */
+static const TArray<FString> PredefinedWidgets = {
+	TEXT("Widget"), TEXT("PanelWidget"), TEXT("ContentWidget"), TEXT("ReactorUIWidget"),
+	TEXT("Border"), TEXT("Button"), TEXT("CanvasPanel"), TEXT("CheckBox"), TEXT("CircularThrobber"),
+	TEXT("ComboBox"), TEXT("ExpandableArea"), TEXT("ListView"), TEXT("Overlay"), TEXT("ProgressBar"),
+	TEXT("GridPanel"), TEXT("HorizontalBox"), TEXT("Image"), TEXT("InvalidationBox"), TEXT("ListViewBase"),
+	TEXT("RetainerBox"), TEXT("RichTextBlock"), TEXT("ScaleBox"), TEXT("ScrollBox"),
+	TEXT("SizeBox"), TEXT("Slider"), TEXT("ScaleBox"), TEXT("SpinBox"), TEXT("TextBlock"),
+	TEXT("Throbber"), TEXT("TileView"), TEXT("TreeView"), TEXT("UniformGridPanel"), TEXT("VerticalBox"),
+	TEXT("WrapBox"), TEXT("ReactorUIWidget"), TEXT("ReactRiveWidget"), TEXT("RiveWidget"),
+	TEXT("SpineWidget"), TEXT("SafeZone"), TEXT("Spacer"), TEXT("RadialSlider"), TEXT("Viewport")
+};
+
+static bool IsCustomWidgetClass(UClass* Class)
+{
+	if (!Class || Class->HasAnyClassFlags(CLASS_NewerVersionExists) || !Class->IsChildOf<UWidget>())
+	{
+		return false;
+	}
+	
+	const FString ClassName = SafeName(Class->GetName());
+	if (ClassName.StartsWith("SKEL_") || ClassName.StartsWith("REINST_") ||
+		ClassName.StartsWith("TRASHCLASS_") || ClassName.StartsWith("PLACEHOLDER_"))
+	{
+		return false;
+	}
+	return !PredefinedWidgets.Contains(ClassName);
 }
 
 struct FReactDeclarationGenerator : public FTypeScriptDeclarationGenerator
 {
 	void Begin(FString Namespace) override;
 
-	void GenReactDeclaration(const FString& ReactHomeDir);
+	// generates the interface block of one class, other widget classes it refers to are collected in Dependencies
+	void GenBlock(UClass* Class);
 
 	void GenClass(UClass* Class) override;
 
@@ -126,18 +176,9 @@ struct FReactDeclarationGenerator : public FTypeScriptDeclarationGenerator
 	{
 	}
 
-	/* The following widgets are skipped when generating custom widget declarations */
-	TArray<FString> PredefinedWidgets = {
-		TEXT("Widget"), TEXT("PanelWidget"), TEXT("ContentWidget"), TEXT("ReactorUIWidget"),
-		TEXT("Border"), TEXT("Button"), TEXT("CanvasPanel"), TEXT("CheckBox"), TEXT("CircularThrobber"),
-		TEXT("ComboBox"), TEXT("ExpandableArea"), TEXT("ListView"), TEXT("Overlay"), TEXT("ProgressBar"),
-		TEXT("GridPanel"), TEXT("HorizontalBox"), TEXT("Image"), TEXT("InvalidationBox"), TEXT("ListViewBase"),
-		TEXT("RetainerBox"), TEXT("RichTextBlock"), TEXT("ScaleBox"), TEXT("ScrollBox"),
-		TEXT("SizeBox"), TEXT("Slider"), TEXT("ScaleBox"), TEXT("SpinBox"), TEXT("TextBlock"),
-		TEXT("Throbber"), TEXT("TileView"), TEXT("TreeView"), TEXT("UniformGridPanel"), TEXT("VerticalBox"),
-		TEXT("WrapBox"), TEXT("ReactorUIWidget"), TEXT("ReactRiveWidget"), TEXT("RiveWidget"),
-		TEXT("SpineWidget"), TEXT("SafeZone"), TEXT("Spacer"), TEXT("RadialSlider"), TEXT("Viewport")
-	};
+	UClass* BlockClass = nullptr;
+
+	TArray<UClass*> Dependencies;
 };
 
 void FReactDeclarationGenerator::Begin(FString Namespace)
@@ -158,56 +199,24 @@ void FReactDeclarationGenerator::GenEnum(UEnum* Enum)
 {
 }
 
-void FReactDeclarationGenerator::GenReactDeclaration(const FString& ReactHomeDir)
+void FReactDeclarationGenerator::GenBlock(UClass* Class)
 {
-    FString Components = TEXT("exports.lazyloadComponents = {};\n");
-
-    Output << "\n/* Widget declaration generated from custom widgets user defined*/ \n\n";
-
-    for (TObjectIterator<UClass> It; It; ++It)
-    {
-        UClass* Class = *It;
-        checkfSlow(Class != nullptr, TEXT("Class name corruption!"));
-    	const FString SuperClassName = SafeName(Class->GetName());
-        if (SuperClassName.StartsWith("SKEL_") || SuperClassName.StartsWith("REINST_") ||
-            SuperClassName.StartsWith("TRASHCLASS_") || SuperClassName.StartsWith("PLACEHOLDER_"))
-        {
-            continue;
-        }
-    	
-        if (!PredefinedWidgets.Contains(SuperClassName) && Class->IsChildOf<UWidget>())
-        {
-            Gen(Class);
-            Components += "exports." + SafeName(Class->GetName()) + " = '" + SafeName(Class->GetName()) + "';\n";
-            if (!(Class->ClassFlags & CLASS_Native) && !SuperClassName.Equals(TEXT("ReactorUIWidget")))
-            {
-                Components += "exports.lazyloadComponents." + SafeName(Class->GetName()) + " = '" + Class->GetPathName() + "';\n";
-            }
-        }
-    }
-
-	const FString TemplateIndexFile = FPaths::Combine(FReactorUtils::GetPluginDir(), TEXT("Scripts/Project/src/types/reactorUMG/index.d.ts"));
-
-	const FString TSProjectDir = ReactHomeDir;
-	const FString OutDeclarationFile = TSProjectDir / TEXT("reactorUMG/index.d.ts");
-	if (FPaths::FileExists(*TemplateIndexFile))
-	{
-		InsertTextAtSecondLastLine(TemplateIndexFile, OutDeclarationFile, ToString());
-	}
-	
-	const FString TemplateComponentJSFile = FPaths::Combine(FReactorUtils::GetPluginDir(), TEXT("Scripts/Project/src/reactorUMG/components.js"));
-	const FString JSContentDir = FReactorUtils::GetTSCBuildOutDirFromTSConfig(FReactorUtils::GetTypeScriptHomeDir());
-	const FString OutComponentsFile = JSContentDir / TEXT("src/reactorUMG/components.js");
-	if (FPaths::FileExists(*TemplateComponentJSFile))
-	{
-		InsertTextAtSecondLastLine(TemplateComponentJSFile, OutComponentsFile, Components);
-	}
+	BlockClass = Class;
+	Gen(Class);
+	BlockClass = nullptr;
 }
 
 void FReactDeclarationGenerator::GenClass(UClass* Class)
 {
     if (!Class->IsChildOf<UWidget>())
         return;
+
+	// every custom widget class owns its block in the index, only remember the ones this block extends
+	if (BlockClass && Class != BlockClass)
+	{
+		Dependencies.AddUnique(Class);
+		return;
+	}
 	
     bool IsWidget = Class->IsChildOf<UWidget>();
 	bool IsPanelWidget = Class->IsChildOf<UPanelWidget>() || Class->IsChildOf<UContentWidget>();
@@ -327,9 +336,264 @@ void FReactDeclarationGenerator::GenClass(UClass* Class)
     Output << StringBuffer;
 }
 
+static TUniquePtr<FReactWidgetDeclarationIndex> WidgetDeclarationIndex;
+
+FReactWidgetDeclarationIndex& FReactWidgetDeclarationIndex::Get()
+{
+	if (!WidgetDeclarationIndex)
+	{
+		WidgetDeclarationIndex = MakeUnique<FReactWidgetDeclarationIndex>();
+	}
+	return *WidgetDeclarationIndex;
+}
+
+void FReactWidgetDeclarationIndex::Shutdown()
+{
+	WidgetDeclarationIndex.Reset();
+}
+
+FReactWidgetDeclarationIndex::~FReactWidgetDeclarationIndex()
+{
+	if (!bSubscribed)
+	{
+		return;
+	}
+	
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+	}
+	if (GEditor)
+	{
+		GEditor->OnBlueprintPreCompile().Remove(BlueprintPreCompileHandle);
+	}
+	FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+}
+
+void FReactWidgetDeclarationIndex::Subscribe()
+{
+	if (bSubscribed)
+	{
+		return;
+	}
+	bSubscribed = true;
+	
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FReactWidgetDeclarationIndex::MarkAssetDirty);
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FReactWidgetDeclarationIndex::MarkAssetDirty);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FReactWidgetDeclarationIndex::MarkAssetDirty);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddLambda([this](const FAssetData& AssetData, const FString& OldObjectPath)
+	{
+		MarkDirty(OldObjectPath + TEXT("_C"));
+		MarkAssetDirty(AssetData);
+	});
+	
+	if (GEditor)
+	{
+		BlueprintPreCompileHandle = GEditor->OnBlueprintPreCompile().AddRaw(this, &FReactWidgetDeclarationIndex::OnBlueprintPreCompile);
+	}
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FReactWidgetDeclarationIndex::OnModulesChanged);
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([this](EReloadCompleteReason Reason)
+	{
+		// live coding may change the layout of any native widget, rebuild everything
+		for (const TPair<FString, FEntry>& Pair : Entries)
+		{
+			DirtyPaths.Add(Pair.Key);
+		}
+		bNeedsScan = true;
+	});
+}
+
+void FReactWidgetDeclarationIndex::MarkDirty(const FString& ClassPath)
+{
+	if (!ClassPath.IsEmpty())
+	{
+		DirtyPaths.Add(ClassPath);
+	}
+}
+
+void FReactWidgetDeclarationIndex::MarkAssetDirty(const FAssetData& AssetData)
+{
+	// only blueprints carry a generated class, the class is checked to be a widget when the block is regenerated
+	FString GeneratedClassPath;
+	if (AssetData.GetTagValue(FBlueprintTags::GeneratedClassPath, GeneratedClassPath))
+	{
+		MarkDirty(FPackageName::ExportTextPathToObjectPath(GeneratedClassPath));
+	}
+}
+
+void FReactWidgetDeclarationIndex::OnBlueprintPreCompile(UBlueprint* Blueprint)
+{
+	if (Blueprint && Blueprint->GeneratedClass)
+	{
+		MarkDirty(Blueprint->GeneratedClass->GetPathName());
+	}
+}
+
+void FReactWidgetDeclarationIndex::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	if (Reason == EModuleChangeReason::ModuleLoaded)
+	{
+		bNeedsScan = true;
+	}
+}
+
+void FReactWidgetDeclarationIndex::RemoveEntry(const FString& ClassPath)
+{
+	if (Entries.Remove(ClassPath) == 0)
+	{
+		return;
+	}
+	bOutputDirty = true;
+	
+	// subclasses extend the removed props interface, let them pick their new super
+	for (const TPair<FString, FEntry>& Pair : Entries)
+	{
+		if (Pair.Value.SuperPath == ClassPath)
+		{
+			DirtyPaths.Add(Pair.Key);
+		}
+	}
+}
+
+void FReactWidgetDeclarationIndex::Generate(const FString& ReactHomeDir)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	Subscribe();
+
+	if (bNeedsScan)
+	{
+		bNeedsScan = false;
+		// walks the class tree below UWidget instead of every UClass in memory
+		TArray<UClass*> WidgetClasses;
+		GetDerivedClasses(UWidget::StaticClass(), WidgetClasses, true);
+		for (UClass* Class : WidgetClasses)
+		{
+			if (IsCustomWidgetClass(Class) && !Entries.Contains(Class->GetPathName()))
+			{
+				DirtyPaths.Add(Class->GetPathName());
+			}
+		}
+	}
+
+	// classes of unloaded modules and deleted blueprints
+	TArray<FString> StalePaths;
+	for (const TPair<FString, FEntry>& Pair : Entries)
+	{
+		if (!IsCustomWidgetClass(Pair.Value.Class.Get()))
+		{
+			StalePaths.Add(Pair.Key);
+		}
+	}
+	for (const FString& StalePath : StalePaths)
+	{
+		RemoveEntry(StalePath);
+	}
+
+	int32 RegeneratedNum = 0;
+	while (DirtyPaths.Num() > 0)
+	{
+		const FString ClassPath = *DirtyPaths.CreateConstIterator();
+		DirtyPaths.Remove(ClassPath);
+		
+		UClass* Class = FindObject<UClass>(nullptr, *ClassPath);
+		if (!IsCustomWidgetClass(Class))
+		{
+			RemoveEntry(ClassPath);
+			continue;
+		}
+
+		FReactDeclarationGenerator Generator;
+		Generator.GenBlock(Class);
+		for (UClass* Dependency : Generator.Dependencies)
+		{
+			const FString DependencyPath = Dependency->GetPathName();
+			if (IsCustomWidgetClass(Dependency) && !Entries.Contains(DependencyPath))
+			{
+				DirtyPaths.Add(DependencyPath);
+			}
+		}
+		
+		const FString Name = SafeName(Class->GetName());
+		FString Components = "exports." + Name + " = '" + Name + "';\n";
+		if (!(Class->ClassFlags & CLASS_Native) && !Name.Equals(TEXT("ReactorUIWidget")))
+		{
+			Components += "exports.lazyloadComponents." + Name + " = '" + Class->GetPathName() + "';\n";
+		}
+		
+		FEntry& Entry = Entries.FindOrAdd(ClassPath);
+		Entry.Class = Class;
+		Entry.SuperPath = Class->GetSuperClass() ? Class->GetSuperClass()->GetPathName() : FString();
+		if (!Entry.Name.Equals(Name, ESearchCase::CaseSensitive) || !Entry.Block.Equals(Generator.ToString(), ESearchCase::CaseSensitive) ||
+			!Entry.Components.Equals(Components, ESearchCase::CaseSensitive))
+		{
+			Entry.Name = Name;
+			Entry.Block = Generator.ToString();
+			Entry.Components = MoveTemp(Components);
+			bOutputDirty = true;
+		}
+		++RegeneratedNum;
+	}
+
+	const FString TSProjectDir = ReactHomeDir;
+	const FString OutDeclarationFile = TSProjectDir / TEXT("reactorUMG/index.d.ts");
+	const FString JSContentDir = FReactorUtils::GetTSCBuildOutDirFromTSConfig(FReactorUtils::GetTypeScriptHomeDir());
+	const FString OutComponentsFile = JSContentDir / TEXT("src/reactorUMG/components.js");
+	if (!bOutputDirty && OutDeclarationFile == LastDeclarationFile && OutComponentsFile == LastComponentsFile &&
+		FPaths::FileExists(OutDeclarationFile) && FPaths::FileExists(OutComponentsFile))
+	{
+		UE_LOG(LogTemp, Log, TEXT("ReactUMG, widget declarations up to date, %d classes checked in %.2f ms"), RegeneratedNum,
+			(FPlatformTime::Seconds() - StartTime) * 1000.0);
+		return;
+	}
+
+	// sorted by name so the same set of classes always produces the same files
+	TArray<const FEntry*> SortedEntries;
+	SortedEntries.Reserve(Entries.Num());
+	for (const TPair<FString, FEntry>& Pair : Entries)
+	{
+		SortedEntries.Add(&Pair.Value);
+	}
+	SortedEntries.Sort([](const FEntry& A, const FEntry& B) { return A.Name < B.Name; });
+
+	FString Declaration = TEXT("\n/* Widget declaration generated from custom widgets user defined*/ \n\n");
+	FString Components = TEXT("exports.lazyloadComponents = {};\n");
+	for (const FEntry* Entry : SortedEntries)
+	{
+		Declaration += Entry->Block;
+		Components += Entry->Components;
+	}
+
+	int32 WrittenNum = 0;
+	const FString TemplateIndexFile = FPaths::Combine(FReactorUtils::GetPluginDir(), TEXT("Scripts/Project/src/types/reactorUMG/index.d.ts"));
+	if (FPaths::FileExists(*TemplateIndexFile) && InsertTextAtSecondLastLine(TemplateIndexFile, OutDeclarationFile, Declaration))
+	{
+		++WrittenNum;
+	}
+	
+	const FString TemplateComponentJSFile = FPaths::Combine(FReactorUtils::GetPluginDir(), TEXT("Scripts/Project/src/reactorUMG/components.js"));
+	if (FPaths::FileExists(*TemplateComponentJSFile) && InsertTextAtSecondLastLine(TemplateComponentJSFile, OutComponentsFile, Components))
+	{
+		++WrittenNum;
+	}
+
+	bOutputDirty = false;
+	LastDeclarationFile = OutDeclarationFile;
+	LastComponentsFile = OutComponentsFile;
+	UE_LOG(LogTemp, Log, TEXT("ReactUMG, %d widget classes indexed, %d regenerated, %d files written in %.2f ms"), Entries.Num(),
+		RegeneratedNum, WrittenNum, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
 void UWidgetDeclarationGenerator::Gen_Implementation(const FString& OutDir) const
 {
-	/* do not change ReactorUMG/index.ts */
-	// FReactDeclarationGenerator ReactDeclarationGenerator;
-	// ReactDeclarationGenerator.GenReactDeclaration(OutDir);
+	/* do not change ReactorUMG/index.ts unless it is enabled in the settings */
+	if (GetDefault<UReactorUMGSetting>()->bGenerateCustomWidgetDeclaration)
+	{
+		FReactWidgetDeclarationIndex::Get().Generate(OutDir);
+	}
 }
@@ -5,8 +5,75 @@
 #include "CodeGenerator.h"
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
+#include "Modules/ModuleManager.h"
 #include "WidgetDeclarationGenerator.generated.h"
 
+struct FAssetData;
+class UBlueprint;
+
+/**
+ * Persistent index of the custom widget classes written into reactorUMG/index.d.ts and components.js.
+ * Asset registry, blueprint compile and module load events only mark the affected classes dirty, a generation
+ * regenerates their interface blocks and leaves the files untouched when the content did not change.
+ */
+class FReactWidgetDeclarationIndex
+{
+public:
+	static FReactWidgetDeclarationIndex& Get();
+
+	static void Shutdown();
+
+	void Generate(const FString& ReactHomeDir);
+
+	~FReactWidgetDeclarationIndex();
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<UClass> Class;
+		FString Name;
+		FString SuperPath;
+		FString Block;
+		FString Components;
+	};
+
+	void Subscribe();
+
+	void MarkDirty(const FString& ClassPath);
+
+	void MarkAssetDirty(const FAssetData& AssetData);
+
+	void RemoveEntry(const FString& ClassPath);
+
+	void OnBlueprintPreCompile(UBlueprint* Blueprint);
+
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+
+	TMap<FString, FEntry> Entries;
+
+	TSet<FString> DirtyPaths;
+
+	// widget classes of newly loaded modules are only found by walking the class tree again
+	bool bNeedsScan = true;
+
+	bool bSubscribed = false;
+
+	// set when a block changed since the last generation and the output files have to be assembled again
+	bool bOutputDirty = true;
+
+	FString LastDeclarationFile;
+
+	FString LastComponentsFile;
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle BlueprintPreCompileHandle;
+	FDelegateHandle ModulesChangedHandle;
+	FDelegateHandle ReloadCompleteHandle;
+};
+
 UCLASS()
 class REACTORUMGEDITOR_API UWidgetDeclarationGenerator : public UObject, public ICodeGenerator
 {